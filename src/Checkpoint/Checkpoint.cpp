@@ -218,6 +218,9 @@ void Checkpoint::dump( VectorPatch &vecPatches, Region &region, unsigned int iti
 
 void Checkpoint::dumpAll( VectorPatch &vecPatches, Region &region, unsigned int itime,  SmileiMPI *smpi, SimWindow *simWin,  Params &params )
 {
+    // The diagnostics are complete up to this iteration when restarting from this dump
+    vecPatches.async_writer_.wait();
+    
     unsigned int num_dump=dump_number % keep_n_dumps;
     
     ostringstream nameDumpTmp( "" );
@@ -296,9 +299,6 @@ void Checkpoint::dumpAll( VectorPatch &vecPatches, Region &region, unsigned int
         
         dumpPatch( vecPatches( ipatch ), params, g );
         
-        // Random number generator state
-        g.attr( "xorshift32_state", vecPatches( ipatch )->rand_->xorshift32_state );
-        
     }
 
     if (params.multiple_decomposition) {
@@ -619,9 +619,6 @@ void Checkpoint::restartAll( VectorPatch &vecPatches, Region &region, SmileiMPI
         
         restartPatch( vecPatches( ipatch ), params, g );
         
-        // Random number generator state
-        g.attr( "xorshift32_state", vecPatches( ipatch )->rand_->xorshift32_state );
-        
     }
 
     if (params.multiple_decomposition) {
@@ -25,6 +25,9 @@ Collisions::Collisions(
     double coulomb_log_factor,
     bool intra_collisions,
     int debug_every,
+    int every,
+    int adaptive_every,
+    double adaptive_s,
     CollisionalIonization *ionization,
     CollisionalNuclearReaction *nuclear_reaction,
     string filename
@@ -38,10 +41,17 @@ Collisions::Collisions(
     coulomb_log_factor_( coulomb_log_factor ),
     intra_collisions_( intra_collisions ),
     debug_every_( debug_every ),
+    every_( every ),
+    adaptive_every_( adaptive_every ),
+    adaptive_s_( adaptive_s ),
     filename_( filename )
 {
     coeff1_ = 4.046650232e-21*params.reference_angular_frequency_SI; // h*omega/(2*me*c^2)
     coeff2_ = 2.817940327e-15*params.reference_angular_frequency_SI/299792458.; // re omega / c
+    batched_ = dynamic_cast<CollisionalNoIonization *>( Ionization )
+               && dynamic_cast<CollisionalNoNuclearReaction *>( NuclearReaction );
+    every_mean_ = adaptive_every_ > 0 ? 1. : every_;
+    every_max_  = every_mean_;
     
     // Open the HDF5 file
     if( debug_every > 0 ) {
@@ -62,9 +72,15 @@ Collisions::Collisions( Collisions *coll )
     coulomb_log_factor_ = coll->coulomb_log_factor_;
     intra_collisions_   = coll->intra_collisions_  ;
     debug_every_        = coll->debug_every_       ;
+    every_              = coll->every_             ;
+    adaptive_every_     = coll->adaptive_every_    ;
+    adaptive_s_         = coll->adaptive_s_        ;
     filename_           = coll->filename_          ;
     coeff1_             = coll->coeff1_            ;
     coeff2_             = coll->coeff2_            ;
+    batched_            = coll->batched_           ;
+    every_mean_         = adaptive_every_ > 0 ? 1. : every_;
+    every_max_          = every_mean_;
     
     if( dynamic_cast<CollisionalNoIonization *>( coll->Ionization ) ) {
         Ionization = new CollisionalNoIonization();
@@ -90,6 +106,7 @@ Collisions::~Collisions()
 
 // Declare other static variables here
 bool   Collisions::debye_length_required;
+const unsigned int Collisions::batch_size_;
 
 
 // Calculates the debye length squared in each bin
@@ -176,6 +193,150 @@ void Collisions::calculate_debye_length( Params &params, Patch *patch )
     DEBUG( "Mean Debye length in meters = " << scientific << setprecision( 3 ) << mean_debye_length );
 }
 
+// With an adaptive interval, each bin has its own interval, decided at its previous collisions.
+// The collisions at the end of an interval account for all its timesteps (dt_corr is multiplied by the interval).
+int Collisions::bin_interval( unsigned int nbin, unsigned int ibin, int itime )
+{
+    if( adaptive_every_ <= 0 ) {
+        return itime % every_ == 0 ? every_ : 0;
+    }
+    // New patches start with collisions at each timestep
+    if( bin_every_.size() != nbin ) {
+        bin_every_.assign( nbin, 1 );
+        bin_next_ .assign( nbin, itime );
+    }
+    if( itime < bin_next_[ibin] ) {
+        return 0;
+    }
+    // Same interval for the next collisions, unless updated
+    bin_next_[ibin] = itime + bin_every_[ibin];
+    return bin_every_[ibin];
+}
+
+
+// s is proportional to the interval: the next interval is chosen so that s reaches adaptive_s_.
+// It can at most double at each collisions so that it follows the plasma evolution.
+void Collisions::update_bin_interval( unsigned int ibin, int itime, double smean )
+{
+    if( adaptive_every_ <= 0 ) {
+        return;
+    }
+    double s_per_step = smean / bin_every_[ibin];
+    double every = s_per_step > 0. ? min( adaptive_s_ / s_per_step, ( double ) adaptive_every_ ) : adaptive_every_;
+    int next = max( 1, min( ( int ) every, 2*bin_every_[ibin] ) );
+    bin_every_[ibin] = next;
+    bin_next_ [ibin] = itime + next;
+}
+
+
+void Collisions::interval_stats( unsigned int nbin )
+{
+    if( adaptive_every_ <= 0 ) {
+        every_mean_ = every_;
+        every_max_  = every_;
+        return;
+    }
+    every_mean_ = 0.;
+    every_max_  = 0.;
+    for( unsigned int ibin=0; ibin<bin_every_.size(); ibin++ ) {
+        every_mean_ += bin_every_[ibin];
+        every_max_   = max( every_max_, ( double ) bin_every_[ibin] );
+    }
+    if( nbin > 0 ) {
+        every_mean_ /= nbin;
+    }
+}
+
+
+// Vectorized version of one_collision, for a batch of pairs with no nuclear reaction.
+// Branches are replaced by selections so that the loop can be vectorized.
+void Collisions::collide_batch( PairBatch &b, unsigned int n, double n123, double n223, double debye2 )
+{
+    const double coeff1 = coeff1_;
+    const double logL0 = coulomb_log_;
+    
+    #pragma omp simd
+    for( unsigned int k=0; k<n; k++ ) {
+        double m12 = b.m1[k] / b.m2[k];
+        double minW = std::min( b.w1[k], b.w2[k] );
+        
+        // Gammas and center-of-mass (COM) frame
+        double gamma1 = sqrt( 1. + b.px1[k]*b.px1[k] + b.py1[k]*b.py1[k] + b.pz1[k]*b.pz1[k] );
+        double gamma2 = sqrt( 1. + b.px2[k]*b.px2[k] + b.py2[k]*b.py2[k] + b.pz2[k]*b.pz2[k] );
+        double gamma12_inv = 1. / ( m12 * gamma1 + gamma2 );
+        double COM_vx = ( m12 * b.px1[k] + b.px2[k] ) * gamma12_inv;
+        double COM_vy = ( m12 * b.py1[k] + b.py2[k] ) * gamma12_inv;
+        double COM_vz = ( m12 * b.pz1[k] + b.pz2[k] ) * gamma12_inv;
+        double COM_vsquare = COM_vx*COM_vx + COM_vy*COM_vy + COM_vz*COM_vz;
+        
+        // Momentum of particle 1 in the COM frame
+        bool slow = COM_vsquare < 1e-6;
+        double vcv1g1 = COM_vx*b.px1[k] + COM_vy*b.py1[k] + COM_vz*b.pz1[k];
+        double vcv2g2 = COM_vx*b.px2[k] + COM_vy*b.py2[k] + COM_vz*b.pz2[k];
+        double COM_gamma  = slow ? 1. + 0.5 * COM_vsquare : 1./sqrt( 1.-COM_vsquare );
+        double gamma1_COM = slow ? gamma1 * COM_gamma : ( gamma1-vcv1g1 )*COM_gamma;
+        double gamma2_COM = slow ? gamma2 * COM_gamma : ( gamma2-vcv2g2 )*COM_gamma;
+        double term1 = slow ? 0.5 : ( COM_gamma - 1. ) / ( slow ? 1. : COM_vsquare );
+        double term2 = slow ? -gamma1_COM : term1*vcv1g1 - COM_gamma * gamma1;
+        double px_COM = b.px1[k] + term2*COM_vx;
+        double py_COM = b.py1[k] + term2*COM_vy;
+        double pz_COM = b.pz1[k] + term2*COM_vz;
+        double p2_COM = px_COM*px_COM + py_COM*py_COM + pz_COM*pz_COM;
+        double p_COM  = sqrt( p2_COM );
+        
+        double term3 = COM_gamma * gamma12_inv;
+        double term4 = gamma1_COM * gamma2_COM;
+        double term5 = term4/p2_COM + m12;
+        double vrel = p_COM/term3/term4;
+        
+        double qqm  = b.q1[k] * b.q2[k] / b.m1[k];
+        double qqm2 = qqm * qqm;
+        
+        // Coulomb log
+        double bmin = coeff1 * std::max( 1./b.m1[k]/p_COM, std::abs( 0.00232282*qqm*term3*term5 ) );
+        double logL = logL0 > 0. ? logL0 : std::max( 2., 0.5*log( 1.+debye2/( bmin*bmin ) ) );
+        
+        // Collision parameter, with the low-temperature correction
+        double s = b.coeff3[k] * logL * qqm2 * term3 * p_COM * term5*term5 / ( gamma1*gamma2 );
+        double smax = b.coeff4[k] * ( m12+1. ) * vrel / std::max( m12*n123, n223 );
+        s = std::min( s, smax );
+        
+        // Deflection angles in the COM frame
+        double U1 = b.U1[k];
+        double s2 = s*s;
+        double alpha = 0.37*s - 0.005*s2 - 0.0064*s2*s;
+        double sin2X2 = alpha * U1 / sqrt( (1.-U1) + alpha*alpha*U1 );
+        double cosX = s < 4. ? 1. - 2.*sin2X2 : 2.*U1 - 1.;
+        double sinX = s < 4. ? 2.*sqrt( sin2X2 *(1.-sin2X2) ) : sqrt( 1. - cosX*cosX );
+        double sinXcosPhi = sinX*cos( b.phi[k] );
+        double sinXsinPhi = sinX*sin( b.phi[k] );
+        
+        double p_perp = sqrt( px_COM*px_COM + py_COM*py_COM );
+        bool aligned = p_perp <= 1.e-10*p_COM;
+        double inv_p_perp = 1. / ( aligned ? 1. : p_perp );
+        double newpx_COM = aligned ? p_COM * sinXcosPhi : ( px_COM * pz_COM * sinXcosPhi - py_COM * p_COM * sinXsinPhi ) * inv_p_perp + px_COM * cosX;
+        double newpy_COM = aligned ? p_COM * sinXsinPhi : ( py_COM * pz_COM * sinXcosPhi + px_COM * p_COM * sinXsinPhi ) * inv_p_perp + py_COM * cosX;
+        double newpz_COM = aligned ? p_COM * cosX       : -p_perp * sinXcosPhi  +  pz_COM * cosX;
+        
+        // Back to the lab frame, each particle being deflected with some probability
+        double vcp = COM_vx * newpx_COM + COM_vy * newpy_COM + COM_vz * newpz_COM;
+        double term6_1 = term1*vcp + gamma1_COM * COM_gamma;
+        double term6_2 = -m12 * term1*vcp + gamma2_COM * COM_gamma;
+        bool deflect1 = minW > 0. && b.U2[k] < b.w2[k]/b.w1[k];
+        bool deflect2 = minW > 0. && b.U2[k] < b.w1[k]/b.w2[k];
+        b.px1[k] = deflect1 ? newpx_COM + COM_vx * term6_1 : b.px1[k];
+        b.py1[k] = deflect1 ? newpy_COM + COM_vy * term6_1 : b.py1[k];
+        b.pz1[k] = deflect1 ? newpz_COM + COM_vz * term6_1 : b.pz1[k];
+        b.px2[k] = deflect2 ? -m12 * newpx_COM + COM_vx * term6_2 : b.px2[k];
+        b.py2[k] = deflect2 ? -m12 * newpy_COM + COM_vy * term6_2 : b.py2[k];
+        b.pz2[k] = deflect2 ? -m12 * newpz_COM + COM_vz * term6_2 : b.pz2[k];
+        
+        b.s   [k] = minW > 0. ? s : 0.;
+        b.logL[k] = minW > 0. ? logL : logL0;
+    }
+}
+
+
 // Calculates the collisions for a given Collisions object
 void Collisions::collide( Params &params, Patch *patch, int itime, vector<Diagnostic *> &localDiags )
 {
@@ -189,6 +350,9 @@ void Collisions::collide( Params &params, Patch *patch, int itime, vector<Diagno
     Species   *s1, *s2;
     Particles *p1=NULL, *p2;
     double coeff3, coeff4, logL, s, ncol, debye2=0.;
+    PairBatch batch;
+    Particles *pair_p1[batch_size_], *pair_p2[batch_size_];
+    unsigned int pair_i1[batch_size_], pair_i2[batch_size_];
     
     sg1 = &species_group1_;
     sg2 = &species_group2_;
@@ -196,6 +360,11 @@ void Collisions::collide( Params &params, Patch *patch, int itime, vector<Diagno
     
     bool debug = ( debug_every_ > 0 && itime % debug_every_ == 0 ); // debug only every N timesteps
     
+    // Nothing to do between two collision timesteps
+    if( adaptive_every_ <= 0 && itime % every_ != 0 ) {
+        return;
+    }
+    
     ncol = 0.;
     smean_       = 0.;
     logLmean_    = 0.;
@@ -207,6 +376,12 @@ void Collisions::collide( Params &params, Patch *patch, int itime, vector<Diagno
     unsigned int nbin = patch->vecSpecies[0]->particles->first_index.size();
     for( unsigned int ibin = 0 ; ibin < nbin ; ibin++ ) {
     
+        // Skip the bin if its collisions are not due at this timestep
+        int interval = bin_interval( nbin, ibin, itime );
+        if( interval == 0 ) {
+            continue;
+        }
+        
         // get number of particles for all necessary species
         for( unsigned int i=0; i<2; i++ ) { // try twice to ensure group 1 has more macro-particles
             nspec1 = sg1->size();
@@ -305,7 +480,7 @@ void Collisions::collide( Params &params, Patch *patch, int itime, vector<Diagno
         
         // Pre-calculate some numbers before the big loop
         unsigned int ncorr = intra_collisions_ ? 2*npairs-1 : npairs;
-        double dt_corr = params.timestep * ((double)ncorr) * inv_cell_volume;
+        double dt_corr = params.timestep * interval * ((double)ncorr) * inv_cell_volume;
         coeff3 = coeff2_ * dt_corr * coulomb_log_factor_;
         coeff4 = pow( 3.*coeff2_, -1./3. ) * dt_corr;
         double weight_correction_1 = 1. / (double)( (npairs-1) / N2max );
@@ -315,6 +490,54 @@ void Collisions::collide( Params &params, Patch *patch, int itime, vector<Diagno
         double n123 = pow( n1, 2./3. );
         double n223 = pow( n2, 2./3. );
         
+        double sbin = 0.; // sum of the collision parameters in this bin
+        
+        // Without ionization nor nuclear reaction, the pairs are collided by batches.
+        // A batch stops before a particle of group 2 is used again.
+        if( batched_ ) {
+            for( unsigned int i=0; i<npairs; ) {
+                unsigned int n = min( batch_size_, min( npairs - i, N2max - i%N2max ) );
+                for( unsigned int k=0; k<n; k++ ) {
+                    i1 = index1[i+k];
+                    for( ispec1=0 ; i1>=np1[ispec1]; ispec1++ ) {
+                        i1 -= np1[ispec1];
+                    }
+                    i2 = index2[i+k];
+                    for( ispec2=0 ; i2>=np2[ispec2]; ispec2++ ) {
+                        i2 -= np2[ispec2];
+                    }
+                    s1 = patch->vecSpecies[( *sg1 )[ispec1]];
+                    s2 = patch->vecSpecies[( *sg2 )[ispec2]];
+                    pair_p1[k] = s1->particles;
+                    pair_p2[k] = s2->particles;
+                    pair_i1[k] = i1 + s1->particles->first_index[ibin];
+                    pair_i2[k] = i2 + s2->particles->first_index[ibin];
+                    gather_pair( batch, k, pair_p1[k], pair_i1[k], s1->mass_, pair_p2[k], pair_i2[k], s2->mass_, patch->rand_ );
+                    double weight_correction = std::max( batch.w1[k], batch.w2[k] );
+                    if( ( i + k ) % N2max <= (npairs-1) % N2max ) {
+                        weight_correction *= weight_correction_2 ;
+                    } else {
+                        weight_correction *= weight_correction_1;
+                    }
+                    batch.coeff3[k] = coeff3*weight_correction;
+                    batch.coeff4[k] = coeff4*weight_correction;
+                }
+                collide_batch( batch, n, n123, n223, debye2 );
+                for( unsigned int k=0; k<n; k++ ) {
+                    scatter_pair( batch, k, pair_p1[k], pair_i1[k], pair_p2[k], pair_i2[k] );
+                    sbin += batch.s[k];
+                    if( debug ) {
+                        smean_    += batch.s[k];
+                        logLmean_ += batch.logL[k];
+                    }
+                }
+                ncol += n;
+                i += n;
+            }
+            update_bin_interval( ibin, itime, sbin / npairs );
+            continue;
+        }
+        
         // Now start the real loop on pairs of particles
         // See equations in http://dx.doi.org/10.1063/1.4742167
         // ----------------------------------------------------
@@ -353,6 +576,7 @@ void Collisions::collide( Params &params, Patch *patch, int itime, vector<Diagno
             Ionization->apply( patch, p1, i1, p2, i2, dt_corr*weight_correction );
             
             ncol ++;
+            sbin += s;
             if( debug ) {
                 smean_    += s;
                 logLmean_ += logL;
@@ -361,6 +585,8 @@ void Collisions::collide( Params &params, Patch *patch, int itime, vector<Diagno
             
         } // end loop on pairs of particles
         
+        update_bin_interval( ibin, itime, sbin / npairs );
+        
     } // end loop on bins
     
     Ionization->finish( params, patch, localDiags );
@@ -371,6 +597,9 @@ void Collisions::collide( Params &params, Patch *patch, int itime, vector<Diagno
         logLmean_ /= ncol;
         //temperature /= ncol;
     }
+    if( debug ) {
+        interval_stats( nbin );
+    }
 }
 
 
@@ -388,6 +617,8 @@ void Collisions::debug( Params &params, int itime, unsigned int icoll, VectorPat
         //vector<double>  temperature=(npatch, 0.);
         vector<double> debye_length( npatch, 0. );
         vector<double> nuclear_reaction_multiplier( npatch, 0. );
+        vector<double> every_mean( npatch, 0. );
+        vector<double> every_max( npatch, 0. );
         
         // Collect info for all patches
         for( unsigned int ipatch=0; ipatch<npatch; ipatch++ ) {
@@ -401,9 +632,12 @@ void Collisions::debug( Params &params, int itime, unsigned int icoll, VectorPat
             }
             debye_length[ipatch] = sqrt( debye_length[ipatch] / nbin );
             nuclear_reaction_multiplier[ipatch] = vecPatches( ipatch )->vecCollisions[icoll]->NuclearReaction->rate_multiplier_;
+            every_mean[ipatch] = vecPatches( ipatch )->vecCollisions[icoll]->every_mean_;
+            every_max [ipatch] = vecPatches( ipatch )->vecCollisions[icoll]->every_max_;
         }
         
         // Create H5 group for the current timestep
+        vecPatches.async_writer_.wait();
         ostringstream name( "" );
         name << "t" << setfill( '0' ) << setw( 8 ) << itime;
         H5Write g = vecPatches( 0 )->vecCollisions[icoll]->debug_file_->group( name.str() );
@@ -412,6 +646,8 @@ void Collisions::debug( Params &params, int itime, unsigned int icoll, VectorPat
         g.vect( "coulomb_log"                , logLmean                   [0], params.tot_number_of_patches, H5T_NATIVE_DOUBLE, vecPatches.refHindex_, npatch );
         g.vect( "debyelength"                , debye_length               [0], params.tot_number_of_patches, H5T_NATIVE_DOUBLE, vecPatches.refHindex_, npatch );
         g.vect( "nuclear_reaction_multiplier", nuclear_reaction_multiplier[0], params.tot_number_of_patches, H5T_NATIVE_DOUBLE, vecPatches.refHindex_, npatch );
+        g.vect( "every_mean"                 , every_mean                 [0], params.tot_number_of_patches, H5T_NATIVE_DOUBLE, vecPatches.refHindex_, npatch );
+        g.vect( "every_max"                  , every_max                  [0], params.tot_number_of_patches, H5T_NATIVE_DOUBLE, vecPatches.refHindex_, npatch );
         vecPatches( 0 )->vecCollisions[icoll]->debug_file_->flush();
         
     }
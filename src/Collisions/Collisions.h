@@ -30,6 +30,9 @@ public:
         double coulomb_log_factor,
         bool intra_collisions,
         int debug_every,
+        int every,
+        int adaptive_every,
+        double adaptive_s,
         CollisionalIonization *ionization,
         CollisionalNuclearReaction *nuclear_reaction,
         std::string
@@ -78,6 +81,30 @@ protected:
     //! Number of timesteps between each dump of collisions debugging
     int debug_every_;
     
+    //! Number of timesteps between each application of the collisions (when the interval is not adaptive)
+    int every_;
+    
+    //! Maximum number of timesteps between collisions in a bin (0 if the interval is not adaptive)
+    int adaptive_every_;
+    
+    //! Collision parameter s aimed at in each bin, when the interval is adaptive
+    double adaptive_s_;
+    
+    //! Current interval of each bin, and timestep of its next collisions
+    std::vector<int> bin_every_, bin_next_;
+    
+    //! Mean and maximum intervals over the bins (for debugging)
+    double every_mean_, every_max_;
+    
+    //! Number of timesteps covered by the collisions of bin ibin at timestep itime (0 if no collisions now)
+    int bin_interval( unsigned int nbin, unsigned int ibin, int itime );
+    
+    //! Choose the next interval of bin ibin from the mean collision parameter measured at timestep itime
+    void update_bin_interval( unsigned int ibin, int itime, double smean );
+    
+    //! Calculate every_mean_ and every_max_
+    void interval_stats( unsigned int nbin );
+    
     //! Hdf5 file name
     std::string filename_;
     
@@ -87,6 +114,68 @@ protected:
     const double twoPi = 2. * 3.14159265358979323846;
     double coeff1_, coeff2_;
     
+    //! True when there is no ionization nor nuclear reaction: pairs are then collided by batches
+    bool batched_;
+    
+    //! Maximum number of pairs in a batch
+    static const unsigned int batch_size_ = 32;
+    
+    //! Properties of a batch of pairs, gathered in contiguous arrays for the vectorized kernel
+    struct PairBatch {
+        double px1[batch_size_], py1[batch_size_], pz1[batch_size_], w1[batch_size_], q1[batch_size_], m1[batch_size_];
+        double px2[batch_size_], py2[batch_size_], pz2[batch_size_], w2[batch_size_], q2[batch_size_], m2[batch_size_];
+        //! coeff3 and coeff4 of each pair, including the weight correction
+        double coeff3[batch_size_], coeff4[batch_size_];
+        //! Random numbers
+        double U1[batch_size_], U2[batch_size_], phi[batch_size_];
+        //! Outputs: collision parameter and coulomb logarithm
+        double s[batch_size_], logL[batch_size_];
+    };
+    
+    //! Copy the pair k of the batch from the particles and pick its random numbers
+    //! in the same order as one_collision with no nuclear reaction
+    inline void gather_pair( PairBatch &b, unsigned int k, Particles *p1, unsigned int i1, double m1, Particles *p2, unsigned int i2, double m2, Random *random )
+    {
+        b.px1[k] = p1->momentum( 0, i1 );
+        b.py1[k] = p1->momentum( 1, i1 );
+        b.pz1[k] = p1->momentum( 2, i1 );
+        b.w1 [k] = p1->weight( i1 );
+        b.q1 [k] = p1->charge( i1 );
+        b.m1 [k] = m1;
+        b.px2[k] = p2->momentum( 0, i2 );
+        b.py2[k] = p2->momentum( 1, i2 );
+        b.pz2[k] = p2->momentum( 2, i2 );
+        b.w2 [k] = p2->weight( i2 );
+        b.q2 [k] = p2->charge( i2 );
+        b.m2 [k] = m2;
+        if( std::min( b.w1[k], b.w2[k] ) > 0. ) {
+            random->uniform(); // would be the nuclear reaction
+            b.U1 [k] = random->uniform();
+            b.phi[k] = random->uniform_2pi();
+            b.U2 [k] = random->uniform();
+        } else {
+            b.U1 [k] = 0.;
+            b.phi[k] = 0.;
+            b.U2 [k] = 0.;
+        }
+    }
+    
+    //! Copy back the momenta of the pair k of the batch
+    inline void scatter_pair( PairBatch &b, unsigned int k, Particles *p1, unsigned int i1, Particles *p2, unsigned int i2 )
+    {
+        p1->momentum( 0, i1 ) = b.px1[k];
+        p1->momentum( 1, i1 ) = b.py1[k];
+        p1->momentum( 2, i1 ) = b.pz1[k];
+        p2->momentum( 0, i2 ) = b.px2[k];
+        p2->momentum( 1, i2 ) = b.py2[k];
+        p2->momentum( 2, i2 ) = b.pz2[k];
+    }
+    
+    //! Collide the n first pairs of a batch (same physics as one_collision without nuclear reaction).
+    //! A particle must not appear twice in the batch.
+    void collide_batch( PairBatch &b, unsigned int n, double n123, double n223, double debye2 );
+    
+    
     // Collide one particle with another
     // See equations in http://dx.doi.org/10.1063/1.4742167
     inline double one_collision(
@@ -19,7 +19,8 @@ public:
         double clog;
         double clog_factor;
         bool intra;
-        int debug_every, Z, Z0, Z1, ionization_electrons;
+        int debug_every, every, adaptive_every, Z, Z0, Z1, ionization_electrons;
+        double adaptive_s;
         std::string filename;
         std::ostringstream mystream;
         Species *s0, *s;
@@ -78,6 +79,25 @@ public:
         debug_every = 0; // default
         PyTools::extract( "debug_every", debug_every, "Collisions", n_collisions );
         
+        // Number of timesteps between each application of the collisions
+        every = 1; // default
+        PyTools::extract( "every", every, "Collisions", n_collisions );
+        if( every < 1 ) {
+            ERROR( "In collisions #" << n_collisions << ": every must be a positive integer" );
+        }
+        
+        // Adaptive interval in each bin: maximum interval and target collision parameter
+        adaptive_every = 0; // default
+        PyTools::extract( "adaptive_every", adaptive_every, "Collisions", n_collisions );
+        adaptive_s = 0.1; // default
+        PyTools::extract( "adaptive_s", adaptive_s, "Collisions", n_collisions );
+        if( adaptive_every > 0 && every != 1 ) {
+            ERROR( "In collisions #" << n_collisions << ": `every` and `adaptive_every` cannot be used together" );
+        }
+        if( adaptive_s <= 0. ) {
+            ERROR( "In collisions #" << n_collisions << ": adaptive_s must be strictly positive" );
+        }
+        
         // Collisional ionization
         Z = 0; // default
         PyObject * ionizing = PyTools::extract_py( "ionizing", "Collisions", n_collisions );
@@ -254,6 +274,11 @@ public:
             MESSAGE( 2, "Coulomb logarithm is multiplied by a factor " << clog_factor );
         }
 
+        if( adaptive_every>0 ) {
+            MESSAGE( 2, "Adaptive interval in each bin, up to " << adaptive_every << " timesteps (target s = " << adaptive_s << ")" );
+        } else if( every>1 ) {
+            MESSAGE( 2, "Collisions every " << every << " timesteps" );
+        }
         if( debug_every>0 ) {
             MESSAGE( 2, "Debug every " << debug_every << " timesteps" );
         }
@@ -293,6 +318,8 @@ public:
                 f.attr( "species2", mystream.str() );
                 f.attr( "coulomb_log", clog );
                 f.attr( "debug_every", debug_every );
+                f.attr( "every", every );
+                f.attr( "adaptive_every", adaptive_every );
             }
         }
         
@@ -305,6 +332,7 @@ public:
                        sgroup[1],
                        clog, clog_factor, intra,
                        debug_every,
+                       every, adaptive_every, adaptive_s,
                        Ionization,
                        NuclearReaction,
                        filename
@@ -317,6 +345,7 @@ public:
         //                sgroup[1],
         //                clog, clog_factor, intra,
         //                debug_every,
+        //                every, adaptive_every, adaptive_s,
         //                Ionization,
         //                NuclearReaction,
         //                filename
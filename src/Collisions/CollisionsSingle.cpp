@@ -29,12 +29,18 @@ void CollisionsSingle::collide( Params &params, Patch *patch, int itime, vector<
     Species   *s1, *s2;
     Particles *p1=NULL, *p2;
     double coeff3, coeff4, logL, s, ncol, debye2=0.;
+    PairBatch batch;
     
     s1 = patch->vecSpecies[species_group1_[0]];
     s2 = patch->vecSpecies[species_group2_[0]];
     
     bool debug = ( debug_every_ > 0 && itime % debug_every_ == 0 ); // debug only every N timesteps
     
+    // Nothing to do between two collision timesteps
+    if( adaptive_every_ <= 0 && itime % every_ != 0 ) {
+        return;
+    }
+    
     ncol = 0;
     if( debug ) {
         smean_       = 0.;
@@ -48,6 +54,12 @@ void CollisionsSingle::collide( Params &params, Patch *patch, int itime, vector<
     unsigned int nbin = patch->vecSpecies[0]->particles->first_index.size();
     for( unsigned int ibin = 0 ; ibin < nbin ; ibin++ ) {
     
+        // Skip the bin if its collisions are not due at this timestep
+        int interval = bin_interval( nbin, ibin, itime );
+        if( interval == 0 ) {
+            continue;
+        }
+        
         // get number of particles for all necessary species
         np1 = s1->particles->last_index[ibin] - s1->particles->first_index[ibin];
         np2 = s2->particles->last_index[ibin] - s2->particles->first_index[ibin];
@@ -115,7 +127,7 @@ void CollisionsSingle::collide( Params &params, Patch *patch, int itime, vector<
         // Pre-calculate some numbers before the big loop
         double inv_cell_volume = 1./patch->getPrimalCellVolume( p1, s1->particles->first_index[ibin], params );
         unsigned int ncorr = intra_collisions_ ? 2*npairs-1 : npairs;
-        double dt_corr = params.timestep * ((double)ncorr) * inv_cell_volume;
+        double dt_corr = params.timestep * interval * ((double)ncorr) * inv_cell_volume;
         coeff3 = coeff2_ * dt_corr * coulomb_log_factor_;
         coeff4 = pow( 3.*coeff2_, -1./3. ) * dt_corr;
         double weight_correction_1 = 1. / (double)( (npairs-1) / N2max );
@@ -125,6 +137,42 @@ void CollisionsSingle::collide( Params &params, Patch *patch, int itime, vector<
         double n123 = pow( n1, 2./3. );
         double n223 = pow( n2, 2./3. );
         
+        double sbin = 0.; // sum of the collision parameters in this bin
+        
+        // Without ionization nor nuclear reaction, the pairs are collided by batches.
+        // A batch stops before a particle of species 2 is used again.
+        if( batched_ ) {
+            for( unsigned int i=0; i<npairs; ) {
+                unsigned int n = min( batch_size_, min( npairs - i, N2max - i%N2max ) );
+                for( unsigned int k=0; k<n; k++ ) {
+                    i1 = first_index1 + i + k;
+                    i2 = first_index2 + ( i + k )%N2max;
+                    gather_pair( batch, k, p1, i1, s1->mass_, p2, i2, s2->mass_, patch->rand_ );
+                    double weight_correction = std::max( batch.w1[k], batch.w2[k] );
+                    if( ( i + k ) % N2max <= (npairs-1) % N2max ) {
+                        weight_correction *= weight_correction_2 ;
+                    } else {
+                        weight_correction *= weight_correction_1;
+                    }
+                    batch.coeff3[k] = coeff3*weight_correction;
+                    batch.coeff4[k] = coeff4*weight_correction;
+                }
+                collide_batch( batch, n, n123, n223, debye2 );
+                for( unsigned int k=0; k<n; k++ ) {
+                    scatter_pair( batch, k, p1, first_index1 + i + k, p2, first_index2 + ( i + k )%N2max );
+                    sbin += batch.s[k];
+                    if( debug ) {
+                        smean_    += batch.s[k];
+                        logLmean_ += batch.logL[k];
+                    }
+                }
+                ncol += n;
+                i += n;
+            }
+            update_bin_interval( ibin, itime, sbin / npairs );
+            continue;
+        }
+        
         // Now start the real loop on pairs of particles
         // ----------------------------------------------------
         for( unsigned int i=0; i<npairs; i++ ) {
@@ -147,6 +195,7 @@ void CollisionsSingle::collide( Params &params, Patch *patch, int itime, vector<
             Ionization->apply( patch, p1, i1, p2, i2, dt_corr*weight_correction );
             
             ncol ++;
+            sbin += s;
             if( debug ) {
                 smean_    += s;
                 logLmean_ += logL;
@@ -155,6 +204,8 @@ void CollisionsSingle::collide( Params &params, Patch *patch, int itime, vector<
             
         } // end loop on pairs of particles
         
+        update_bin_interval( ibin, itime, sbin / npairs );
+        
     } // end loop on bins
     
     Ionization->finish( params, patch, localDiags );
@@ -165,4 +216,7 @@ void CollisionsSingle::collide( Params &params, Patch *patch, int itime, vector<
         logLmean_ /= ncol;
         //temperature /= ncol;
     }
+    if( debug ) {
+        interval_stats( nbin );
+    }
 }
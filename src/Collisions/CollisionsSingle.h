@@ -27,6 +27,9 @@ public:
         double coulomb_log_factor,
         bool intra_collisions,
         int debug_every,
+        int every,
+        int adaptive_every,
+        double adaptive_s,
         CollisionalIonization *ionization,
         CollisionalNuclearReaction *nuclear_reaction,
         std::string fname
@@ -39,6 +42,9 @@ public:
         coulomb_log_factor,
         intra_collisions,
         debug_every,
+        every,
+        adaptive_every,
+        adaptive_s,
         ionization,
         nuclear_reaction,
         fname
@@ -0,0 +1,48 @@
+#include "Diagnostic.h"
+
+using namespace std;
+
+// Extracts the options which set the compression and the precision of the output
+void Diagnostic::readOutputFilter( string diag_type, int idiag, string description )
+{
+    string precision = "double";
+    PyTools::extract( "precision", precision, diag_type, idiag );
+    if( precision == "single" ) {
+        output_filter_.single_precision_ = true;
+    } else if( precision != "double" ) {
+        ERROR( description << ": `precision` must be \"double\" or \"single\"" );
+    }
+    
+    int deflate = 0;
+    PyTools::extract( "deflate", deflate, diag_type, idiag );
+    if( deflate < 0 || deflate > 9 ) {
+        ERROR( description << ": `deflate` must be between 0 and 9" );
+    }
+    output_filter_.deflate_ = deflate;
+    
+    PyTools::extract( "shuffle", output_filter_.shuffle_, diag_type, idiag );
+    
+    // The plugin is given as [filter_id, parameter1, parameter2, ...]
+    vector<unsigned int> plugin;
+    PyTools::extractV( "compression_plugin", plugin, diag_type, idiag );
+    if( ! plugin.empty() ) {
+        if( H5Zfilter_avail( plugin[0] ) > 0 ) {
+            output_filter_.plugin_ = plugin[0];
+            output_filter_.plugin_params_.assign( plugin.begin()+1, plugin.end() );
+        } else {
+            WARNING( description << ": HDF5 filter " << plugin[0] << " is not available (plugin not found), it is ignored" );
+        }
+    }
+    
+#if ! H5_VERSION_GE( 1, 10, 2 )
+    // Parallel writes of compressed datasets appeared in HDF5 1.10.2
+    int nproc;
+    MPI_Comm_size( MPI_COMM_WORLD, &nproc );
+    if( output_filter_.compresses() && nproc > 1 ) {
+        WARNING( description << ": compression requires HDF5 1.10.2 or newer with several MPI processes, it is disabled" );
+        output_filter_.deflate_ = 0;
+        output_filter_.shuffle_ = false;
+        output_filter_.plugin_ = -1;
+    }
+#endif
+}
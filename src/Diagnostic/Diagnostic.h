@@ -52,6 +52,13 @@ public :
         return false;
     };
     
+    //! Tells whether running this diag calls HDF5 from the main thread,
+    //! in which case the asynchronous writes must be finished beforehand
+    virtual bool callsHDF5()
+    {
+        return true;
+    };
+    
     //! Time selection for writing the diagnostic
     TimeSelection *timeSelection;
     
@@ -78,9 +85,15 @@ public :
     
 protected :
 
+    //! Extracts the options which set the compression and the precision of the output
+    void readOutputFilter( std::string diag_type, int idiag, std::string description );
+    
     //! File for one diagnostic
     H5Write * file_;
     
+    //! Compression and precision of the output datasets
+    H5Filter output_filter_;
+    
     //! Pointer to all parameters needed for openPMD compatibility
     OpenPMDparams *openPMD_;
     
@@ -28,6 +28,29 @@ DiagnosticFields::DiagnosticFields( Params &params, SmileiMPI *smpi, VectorPatch
     }
     time_average_inv = 1./( ( double )time_average );
     
+    // Extract the asynchronous parameter
+    asynchronous_ = false;
+    PyTools::extract( "asynchronous", asynchronous_, "DiagFields", ndiag );
+    if( asynchronous_ && ! AsyncWriter::available() ) {
+        WARNING( "Diagnostic Fields #"<<ndiag<<": asynchronous output requires OpenMP and MPI_THREAD_MULTIPLE, it is disabled" );
+        asynchronous_ = false;
+    }
+    last_write_ = 0;
+    buffer_size_ = 0;
+    
+    // Extract the compression and precision parameters
+    ostringstream description( "" );
+    description << "Diagnostic Fields #" << ndiag;
+    readOutputFilter( "DiagFields", ndiag, description.str() );
+    
+    // Extract the number of aggregators
+    int aggregators_per_node = 0;
+    PyTools::extract( "aggregators_per_node", aggregators_per_node, "DiagFields", ndiag );
+    aggregator_ = NULL;
+    if( aggregators_per_node > 0 && ! smpi->test_mode ) {
+        aggregator_ = new H5Aggregator( MPI_COMM_WORLD, aggregators_per_node );
+    }
+    
     // Define the filename
     ostringstream fn( "" );
     fn << "Fields"<< ndiag <<".h5";
@@ -146,7 +169,7 @@ DiagnosticFields::DiagnosticFields( Params &params, SmileiMPI *smpi, VectorPatch
     // Some output
     ostringstream p( "" );
     p << "(time average = " << time_average << ")";
-    MESSAGE( 1, "Diagnostic Fields #"<<ndiag<<" "<<( time_average>1?p.str():"" )<<" :" );
+    MESSAGE( 1, "Diagnostic Fields #"<<ndiag<<" "<<( time_average>1?p.str():"" )<<( asynchronous_?" (asynchronous)":"" )<<" :" );
     MESSAGE( 2, ss.str() );
     
     // Create new fields in each patch, for time-average storage
@@ -216,6 +239,9 @@ DiagnosticFields::~DiagnosticFields()
     if( memspace ) {
         delete memspace;
     }
+    if( aggregator_ ) {
+        delete aggregator_;
+    }
     delete timeSelection;
     delete flush_timeSelection;
 }
@@ -299,22 +325,18 @@ void DiagnosticFields::run( SmileiMPI *smpi, VectorPatch &vecPatches, int itime,
     
     #pragma omp master
     {
+        // An asynchronous output first waits for the previous one to be written
+        if( asynchronous_ ) {
+            vecPatches.async_writer_.wait( last_write_ );
+            staged_data_.resize( fields_indexes.size() );
+        }
+        
         // Calculate the structure of the file depending on 1D, 2D, ...
         refHindex = ( unsigned int )( vecPatches.refHindex_ );
         setFileSplitting( smpi, vecPatches );
         
-        // Create group for this iteration
-        ostringstream name_t;
-        name_t.str( "" );
-        name_t << setfill( '0' ) << setw( 10 ) << itime;
-        status = data_group_->has( name_t.str() );
-        if( ! status ) {
-            iteration_group_ = new H5Write( data_group_, name_t.str() );
-            // Add openPMD attributes ( "basePath" )
-            openPMD_->writeBasePathAttributes( *iteration_group_, itime );
-            // Add openPMD attributes ( "meshesPath" )
-            openPMD_->writeMeshesAttributes( *iteration_group_ );
-        }
+        // Create group for this iteration (later if asynchronous)
+        status = asynchronous_ ? false : openIteration( itime );
     }
     #pragma omp barrier
     
@@ -337,13 +359,11 @@ void DiagnosticFields::run( SmileiMPI *smpi, VectorPatch &vecPatches, int itime,
         
         #pragma omp master
         {
-            // Write
-            H5Write dset = writeField( iteration_group_, fields_names[ifield], itime );
-            // Attributes for openPMD
-            openPMD_->writeFieldAttributes( dset, subgrid_start_, subgrid_step_ );
-            openPMD_->writeRecordAttributes( dset, field_type[ifield] );
-            openPMD_->writeFieldRecordAttributes( dset );
-            openPMD_->writeComponentAttributes( dset, field_type[ifield] );
+            if( asynchronous_ ) {
+                swapStagedField( ifield );
+            } else {
+                writeFieldWithAttributes( ifield, itime );
+            }
         }
         #pragma omp barrier 
 
@@ -351,21 +371,75 @@ void DiagnosticFields::run( SmileiMPI *smpi, VectorPatch &vecPatches, int itime,
     
     #pragma omp master
     {
-        // write x_moved
         double x_moved = simWindow ? simWindow->getXmoved() : 0.;
-        iteration_group_->attr( "x_moved", x_moved );
-        delete iteration_group_;
-        if( tmp_dset_ ) {
-            delete tmp_dset_;
-        }
-        tmp_dset_ = NULL;
-        if( flush_timeSelection->theTimeIsNow( itime ) ) {
-            file_->flush();
+        if( asynchronous_ ) {
+            // All HDF5 operations are done by the writer, from the staged data
+            last_write_ = vecPatches.async_writer_.push( [this, itime, x_moved]() {
+                if( openIteration( itime ) ) {
+                    return;
+                }
+                for( unsigned int ifield=0; ifield < fields_indexes.size(); ifield++ ) {
+                    swapStagedField( ifield );
+                    writeFieldWithAttributes( ifield, itime );
+                }
+                closeIteration( itime, x_moved );
+            } );
+        } else {
+            closeIteration( itime, x_moved );
         }
     }
     #pragma omp barrier
 }
 
+void DiagnosticFields::swapStagedField( unsigned int ifield )
+{
+    staged_data_[ifield].swap( data );
+    data.resize( buffer_size_ );
+}
+
+bool DiagnosticFields::openIteration( int itime )
+{
+    createFileSpaces();
+    
+    ostringstream name_t;
+    name_t.str( "" );
+    name_t << setfill( '0' ) << setw( 10 ) << itime;
+    bool exists = data_group_->has( name_t.str() );
+    if( ! exists ) {
+        iteration_group_ = new H5Write( data_group_, name_t.str() );
+        // Add openPMD attributes ( "basePath" )
+        openPMD_->writeBasePathAttributes( *iteration_group_, itime );
+        // Add openPMD attributes ( "meshesPath" )
+        openPMD_->writeMeshesAttributes( *iteration_group_ );
+    }
+    return exists;
+}
+
+void DiagnosticFields::writeFieldWithAttributes( unsigned int ifield, int itime )
+{
+    // Write
+    H5Write dset = writeField( iteration_group_, fields_names[ifield], itime );
+    // Attributes for openPMD
+    openPMD_->writeFieldAttributes( dset, subgrid_start_, subgrid_step_ );
+    openPMD_->writeRecordAttributes( dset, field_type[ifield] );
+    openPMD_->writeFieldRecordAttributes( dset );
+    openPMD_->writeComponentAttributes( dset, field_type[ifield] );
+}
+
+void DiagnosticFields::closeIteration( int itime, double x_moved )
+{
+    // write x_moved
+    iteration_group_->attr( "x_moved", x_moved );
+    delete iteration_group_;
+    if( tmp_dset_ ) {
+        delete tmp_dset_;
+    }
+    tmp_dset_ = NULL;
+    if( flush_timeSelection->theTimeIsNow( itime ) ) {
+        file_->flush();
+    }
+}
+
 bool DiagnosticFields::needsRhoJs( int itime )
 {
     
@@ -391,11 +465,71 @@ uint64_t DiagnosticFields::getDiskFootPrint( int istart, int istop, Patch *patch
     footprint += ndumps * nfields * 1200;
     
     // Add size of each field
-    footprint += ndumps * nfields * ( uint64_t )( total_dataset_size * 8 );
+    // Add size of each field (before compression)
+    uint64_t bytes = output_filter_.single_precision_ ? 4 : 8;
+    footprint += ndumps * nfields * ( uint64_t )( total_dataset_size * bytes );
     
     return footprint;
 }
 
+// Writes the buffer in the temporary dataset, then reads it back with the re-reading partition
+void DiagnosticFields::writeReadTemporary( double *data, double *data_reread )
+{
+    if( aggregator_ ) {
+        aggregator_->write( *tmp_dset_, data, filespace_firstwrite );
+        aggregator_->read( *tmp_dset_, data_reread, filespace_reread );
+    } else {
+        tmp_dset_->write( *data, H5T_NATIVE_DOUBLE, filespace_firstwrite, memspace_firstwrite );
+        tmp_dset_->read( *data_reread, H5T_NATIVE_DOUBLE, filespace_reread, memspace_reread );
+    }
+}
+
+// Creates a dataset and writes a buffer in it
+H5Write DiagnosticFields::writeArray( H5Write *loc, string name, double *data, H5Space *filespace, H5Space *memspace )
+{
+    H5Write d = loc->dataset( name, H5T_NATIVE_DOUBLE, filespace, &output_filter_ );
+    if( aggregator_ ) {
+        aggregator_->write( d, data, filespace );
+    } else {
+        d.write( *data, H5T_NATIVE_DOUBLE, filespace, memspace );
+    }
+    return d;
+}
+
+// Chunks of a compressed dataset, aligned with the portions written by the MPI ranks:
+// the smallest non-empty portion among all ranks fits in one chunk
+vector<hsize_t> DiagnosticFields::alignedChunks( vector<hsize_t> block, vector<hsize_t> array_size )
+{
+    unsigned int ndim = block.size();
+    bool empty = false;
+    for( unsigned int i=0; i<ndim; i++ ) {
+        empty = empty || block[i] == 0;
+    }
+    vector<unsigned long long> local( ndim ), smallest( ndim );
+    for( unsigned int i=0; i<ndim; i++ ) {
+        local[i] = empty ? array_size[i] : block[i];
+    }
+    MPI_Allreduce( &local[0], &smallest[0], ndim, MPI_UNSIGNED_LONG_LONG, MPI_MIN, MPI_COMM_WORLD );
+    
+    vector<hsize_t> chunk( ndim );
+    for( unsigned int i=0; i<ndim; i++ ) {
+        chunk[i] = max( ( hsize_t )1, min( ( hsize_t )smallest[i], array_size[i] ) );
+    }
+    // Chunks are limited to 4GB
+    const hsize_t max_size = 4294967295/2/sizeof( double );
+    while( true ) {
+        hsize_t chunk_points = 1;
+        for( unsigned int i=0; i<ndim; i++ ) {
+            chunk_points *= chunk[i];
+        }
+        if( chunk_points <= max_size || chunk[0] == 1 ) {
+            break;
+        }
+        chunk[0] = ( chunk[0] + 1 ) / 2;
+    }
+    return chunk;
+}
+
 // Calculates the intersection between a subgrid (aka slice in python) and a contiguous zone
 // of the PIC grid. The zone can be a patch or a MPI patch collection.
 void DiagnosticFields::findSubgridIntersection(
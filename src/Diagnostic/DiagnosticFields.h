@@ -2,6 +2,7 @@
 #define DIAGNOSTICFIELDS_H
 
 #include "Diagnostic.h"
+#include "H5Aggregator.h"
 
 class DiagnosticFields  : public Diagnostic
 {
@@ -19,14 +20,23 @@ public :
     
     virtual bool prepare( int itime ) override;
     
+    //! Calculate the size of the buffer and the portion of the file of this proc
     virtual void setFileSplitting( SmileiMPI *smpi, VectorPatch &vecPatches ) = 0;
     
+    //! Create the HDF5 spaces corresponding to the current file splitting
+    virtual void createFileSpaces() = 0;
+    
     virtual void run( SmileiMPI *smpi, VectorPatch &vecPatches, int itime, SimWindow *simWindow, Timers &timers ) override;
     
     virtual H5Write writeField( H5Write*, std::string, int ) = 0;
     
     virtual bool needsRhoJs( int itime ) override;
     
+    bool callsHDF5() override
+    {
+        return ! asynchronous_;
+    }
+    
     void findSubgridIntersection( unsigned int subgrid_start,
                                   unsigned int subgrid_stop,
                                   unsigned int subgrid_step,
@@ -70,6 +80,15 @@ protected :
     std::vector<unsigned int> patch_size;
     //! Buffer for the output of a field
     std::vector<double> data;
+    //! Size of the buffer for the current file splitting
+    unsigned int buffer_size_;
+    
+    //! Tells whether the writes are done by the asynchronous writer
+    bool asynchronous_;
+    //! Data of all fields, staged for the asynchronous writer
+    std::vector<std::vector<double> > staged_data_;
+    //! Ticket of the last asynchronous write
+    uint64_t last_write_;
     
     //! 1st patch index of vecPatches
     unsigned int refHindex;
@@ -83,6 +102,28 @@ protected :
     //! Copy patch field to current "data" buffer
     virtual void getField( Patch *patch, unsigned int ) = 0;
     
+    //! Exchange the current "data" buffer with the staged buffer of a field
+    virtual void swapStagedField( unsigned int ifield );
+    
+    //! Create the group of an iteration, unless it was already written
+    //! \return true if the iteration was already written
+    bool openIteration( int itime );
+    //! Write a field and its attributes in the current iteration group
+    void writeFieldWithAttributes( unsigned int ifield, int itime );
+    //! Write the iteration attributes and close its group
+    void closeIteration( int itime, double x_moved );
+    
+    //! Writes the buffer in the temporary dataset, then reads it back with the re-reading partition
+    void writeReadTemporary( double *data, double *data_reread );
+    //! Creates a dataset and writes a buffer in it
+    H5Write writeArray( H5Write *loc, std::string name, double *data, H5Space *filespace, H5Space *memspace );
+    
+    //! Gathers the data of several ranks before writing, if requested (NULL otherwise)
+    H5Aggregator *aggregator_;
+    
+    //! Chunks of a compressed dataset, aligned with the portions written by the MPI ranks
+    std::vector<hsize_t> alignedChunks( std::vector<hsize_t> block, std::vector<hsize_t> array_size );
+    
     //! Temporary dataset that is used for folding the 2D hilbert curve
     H5Write * tmp_dset_;
     
@@ -31,6 +31,12 @@ DiagnosticFields1D::DiagnosticFields1D( Params &params, SmileiMPI *smpi, VectorP
     file_size = nsteps;
     one_patch_buffer_size = nsteps;
     total_dataset_size = nsteps;
+    
+    // Chunks aligned with the average portion of each MPI rank, for compression
+    if( output_filter_.compresses() && file_size > 0 ) {
+        hsize_t nproc = smpi->getSize();
+        chunk_size.resize( 1, 1 + ( file_size - 1 ) / nproc );
+    }
 }
 
 DiagnosticFields1D::~DiagnosticFields1D()
@@ -59,9 +65,20 @@ void DiagnosticFields1D::setFileSplitting( SmileiMPI *smpi, VectorPatch &vecPatc
         istart_in_MPI, MPI_start_in_file, nsteps
     );
     
-    data.resize( nsteps );
-    filespace = new H5Space( file_size, MPI_start_in_file, nsteps );
-    memspace = new H5Space( file_size, 0, nsteps );
+    buffer_size_ = nsteps;
+    data.resize( buffer_size_ );
+}
+
+void DiagnosticFields1D::createFileSpaces()
+{
+    if( filespace ) {
+        delete filespace;
+    }
+    if( memspace ) {
+        delete memspace;
+    }
+    filespace = new H5Space( file_size, MPI_start_in_file, buffer_size_, chunk_size.empty() ? 0 : chunk_size[0] );
+    memspace = new H5Space( file_size, 0, buffer_size_ );
 }
 
 
@@ -111,6 +128,6 @@ void DiagnosticFields1D::getField( Patch *patch, unsigned int ifield )
 // Write current buffer to file
 H5Write DiagnosticFields1D::writeField( H5Write * loc, std::string name, int itime )
 {
-    return loc->array( name, data[0], filespace, memspace );
+    return writeArray( loc, name, &data[0], filespace, memspace );
 }
 
@@ -151,6 +151,9 @@ DiagnosticFields2D::DiagnosticFields2D( Params &params, SmileiMPI *smpi, VectorP
     } else {
         chunk_size.resize( 0 );
     }
+    if( output_filter_.compresses() ) {
+        chunk_size = alignedChunks( block2, final_array_size );
+    }
     filespace = new H5Space( final_array_size, offset2, block2, chunk_size );
     // Define space in memory for re-writing
     memspace = new H5Space( block2 );
@@ -167,13 +170,25 @@ DiagnosticFields2D::~DiagnosticFields2D()
 void DiagnosticFields2D::setFileSplitting( SmileiMPI *smpi, VectorPatch &vecPatches )
 {
     // Calculate the total size of the array in this proc
-    unsigned int buffer_size = one_patch_buffer_size * vecPatches.size();
+    buffer_size_ = one_patch_buffer_size * vecPatches.size();
     
     // Resize the data
-    data.resize( buffer_size );
-    
-    filespace_firstwrite = new H5Space( file_size, one_patch_buffer_size * refHindex, buffer_size, chunk_size_firstwrite );
-    memspace_firstwrite  = new H5Space( buffer_size );
+    data.resize( buffer_size_ );
+}
+
+void DiagnosticFields2D::createFileSpaces()
+{
+    if( filespace_firstwrite ) {
+        delete filespace_firstwrite;
+    }
+    if( memspace_firstwrite ) {
+        delete memspace_firstwrite;
+    }
+    if( tmp_dset_ ) {
+        delete tmp_dset_;
+    }
+    filespace_firstwrite = new H5Space( file_size, one_patch_buffer_size * refHindex, buffer_size_, chunk_size_firstwrite );
+    memspace_firstwrite  = new H5Space( buffer_size_ );
     
     // Create/Open temporary dataset
     tmp_dset_ = new H5Write( file_, "tmp", H5T_NATIVE_DOUBLE, filespace_firstwrite );
@@ -231,11 +246,8 @@ void DiagnosticFields2D::getField( Patch *patch, unsigned int ifield )
 H5Write DiagnosticFields2D::writeField( H5Write * loc, std::string name, int itime )
 {
 
-    // Write the buffer in a temporary location
-    tmp_dset_->write( data[0], H5T_NATIVE_DOUBLE, filespace_firstwrite, memspace_firstwrite );
-    
-    // Read the file with the previously defined partition
-    tmp_dset_->read( data_reread[0], H5T_NATIVE_DOUBLE, filespace_reread, memspace_reread );
+    // Write the buffer in a temporary location, and read the file with the previously defined partition
+    writeReadTemporary( &data[0], &data_reread[0] );
     
     // Fold the data according to the Hilbert curve
     unsigned int read_position, write_position, write_skip;
@@ -272,6 +284,6 @@ H5Write DiagnosticFields2D::writeField( H5Write * loc, std::string name, int iti
     }
     
     // Rewrite the file with the previously defined partition
-    return loc->array( name, data_rewrite[0], filespace, memspace );
+    return writeArray( loc, name, &data_rewrite[0], filespace, memspace );
 }
 
@@ -16,6 +16,8 @@ public:
     
     void setFileSplitting( SmileiMPI *smpi, VectorPatch &vecPatches ) override;
     
+    void createFileSpaces() override;
+    
     //! Copy patch field to current "data" buffer
     void getField( Patch *patch, unsigned int ) override;
     
@@ -179,6 +179,9 @@ DiagnosticFieldsAM::DiagnosticFieldsAM( Params &params, SmileiMPI *smpi, VectorP
     } else {
         chunk_size.resize( 0 );
     }
+    if( output_filter_.compresses() ) {
+        chunk_size = alignedChunks( block2, final_array_size );
+    }
     filespace = new H5Space( final_array_size, offset2, block2, chunk_size );
     // Define space in memory for re-writing
     memspace = new H5Space( block2 );
@@ -199,22 +202,45 @@ DiagnosticFieldsAM::~DiagnosticFieldsAM()
 void DiagnosticFieldsAM::setFileSplitting( SmileiMPI *smpi, VectorPatch &vecPatches )
 {
     // Calculate the total size of the array in this proc
-    unsigned int buffer_size = one_patch_buffer_size * vecPatches.size();
+    buffer_size_ = one_patch_buffer_size * vecPatches.size();
     
     // Resize the data
     if( factor_ == 2 ) {
-        idata.resize( buffer_size );
+        idata.resize( buffer_size_ );
     } else {
-        data.resize( buffer_size );
+        data.resize( buffer_size_ );
     }
-    
-    filespace_firstwrite = new H5Space( ifile_size, factor_ * one_patch_buffer_size * refHindex, factor_ * buffer_size, chunk_size_firstwrite );
-    memspace_firstwrite  = new H5Space( factor_ * buffer_size );
+}
+
+void DiagnosticFieldsAM::createFileSpaces()
+{
+    if( filespace_firstwrite ) {
+        delete filespace_firstwrite;
+    }
+    if( memspace_firstwrite ) {
+        delete memspace_firstwrite;
+    }
+    if( tmp_dset_ ) {
+        delete tmp_dset_;
+    }
+    filespace_firstwrite = new H5Space( ifile_size, factor_ * one_patch_buffer_size * refHindex, factor_ * buffer_size_, chunk_size_firstwrite );
+    memspace_firstwrite  = new H5Space( factor_ * buffer_size_ );
     
     // Create/Open temporary dataset
     tmp_dset_ = new H5Write( file_, "tmp", H5T_NATIVE_DOUBLE, filespace_firstwrite );
 }
 
+void DiagnosticFieldsAM::swapStagedField( unsigned int ifield )
+{
+    if( factor_ == 2 ) {
+        staged_idata_.resize( fields_indexes.size() );
+        staged_idata_[ifield].swap( idata );
+        idata.resize( buffer_size_ );
+    } else {
+        DiagnosticFields::swapStagedField( ifield );
+    }
+}
+
 
 // Copy patch field to current "data" buffer
 void DiagnosticFieldsAM::getField( Patch *patch, unsigned int ifield )
@@ -289,11 +315,8 @@ template<typename F>
 H5Write DiagnosticFieldsAM::writeField( H5Write *loc, string name, int itime, F& linearized_data, F& read_data, F& final_data )
 {
 
-    // Write the buffer in a temporary location
-    tmp_dset_->write( linearized_data[0], H5T_NATIVE_DOUBLE, filespace_firstwrite, memspace_firstwrite );
-    
-    // Read the file with the previously defined partition
-    tmp_dset_->read( read_data[0], H5T_NATIVE_DOUBLE, filespace_reread, memspace_reread );
+    // Write the buffer in a temporary location, and read the file with the previously defined partition
+    writeReadTemporary( ( double * )&linearized_data[0], ( double * )&read_data[0] );
     
     // Fold the data according to the Hilbert curve
     unsigned int read_position, write_position, write_skip;
@@ -330,6 +353,6 @@ H5Write DiagnosticFieldsAM::writeField( H5Write *loc, string name, int itime, F&
     }
     
     // Rewrite the file with the previously defined partition
-    return loc->array( name, final_data[0], H5T_NATIVE_DOUBLE, filespace, memspace );
+    return writeArray( loc, name, ( double * )&final_data[0], filespace, memspace );
 }
 
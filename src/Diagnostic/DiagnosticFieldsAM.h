@@ -16,8 +16,12 @@ public:
     
     void setFileSplitting( SmileiMPI *smpi, VectorPatch &vecPatches ) override;
     
+    void createFileSpaces() override;
+    
     //! Copy patch field to current "data" buffer
     void getField( Patch *patch, unsigned int ) override;
+    
+    void swapStagedField( unsigned int ifield ) override;
     template<typename T, typename F>  void getField( Patch *patch, unsigned int, F& out_data );
     
     H5Write writeField( H5Write*, std::string, int ) override;
@@ -30,6 +34,7 @@ private:
     unsigned int rewrite_size[2], rewrite_start_in_file[2];
     
     std::vector<std::complex<double>> idata_reread, idata_rewrite, idata;
+    std::vector<std::vector<std::complex<double>>> staged_idata_;
     
     int factor_;
 
@@ -217,7 +217,7 @@ void DiagnosticParticleBinningBase::run( Patch *patch, int itime, SimWindow *sim
 {
 
     vector<int> int_buffer;
-    vector<double> double_buffer;
+    vector<double> double_buffer, factor;
     unsigned int npart;
     
 //    // Update spatial_min and spatial_max if needed
@@ -236,6 +236,10 @@ void DiagnosticParticleBinningBase::run( Patch *patch, int itime, SimWindow *sim
 //        }
 //    }
     
+    if( ! patchIsUseful( patch ) ) {
+        return;
+    }
+    
     // loop species
     for( unsigned int ispec=0 ; ispec < species.size() ; ispec++ ) {
     
@@ -244,16 +248,36 @@ void DiagnosticParticleBinningBase::run( Patch *patch, int itime, SimWindow *sim
         int_buffer   .resize( npart );
         double_buffer.resize( npart );
         
-        fill( int_buffer.begin(), int_buffer.end(), 0 );
+        if( selectParticles( s, int_buffer, factor ) == 0 ) {
+            continue;
+        }
         
         histogram->digitize( s, double_buffer, int_buffer, simWindow );
-        histogram->valuate( s, double_buffer, int_buffer );
-        histogram->distribute( double_buffer, int_buffer, data_sum );
+        if( ! histogram->deposited_quantity.empty() ) {
+            histogram->valuate( s, double_buffer, int_buffer );
+        }
+        deposit( s, int_buffer, double_buffer, factor, &data_sum[0], true );
         
     }
     
 } // END run
 
+
+// By default, all particles are binned
+unsigned int DiagnosticParticleBinningBase::selectParticles( Species *s, vector<int> &index, vector<double> &factor )
+{
+    fill( index.begin(), index.end(), 0 );
+    return index.size();
+}
+
+
+// By default, the deposited quantity is summed in the bin of each particle
+void DiagnosticParticleBinningBase::deposit( Species *s, vector<int> &index, vector<double> &values, vector<double> &factor, double *output, bool atomic )
+{
+    histogram->distribute( values, index, output, atomic );
+}
+
+
 bool DiagnosticParticleBinningBase::writeNow( int itime ) {
     return itime - timeSelection->previousTime() == time_average-1;
 }
@@ -8,6 +8,7 @@
 class DiagnosticParticleBinningBase : public Diagnostic
 {
     friend class SmileiMPI;
+    friend class ParticleBinningScheduler;
     
 public :
 
@@ -31,7 +32,21 @@ public :
     
     bool prepare( int itime ) override;
     
-    virtual void run( Patch *patch, int itime, SimWindow *simWindow ) override;
+    void run( Patch *patch, int itime, SimWindow *simWindow ) override;
+    
+    //! Whether the particles of this patch may contribute to the diagnostic
+    virtual bool patchIsUseful( Patch * )
+    {
+        return true;
+    }
+    
+    //! Set the index of the particles to 0 (binned) or -1 (discarded), and the factor applied to their deposited quantity
+    //! \return the number of binned particles
+    virtual unsigned int selectParticles( Species *s, std::vector<int> &index, std::vector<double> &factor );
+    
+    //! Add the contribution of the particles to the output array, given their index in the histogram
+    //! and their deposited quantity (atomically if the output array is shared between threads)
+    virtual void deposit( Species *s, std::vector<int> &index, std::vector<double> &values, std::vector<double> &factor, double *output, bool atomic );
     
     virtual bool writeNow( int itime );
     
@@ -343,6 +343,14 @@ DiagnosticProbes::DiagnosticProbes( Params &params, SmileiMPI *smpi, VectorPatch
         ERROR( "Probe #"<<n_probe<<": `time_integral` incompatible with the moving window" );
     }
     
+    // Extract the number of aggregators
+    int aggregators_per_node = 0;
+    PyTools::extract( "aggregators_per_node", aggregators_per_node, "DiagProbe", n_probe );
+    aggregator_ = NULL;
+    if( aggregators_per_node > 0 && ! smpi->test_mode ) {
+        aggregator_ = new H5Aggregator( MPI_COMM_WORLD, aggregators_per_node );
+    }
+    
     // Pre-calculate patch size
     patch_size.resize( nDim_particle );
     for( unsigned int k=0; k<nDim_particle; k++ ) {
@@ -397,6 +405,9 @@ DiagnosticProbes::~DiagnosticProbes()
 {
     delete timeSelection;
     delete flush_timeSelection;
+    if( aggregator_ ) {
+        delete aggregator_;
+    }
 }
 
 
@@ -543,6 +554,7 @@ void DiagnosticProbes::createPoints( SmileiMPI *smpi, VectorPatch &vecPatches, d
         // Initialize the list of "fake" particles (points) just as actual macro-particles
         Particles *particles = &( vecPatches( ipatch )->probes[probe_n]->particles );
         particles->initialize( ntot, nDim_particle, false );
+        vecPatches( ipatch )->probes[probe_n]->stencil.clear();
         // In AM, redefine patchmin as rmin and not -rmax anymore
         if( geometry == "AMcylindrical" ) {
             patchMin[1] = patchMax[1] - ( double )patch_size[1];
@@ -677,7 +689,12 @@ void DiagnosticProbes::run( SmileiMPI *smpi, VectorPatch &vecPatches, int itime,
                 H5Space memspace( {nPart_MPI, nDim_particle}, {}, {} );
                 H5Space filespace( {nPart_total_actual, nDim_particle}, {offset_in_file[0], 0}, {nPart_MPI, nDim_particle} );
                 // Create dataset
-                file_->array( "positions", *(posArray->data_), &filespace, &memspace );
+                if( aggregator_ ) {
+                    H5Write d = file_->dataset( "positions", H5T_NATIVE_DOUBLE, &filespace );
+                    aggregator_->write( d, posArray->data_, &filespace );
+                } else {
+                    file_->array( "positions", *(posArray->data_), &filespace, &memspace );
+                }
                 file_->flush();
                 
                 delete posArray;
@@ -710,28 +727,45 @@ void DiagnosticProbes::run( SmileiMPI *smpi, VectorPatch &vecPatches, int itime,
         // Interpolate all usual fields on probe ("fake") particles of current patch
         unsigned int iPart_MPI = offset_in_MPI[ipatch];
         unsigned int maxPart_MPI = offset_in_MPI[ipatch] + npart;
-        smpi->dynamics_resize( ithread, nDim_particle, npart, false );
-        for( unsigned int ipart=0; ipart<npart; ipart++ ) {
-            int iparticle( ipart ); // Compatibility
-            int false_idx( 0 );   // Use in classical interp for now, not for probes
-            patch->probesInterp->fieldsAndCurrents(
-                patch->EMfields,
-                patch->probes[probe_n]->particles, smpi,
-                &iparticle, &false_idx, ithread,
-                &Jloc_fields, &Rloc_fields
-            );
-            //! here we fill the probe data!!!
-            ( *probesArray )( fieldlocation[0], iPart_MPI )=smpi->dynamics_Epart[ithread][ipart+0*npart];
-            ( *probesArray )( fieldlocation[1], iPart_MPI )=smpi->dynamics_Epart[ithread][ipart+1*npart];
-            ( *probesArray )( fieldlocation[2], iPart_MPI )=smpi->dynamics_Epart[ithread][ipart+2*npart];
-            ( *probesArray )( fieldlocation[3], iPart_MPI )=smpi->dynamics_Bpart[ithread][ipart+0*npart];
-            ( *probesArray )( fieldlocation[4], iPart_MPI )=smpi->dynamics_Bpart[ithread][ipart+1*npart];
-            ( *probesArray )( fieldlocation[5], iPart_MPI )=smpi->dynamics_Bpart[ithread][ipart+2*npart];
-            ( *probesArray )( fieldlocation[6], iPart_MPI )=Jloc_fields.x;
-            ( *probesArray )( fieldlocation[7], iPart_MPI )=Jloc_fields.y;
-            ( *probesArray )( fieldlocation[8], iPart_MPI )=Jloc_fields.z;
-            ( *probesArray )( fieldlocation[9], iPart_MPI )=Rloc_fields;
-            iPart_MPI++;
+        
+        // The interpolation stencil of the points is kept until they are created again
+        InterpolatorStencil &stencil = patch->probes[probe_n]->stencil;
+        if( stencil.empty() && npart > 0 ) {
+            patch->probesInterp->stencil( patch->probes[probe_n]->particles, stencil );
+        }
+        
+        if( ! stencil.empty() ) {
+            ElectroMagn *EMfields = patch->EMfields;
+            Field *fields[10] = { EMfields->Ex_, EMfields->Ey_, EMfields->Ez_, EMfields->Bx_m, EMfields->By_m, EMfields->Bz_m, EMfields->Jx_, EMfields->Jy_, EMfields->Jz_, EMfields->rho_ };
+            for( unsigned int k=0; k<10; k++ ) {
+                if( fieldlocation[k] != nFields ) {
+                    stencil.interpolate( fields[k], &( *probesArray )( fieldlocation[k], iPart_MPI ) );
+                }
+            }
+        } else {
+            smpi->dynamics_resize( ithread, nDim_particle, npart, false );
+            for( unsigned int ipart=0; ipart<npart; ipart++ ) {
+                int iparticle( ipart ); // Compatibility
+                int false_idx( 0 );   // Use in classical interp for now, not for probes
+                patch->probesInterp->fieldsAndCurrents(
+                    patch->EMfields,
+                    patch->probes[probe_n]->particles, smpi,
+                    &iparticle, &false_idx, ithread,
+                    &Jloc_fields, &Rloc_fields
+                );
+                //! here we fill the probe data!!!
+                ( *probesArray )( fieldlocation[0], iPart_MPI )=smpi->dynamics_Epart[ithread][ipart+0*npart];
+                ( *probesArray )( fieldlocation[1], iPart_MPI )=smpi->dynamics_Epart[ithread][ipart+1*npart];
+                ( *probesArray )( fieldlocation[2], iPart_MPI )=smpi->dynamics_Epart[ithread][ipart+2*npart];
+                ( *probesArray )( fieldlocation[3], iPart_MPI )=smpi->dynamics_Bpart[ithread][ipart+0*npart];
+                ( *probesArray )( fieldlocation[4], iPart_MPI )=smpi->dynamics_Bpart[ithread][ipart+1*npart];
+                ( *probesArray )( fieldlocation[5], iPart_MPI )=smpi->dynamics_Bpart[ithread][ipart+2*npart];
+                ( *probesArray )( fieldlocation[6], iPart_MPI )=Jloc_fields.x;
+                ( *probesArray )( fieldlocation[7], iPart_MPI )=Jloc_fields.y;
+                ( *probesArray )( fieldlocation[8], iPart_MPI )=Jloc_fields.z;
+                ( *probesArray )( fieldlocation[9], iPart_MPI )=Rloc_fields;
+                iPart_MPI++;
+            }
         }
         
         // Calculate Poynting flux on each point if needed
@@ -788,6 +822,10 @@ void DiagnosticProbes::run( SmileiMPI *smpi, VectorPatch &vecPatches, int itime,
                     unsigned int iloc = species_field_location[ispec][j];
                     int istart( 0 ), iend( npart );
                     double *FieldLoc = &( ( *probesArray )( iloc, offset_in_MPI[ipatch] ) );
+                    if( ! stencil.empty() ) {
+                        stencil.interpolate( patch->EMfields->allFields[start+ifield], FieldLoc );
+                        continue;
+                    }
                     patch->probesInterp->oneField(
                         &patch->EMfields->allFields[start+ifield],
                         patch->probes[probe_n]->particles,
@@ -843,7 +881,12 @@ void DiagnosticProbes::run( SmileiMPI *smpi, VectorPatch &vecPatches, int itime,
             H5Space memspace( {(hsize_t)nFields, nPart_MPI}, {}, {} );
             H5Space filespace( {(hsize_t)nFields, nPart_total_actual}, {0, offset_in_file[0]}, {(hsize_t)nFields, nPart_MPI} );
             // Create new dataset for this timestep
-            H5Write d = file_->array( dataset_name, *(probesArray->data_), &filespace, &memspace, true );
+            H5Write d = file_->dataset( dataset_name, H5T_NATIVE_DOUBLE, &filespace );
+            if( aggregator_ ) {
+                aggregator_->write( d, probesArray->data_, &filespace );
+            } else {
+                d.write( *(probesArray->data_), H5T_NATIVE_DOUBLE, &filespace, &memspace );
+            }
             // Write x_moved
             d.attr( "x_moved", x_moved );
             
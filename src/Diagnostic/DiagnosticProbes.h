@@ -2,8 +2,10 @@
 #define DIAGNOSTICPROBES_H
 
 #include "Diagnostic.h"
+#include "H5Aggregator.h"
 
 #include "Field2D.h"
+#include "Interpolator.h"
 
 
 class DiagnosticProbes : public Diagnostic
@@ -134,6 +136,9 @@ private:
     
     //! patch size
     std::vector<double> patch_size;
+    
+    //! Gathers the data of several ranks before writing, if requested (NULL otherwise)
+    H5Aggregator *aggregator_;
 };
 
 
@@ -151,6 +156,8 @@ public :
     Particles particles;
     int offset_in_file;
     std::vector<std::vector<double> > integrated_data;
+    //! Interpolation weights of the points, computed once after the points are created
+    InterpolatorStencil stencil;
 };
 
 
@@ -112,92 +112,58 @@ void DiagnosticRadiationSpectrum::openFile( Params& params, SmileiMPI* smpi )
     file_->flush();
 }
 
-// run one particle binning diagnostic
-void DiagnosticRadiationSpectrum::run( Patch* patch, int itime, SimWindow* simWindow )
+// Sum the radiated spectrum of each particle into the output array
+void DiagnosticRadiationSpectrum::deposit( Species *s, vector<int> &index, vector<double> &values, vector<double> &factor, double *output, bool atomic )
 {
-
-    vector<int> int_buffer;
-    vector<double> double_buffer;
+    unsigned int npart = index.size();
+    int ind;
     
-//    // Update spatial_min and spatial_max if needed
-//    if( simWindow ) {
-//        bool did_move = false;
-//        for( unsigned int i=0; i<histogram->axes.size(); i++ ) {
-//            if( histogram->axes[i]->type == "moving_x" ) {
-//                spatial_min[0] = histogram->axes[i]->min + simWindow->getXmoved();
-//                spatial_max[0] = histogram->axes[i]->max + simWindow->getXmoved();
-//                did_move = true;
-//            }
-//        }
-//        if( ! did_move ) {
-//            spatial_max[0] += simWindow->getXmoved() - spatial_min[0];
-//            spatial_min[0] = simWindow->getXmoved();
-//        }
-//    }
+    double gamma_inv, gamma, chi, xi, zeta, nu, cst;
+    double two_third_ov_chi, increment0, increment;
+    int iphoton_energy_max;
     
-    // loop species
-    for( unsigned int ispec=0 ; ispec < species.size() ; ispec++ ) {
-        
-        Species *s = patch->vecSpecies[species[ispec]];
-        unsigned int npart = s->particles->size();
-        int_buffer   .resize( npart );
-        double_buffer.resize( npart );
+    for( unsigned int ipart = 0 ; ipart < npart ; ipart++ ) {
+        ind = index[ipart];
+        if( ind<0 ) continue; // skip already discarded particles
+        ind *= photon_axis->nbins;
         
-        fill(int_buffer.begin(), int_buffer.end(), 0);
+        // Get the quantum parameter
+        chi = s->particles->chi( ipart );
         
-        histogram->digitize( s, double_buffer, int_buffer, simWindow );
+        // Update the spectrum only if the quantum parameter is sufficiently high
+        if( chi <= minimum_chi_continuous_ ) continue;
         
-        // Sum the data into the data_sum
-        // ------------------------------
-        int ind;
+        // Emitting particle energy (maximum of the spectrum)
+        gamma = s->particles->LorentzFactor( ipart );
+        gamma_inv = 1./gamma;
+        two_third_ov_chi = two_third/chi;
+        increment0 = gamma_inv * s->particles->weight( ipart );
         
-        double gamma_inv, gamma, chi, xi, zeta, nu, cst;
-        double two_third_ov_chi, increment0, increment;
-        int iphoton_energy_max;
+        // Compute the maximum iteration of the loop on bins
+        // ensures that xi<1;
+        // that is no radiation corresponds to photon energy larger than the radiating particle energy
+        if( photon_axis->logscale ) {
+            gamma = log10( gamma );
+        }
+        iphoton_energy_max = int( (gamma - photon_axis->actual_min) * photon_axis->coeff );
+        //iphoton_energy_max can not be greater than photon_energy_nbins
+        iphoton_energy_max = min( iphoton_energy_max, photon_axis->nbins );
         
-        for( unsigned int ipart = 0 ; ipart < npart ; ipart++ ) {
-            ind = int_buffer[ipart];
-            if( ind<0 ) continue; // skip already discarded particles
-            ind *= photon_axis->nbins;
-            
-            // Get the quantum parameter
-            chi = s->particles->chi( ipart );
-            
-            // Update the spectrum only if the quantum parameter is sufficiently high
-            if( chi <= minimum_chi_continuous_ ) continue;
-            
-            // Emitting particle energy (maximum of the spectrum)
-            gamma = s->particles->LorentzFactor( ipart );
-            gamma_inv = 1./gamma;
-            two_third_ov_chi = two_third/chi;
-            increment0 = gamma_inv * s->particles->weight( ipart );
-            
-            // Compute the maximum iteration of the loop on bins
-            // ensures that xi<1;
-            // that is no radiation corresponds to photon energy larger than the radiating particle energy
-            if( photon_axis->logscale ) {
-                gamma = log10( gamma );
-            }
-            iphoton_energy_max = int( (gamma - photon_axis->actual_min) * photon_axis->coeff );
-            //iphoton_energy_max can not be greater than photon_energy_nbins
-            iphoton_energy_max = min( iphoton_energy_max, photon_axis->nbins );
-            
-            // Loop on bins
-            for( int i=0; i<iphoton_energy_max; i++ ) {
-                xi   = photon_energies[i] * gamma_inv;
-                zeta = xi / (1.-xi); // xi<1 is ensured above
-                nu   = two_third_ov_chi * zeta;
-                cst  = xi * zeta;
-                increment = increment0 * delta_energies[i] * xi * RadiationTools::computeBesselPartsRadiatedPower(nu,cst);
+        // Loop on bins
+        for( int i=0; i<iphoton_energy_max; i++ ) {
+            xi   = photon_energies[i] * gamma_inv;
+            zeta = xi / (1.-xi); // xi<1 is ensured above
+            nu   = two_third_ov_chi * zeta;
+            cst  = xi * zeta;
+            increment = increment0 * delta_energies[i] * xi * RadiationTools::computeBesselPartsRadiatedPower(nu,cst);
+            if( atomic ) {
                 #pragma omp atomic
-                data_sum[ind+i] += increment;
+                output[ind+i] += increment;
+            } else {
+                output[ind+i] += increment;
             }
-            
         }
-    
+        
     }
     
-} // END run
-
-
-
+} // END deposit
@@ -16,7 +16,7 @@ public :
     
     void openFile( Params &params, SmileiMPI *smpi ) override;
     
-    void run( Patch *patch, int itime, SimWindow *simWindow ) override;
+    void deposit( Species *s, std::vector<int> &index, std::vector<double> &values, std::vector<double> &factor, double *output, bool atomic ) override;
     
     static std::vector<std::string> excludedAxes() {
         std::vector<std::string> excluded_axes( 0 );
@@ -149,6 +149,12 @@ public :
     //! Get disk footprint of current diagnostic
     uint64_t getDiskFootPrint( int istart, int istop, Patch *patch ) override;
     
+    //! Scalars are written in a text file
+    bool callsHDF5() override
+    {
+        return false;
+    }
+    
 private :
 
     //! Calculate the length of a string when output to the file
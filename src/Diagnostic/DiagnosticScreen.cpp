@@ -153,118 +153,90 @@ bool DiagnosticScreen::prepare( int itime )
 } // END prepare
 
 
-// run one screen diagnostic
-void DiagnosticScreen::run( Patch *patch, int itime, SimWindow *simWindow )
+// Verify that this patch is in a useful region for this diag
+bool DiagnosticScreen::patchIsUseful( Patch *patch )
 {
-
-    vector<int> int_buffer;
-    vector<double> double_buffer;
-    vector<bool> opposite;
-    unsigned int npart, ndim = screen_point.size(), ipart, idim, nuseful;
-    double side, side_old, dtg;
-    
-    // Verify that this patch is in a useful region for this diag
+    unsigned int ndim = screen_point.size(), idim;
     if( screen_type == 0 ) { // plane
         double distance_to_plane = 0.;
         for( idim=0; idim<ndim; idim++ ) {
             distance_to_plane += ( patch->center[idim] - screen_point[idim] ) * screen_unitvector[idim];
         }
-        if( abs( distance_to_plane ) > patch->radius ) {
-            return;
-        }
+        return abs( distance_to_plane ) <= patch->radius;
     } else { // sphere
         double distance_to_center = 0.;
         for( idim=0; idim<ndim; idim++ ) {
             distance_to_center += pow( patch->center[idim] - screen_point[idim], 2 );
         }
         distance_to_center = sqrt( distance_to_center );
-        if( abs( screen_vectornorm - distance_to_center ) > patch->radius ) {
-            return;
-        }
+        return abs( screen_vectornorm - distance_to_center ) <= patch->radius;
     }
+}
+
+
+// Fill the index with -1 (not crossing screen) and 0 (crossing screen),
+// and the factor with the contribution of each crossing particle, depending on the direction
+unsigned int DiagnosticScreen::selectParticles( Species *s, vector<int> &index, vector<double> &factor )
+{
+    unsigned int npart = index.size(), ndim = screen_point.size(), ipart, idim, nuseful = 0;
+    double side, side_old, dtg;
+    bool opposite;
+    factor.resize( npart );
     
-    // loop species
-    for( unsigned int ispec=0 ; ispec < species.size() ; ispec++ ) {
-    
-        Species *s = patch->vecSpecies[species[ispec]];
-        npart = s->particles->size();
-        nuseful = 0;
-        int_buffer   .resize( npart );
-        double_buffer.resize( npart );
-        opposite     .resize( npart, false );
-        
-        // Fill the int_buffer with -1 (not crossing screen) and 0 (crossing screen)
+    for( ipart=0; ipart<npart; ipart++ ) {
+        side = 0.;
+        side_old = 0.;
+        dtg = dt / s->particles->LorentzFactor( ipart );
         if( screen_type == 0 ) { // plane
-            for( ipart=0; ipart<npart; ipart++ ) {
-                side = 0.;
-                side_old = 0.;
-                dtg = dt / s->particles->LorentzFactor( ipart );
-                for( idim=0; idim<ndim; idim++ ) {
-                    side += ( s->particles->Position[idim][ipart] - screen_point[idim] ) * screen_unitvector[idim];
-                    side_old += ( s->particles->Position[idim][ipart] - dtg*( s->particles->Momentum[idim][ipart] ) - screen_point[idim] ) * screen_unitvector[idim];
-                }
-                if( side*side_old < 0. ) {
-                    int_buffer[ipart] = 0;
-                    nuseful++;
-                    if( side < 0. ) {
-                        opposite[ipart] = true;
-                    }
-                } else {
-                    int_buffer[ipart] = -1;
-                }
+            for( idim=0; idim<ndim; idim++ ) {
+                side += ( s->particles->Position[idim][ipart] - screen_point[idim] ) * screen_unitvector[idim];
+                side_old += ( s->particles->Position[idim][ipart] - dtg*( s->particles->Momentum[idim][ipart] ) - screen_point[idim] ) * screen_unitvector[idim];
             }
+            opposite = side < 0.;
         } else { // sphere
-            for( ipart=0; ipart<npart; ipart++ ) {
-                side = 0.;
-                side_old = 0.;
-                dtg = dt / s->particles->LorentzFactor( ipart );
-                for( idim=0; idim<ndim; idim++ ) {
-                    side += pow( s->particles->Position[idim][ipart] - screen_point[idim], 2 );
-                    side_old += pow( s->particles->Position[idim][ipart] - dtg*( s->particles->Momentum[idim][ipart] ) - screen_point[idim], 2 );
-                }
-                side     = screen_vectornorm-sqrt( side );
-                side_old = screen_vectornorm-sqrt( side_old );
-                if( side*side_old < 0. ) {
-                    int_buffer[ipart] = 0;
-                    nuseful++;
-                    if( side > 0. ) {
-                        opposite[ipart] = true;
-                    }
-                } else {
-                    int_buffer[ipart] = -1;
-                }
+            for( idim=0; idim<ndim; idim++ ) {
+                side += pow( s->particles->Position[idim][ipart] - screen_point[idim], 2 );
+                side_old += pow( s->particles->Position[idim][ipart] - dtg*( s->particles->Momentum[idim][ipart] ) - screen_point[idim], 2 );
             }
+            side     = screen_vectornorm-sqrt( side );
+            side_old = screen_vectornorm-sqrt( side_old );
+            opposite = side > 0.;
         }
-        
-        if( nuseful == 0 ) {
-            continue;
+        if( side*side_old < 0. ) {
+            index[ipart] = 0;
+            nuseful++;
+        } else {
+            index[ipart] = -1;
         }
-        
-        histogram->digitize( s, double_buffer, int_buffer, simWindow );
-        histogram->valuate( s, double_buffer, int_buffer );
-        
         if( direction_type == 1 ) { // canceling
-            for( ipart=0; ipart<npart; ipart++ )
-                if( opposite[ipart] ) {
-                    double_buffer[ipart] = -double_buffer[ipart];
-                }
+            factor[ipart] = opposite ? -1. : 1.;
         } else if( direction_type == 2 ) { // forward
-            for( ipart=0; ipart<npart; ipart++ )
-                if( opposite[ipart] ) {
-                    double_buffer[ipart] = 0.;
-                }
+            factor[ipart] = opposite ? 0. : 1.;
         } else if( direction_type == 3 ) { // backward
-            for( ipart=0; ipart<npart; ipart++ )
-                if( int_buffer[ipart]>=0 && !opposite[ipart] ) {
-                    double_buffer[ipart] = 0.;
-                }
+            factor[ipart] = opposite ? 1. : 0.;
+        } else {
+            factor[ipart] = 1.;
         }
-        
-        histogram->distribute( double_buffer, int_buffer, data_sum );
-        
     }
     
-} // END run
+    return nuseful;
+}
+
+
+// The deposited quantity is weighted by the factor of each particle (the deposited quantity may be shared
+// with other diagnostics, thus it is not modified)
+void DiagnosticScreen::deposit( Species *s, vector<int> &index, vector<double> &values, vector<double> &factor, double *output, bool atomic )
+{
+    if( direction_type == 0 ) {
+        histogram->distribute( values, index, output, atomic );
+        return;
+    }
+    unsigned int npart = index.size();
+    for( unsigned int ipart=0; ipart<npart; ipart++ ) {
+        factor[ipart] *= values[ipart];
+    }
+    histogram->distribute( factor, index, output, atomic );
+}
 
 bool DiagnosticScreen::writeNow( int itime ) {
     return timeSelection->theTimeIsNow( itime );
@@ -17,7 +17,11 @@ public :
     
     bool prepare( int itime ) override;
     
-    void run( Patch *patch, int itime, SimWindow *simWindow ) override;
+    bool patchIsUseful( Patch *patch ) override;
+    
+    unsigned int selectParticles( Species *s, std::vector<int> &index, std::vector<double> &factor ) override;
+    
+    void deposit( Species *s, std::vector<int> &index, std::vector<double> &values, std::vector<double> &factor, double *output, bool atomic ) override;
     
     bool writeNow( int itime ) override;
     
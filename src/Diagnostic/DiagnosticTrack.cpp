@@ -2,6 +2,7 @@
 
 #include <string>
 #include <sstream>
+#include <memory>
 
 #include "ParticleData.h"
 #include "PeekAtSpecies.h"
@@ -39,15 +40,37 @@ DiagnosticTrack::DiagnosticTrack( Params &params, SmileiMPI *smpi, VectorPatch &
     // Get parameter "flush_every" which decides the file flushing time selection
     flush_timeSelection = new TimeSelection( PyTools::extract_py( "flush_every", "DiagTrackParticles", iDiagTrackParticles ), name.str() );
     
+    // Get parameter "asynchronous"
+    asynchronous_ = false;
+    PyTools::extract( "asynchronous", asynchronous_, "DiagTrackParticles", iDiagTrackParticles );
+    if( asynchronous_ && ! AsyncWriter::available() ) {
+        WARNING( name.str() << ": asynchronous output requires OpenMP and MPI_THREAD_MULTIPLE, it is disabled" );
+        asynchronous_ = false;
+    }
+    
+    // Get the compression and precision parameters
+    readOutputFilter( "DiagTrackParticles", iDiagTrackParticles, name.str() );
+    
+    last_write_ = 0;
+    species_group = NULL;
+    momentum_group = NULL;
+    position_group = NULL;
+    file_space = NULL;
+    mem_space = NULL;
+    
     // Inform each patch about this diag
     for( unsigned int ipatch=0; ipatch<vecPatches.size(); ipatch++ ) {
         vecPatches( ipatch )->vecSpecies[speciesId_]->tracking_diagnostic = idiag;
     }
     
-    // Get parameter "filter" which gives a python function to select particles
+    // Get parameter "filter" which gives an expression or a python function to select particles
     filter = PyTools::extract_py( "filter", "DiagTrackParticles", iDiagTrackParticles );
     has_filter = ( filter != Py_None );
-    if( has_filter ) {
+    filter_expression_ = NULL;
+    string filter_string;
+    if( has_filter && PyTools::py2scalar( filter, filter_string ) ) {
+        filter_expression_ = new ParticleExpression( filter_string, nDim_particle, name.str() + " filter" );
+    } else if( has_filter ) {
 #ifdef SMILEI_USE_NUMPY
         // Test the filter with temporary, "fake" particles
         name << " filter:";
@@ -141,7 +164,7 @@ DiagnosticTrack::DiagnosticTrack( Params &params, SmileiMPI *smpi, VectorPatch &
     
     // Print some info
     if( smpi->isMaster() ) {
-        MESSAGE( 1, "Created TrackParticles #" << iDiagTrackParticles << ": species " << species_name );
+        MESSAGE( 1, "Created TrackParticles #" << iDiagTrackParticles << ": species " << species_name << ( asynchronous_?" (asynchronous)":"" ) );
         MESSAGE( 2, attr_list.str() );
     }
     
@@ -159,6 +182,9 @@ DiagnosticTrack::~DiagnosticTrack()
     delete timeSelection;
     delete flush_timeSelection;
     Py_DECREF( filter );
+    if( filter_expression_ ) {
+        delete filter_expression_;
+    }
     closeFile();
 }
 
@@ -219,15 +245,42 @@ void DiagnosticTrack::run( SmileiMPI *smpi, VectorPatch &vecPatches, int itime,
     uint64_t nParticles_global = 0;
     string xyz = "xyz";
     
-    H5Write *momentum_group=NULL, *position_group=NULL, *species_group=NULL;
-    H5Space *file_space=NULL, *mem_space=NULL;
+    // A filter expression selects the particles of the patches in parallel
+    if( filter_expression_ ) {
+        #pragma omp single
+        patch_selection.resize( vecPatches.size() );
+        #pragma omp for schedule(runtime)
+        for( unsigned int ipatch=0 ; ipatch<vecPatches.size() ; ipatch++ ) {
+            filter_expression_->select( *vecPatches( ipatch )->vecSpecies[speciesId_]->particles, patch_selection[ipatch] );
+        }
+    }
+    
     #pragma omp master
     {
+        // An asynchronous output first waits for the previous one to be written
+        if( asynchronous_ ) {
+            vecPatches.async_writer_.wait( last_write_ );
+        }
+        
         // Obtain the particle partition of all the patches in this MPI
         nParticles_local = 0;
         patch_start.resize( vecPatches.size() );
         
-        if( has_filter ) {
+        if( filter_expression_ ) {
+        
+            // Set the IDs of the selected particles which were not tracked before (ID==0)
+            for( unsigned int ipatch=0 ; ipatch<vecPatches.size() ; ipatch++ ) {
+                Particles *p = vecPatches( ipatch )->vecSpecies[speciesId_]->particles;
+                for( unsigned int i=0; i<patch_selection[ipatch].size(); i++ ) {
+                    if( p->id( patch_selection[ipatch][i] ) == 0 ) {
+                        p->id( patch_selection[ipatch][i] ) = ++latest_Id;
+                    }
+                }
+                patch_start[ipatch] = nParticles_local;
+                nParticles_local += patch_selection[ipatch].size();
+            }
+            
+        } else if( has_filter ) {
         
 #ifdef SMILEI_USE_NUMPY
             patch_selection.resize( vecPatches.size() );
@@ -273,9 +326,6 @@ void DiagnosticTrack::run( SmileiMPI *smpi, VectorPatch &vecPatches, int itime,
             }
         }
         
-        // Specify the memory dataspace (the size of the local buffer)
-        mem_space = new H5Space( (hsize_t)nParticles_local );
-        
         // Get the number of offset for this MPI rank
         uint64_t np_local = nParticles_local, offset;
         MPI_Scan( &np_local, &offset, 1, MPI_UNSIGNED_LONG_LONG, MPI_SUM, MPI_COMM_WORLD );
@@ -283,48 +333,65 @@ void DiagnosticTrack::run( SmileiMPI *smpi, VectorPatch &vecPatches, int itime,
         offset -= np_local;
         MPI_Bcast( &nParticles_global, 1, MPI_UNSIGNED_LONG_LONG, smpi->getSize()-1, MPI_COMM_WORLD );
         
-        // Make a new group for this iteration
-        ostringstream t( "" );
-        t << setfill( '0' ) << setw( 10 ) << itime;
-        // Create "data" group for openPMD compatibility
-        H5Write iteration_group = data_group->group( t.str() );
-        H5Write particles_group = iteration_group.group( "particles" );
-        species_group = new H5Write( &particles_group, vecPatches( 0 )->vecSpecies[speciesId_]->name_ );
-        
-        // Add openPMD attributes ( "basePath" )
-        openPMD_->writeBasePathAttributes( iteration_group, itime );
-        // Add openPMD attributes ( "particles" )
-        openPMD_->writeParticlesAttributes( particles_group );
-        // Add openPMD attributes ( path of a given species )
-        openPMD_->writeSpeciesAttributes( *species_group );
-        
-        // Write x_moved
-        iteration_group.attr( "x_moved", simWindow ? simWindow->getXmoved() : 0. );
-        
-        // Filespace and chunks
-        hsize_t chunk = 0;
-        if( nParticles_global>0 ) {
-            // Set the chunk size
-            unsigned int maximum_chunk_size = 100000000;
-            unsigned int number_of_chunks = nParticles_global/maximum_chunk_size;
-            if( nParticles_global%maximum_chunk_size != 0 ) {
-                number_of_chunks++;
-            }
-            if( number_of_chunks <= 1 ) {
-                chunk = 0;
-            } else {
-                unsigned int chunk_size = nParticles_global/number_of_chunks;
-                if( nParticles_global%number_of_chunks != 0 ) {
-                    chunk_size++;
+        // The state of the simulation is copied for the HDF5 operations, which may be deferred
+        uint64_t latest = latest_Id;
+        double x_moved = simWindow ? simWindow->getXmoved() : 0.;
+        string species_name = vecPatches( 0 )->vecSpecies[speciesId_]->name_;
+        int nproc = smpi->getSize(), iproc = smpi->getRank();
+        output( [=]() mutable {
+            // Specify the memory dataspace (the size of the local buffer)
+            mem_space = new H5Space( (hsize_t)np_local );
+            
+            // Make a new group for this iteration
+            ostringstream t( "" );
+            t << setfill( '0' ) << setw( 10 ) << itime;
+            // Create "data" group for openPMD compatibility
+            H5Write iteration_group = data_group->group( t.str() );
+            H5Write particles_group = iteration_group.group( "particles" );
+            species_group = new H5Write( &particles_group, species_name );
+            
+            // Add openPMD attributes ( "basePath" )
+            openPMD_->writeBasePathAttributes( iteration_group, itime );
+            // Add openPMD attributes ( "particles" )
+            openPMD_->writeParticlesAttributes( particles_group );
+            // Add openPMD attributes ( path of a given species )
+            openPMD_->writeSpeciesAttributes( *species_group );
+            
+            // Write x_moved
+            iteration_group.attr( "x_moved", x_moved );
+            
+            // Filespace and chunks
+            hsize_t chunk = 0;
+            if( nParticles_global>0 ) {
+                // Set the chunk size
+                unsigned int maximum_chunk_size = 100000000;
+                unsigned int number_of_chunks = nParticles_global/maximum_chunk_size;
+                if( nParticles_global%maximum_chunk_size != 0 ) {
+                    number_of_chunks++;
+                }
+                if( number_of_chunks <= 1 ) {
+                    chunk = 0;
+                } else {
+                    unsigned int chunk_size = nParticles_global/number_of_chunks;
+                    if( nParticles_global%number_of_chunks != 0 ) {
+                        chunk_size++;
+                    }
+                    chunk = chunk_size;
+                }
+                // Compression: chunks aligned with the average portion of each rank
+                if( output_filter_.compresses() ) {
+                    hsize_t aligned = 1 + ( nParticles_global - 1 ) / nproc;
+                    if( chunk == 0 || aligned < chunk ) {
+                        chunk = aligned;
+                    }
                 }
-                chunk = chunk_size;
             }
-        }
-        file_space = new H5Space( nParticles_global, offset, nParticles_local, chunk );
-        
-        // Create the "latest_IDs" dataset
-        // Create file space and select one element for each proc
-        iteration_group.vect( "latest_IDs", latest_Id, smpi->getSize(), H5T_NATIVE_UINT64, smpi->getRank(), 1 );
+            file_space = new H5Space( nParticles_global, offset, np_local, chunk );
+            
+            // Create the "latest_IDs" dataset
+            // Create file space and select one element for each proc
+            iteration_group.vect( "latest_IDs", latest, nproc, H5T_NATIVE_UINT64, iproc, 1 );
+        } );
         
     }
     
@@ -335,7 +402,10 @@ void DiagnosticTrack::run( SmileiMPI *smpi, VectorPatch &vecPatches, int itime,
     fill_buffer( vecPatches, 0, data_uint64 );
     #pragma omp master
     {
-        write_scalar( species_group, "id", data_uint64[0], H5T_NATIVE_UINT64, file_space, mem_space, SMILEI_UNIT_NONE );
+        auto buffer = stage( data_uint64 );
+        output( [=]() {
+            write_scalar( species_group, "id", ( *buffer )[0], H5T_NATIVE_UINT64, file_space, mem_space, SMILEI_UNIT_NONE );
+        } );
         data_uint64.resize( 0 );
     }
     
@@ -347,7 +417,10 @@ void DiagnosticTrack::run( SmileiMPI *smpi, VectorPatch &vecPatches, int itime,
         fill_buffer( vecPatches, 0, data_short );
         #pragma omp master
         {
-            write_scalar( species_group, "charge", data_short[0], H5T_NATIVE_SHORT, file_space, mem_space, SMILEI_UNIT_CHARGE );
+            auto buffer = stage( data_short );
+            output( [=]() {
+                write_scalar( species_group, "charge", ( *buffer )[0], H5T_NATIVE_SHORT, file_space, mem_space, SMILEI_UNIT_CHARGE );
+            } );
             data_short.resize( 0 );
         }
     }
@@ -360,16 +433,21 @@ void DiagnosticTrack::run( SmileiMPI *smpi, VectorPatch &vecPatches, int itime,
         #pragma omp barrier
         fill_buffer( vecPatches, nDim_particle+3, data_double );
         #pragma omp master
-        write_scalar( species_group, "weight", data_double[0], H5T_NATIVE_DOUBLE, file_space, mem_space, SMILEI_UNIT_DENSITY );
+        {
+            auto buffer = stage( data_double );
+            output( [=]() {
+                write_scalar( species_group, "weight", ( *buffer )[0], H5T_NATIVE_DOUBLE, file_space, mem_space, SMILEI_UNIT_DENSITY );
+            } );
+        }
     }
     
     // Momentum
     if( write_any_momentum ) {
         #pragma omp master
-        {
+        output( [=]() {
             momentum_group = new H5Write( species_group, "momentum" );
             openPMD_->writeRecordAttributes( *momentum_group, SMILEI_UNIT_MOMENTUM );
-        }
+        } );
         for( unsigned int idim=0; idim<3; idim++ ) {
             if( write_momentum[idim] ) {
                 #pragma omp barrier
@@ -383,31 +461,43 @@ void DiagnosticTrack::run( SmileiMPI *smpi, VectorPatch &vecPatches, int itime,
                             data_double[ip] *= vecPatches( 0 )->vecSpecies[speciesId_]->mass_;
                         }
                     }
-                    write_component( momentum_group, xyz.substr( idim, 1 ).c_str(), data_double[0], H5T_NATIVE_DOUBLE, file_space, mem_space, SMILEI_UNIT_MOMENTUM );
+                    auto buffer = stage( data_double );
+                    output( [=]() {
+                        write_component( momentum_group, xyz.substr( idim, 1 ).c_str(), ( *buffer )[0], H5T_NATIVE_DOUBLE, file_space, mem_space, SMILEI_UNIT_MOMENTUM );
+                    } );
                 }
             }
         }
         #pragma omp master
-        delete momentum_group;
+        output( [=]() {
+            delete momentum_group;
+        } );
     }
     
     // Position
     if( write_any_position ) {
         #pragma omp master
-        {
+        output( [=]() {
             position_group = new H5Write( species_group, "position" );
             openPMD_->writeRecordAttributes( *position_group, SMILEI_UNIT_POSITION );
-        }
+        } );
         for( unsigned int idim=0; idim<nDim_particle; idim++ ) {
             if( write_position[idim] ) {
                 #pragma omp barrier
                 fill_buffer( vecPatches, idim, data_double );
                 #pragma omp master
-                write_component( position_group, xyz.substr( idim, 1 ).c_str(), data_double[0], H5T_NATIVE_DOUBLE, file_space, mem_space, SMILEI_UNIT_POSITION );
+                {
+                    auto buffer = stage( data_double );
+                    output( [=]() {
+                        write_component( position_group, xyz.substr( idim, 1 ).c_str(), ( *buffer )[0], H5T_NATIVE_DOUBLE, file_space, mem_space, SMILEI_UNIT_POSITION );
+                    } );
+                }
             }
         }
         #pragma omp master
-        delete position_group;
+        output( [=]() {
+            delete position_group;
+        } );
     }
     
     // Chi - quantum parameter
@@ -421,7 +511,12 @@ void DiagnosticTrack::run( SmileiMPI *smpi, VectorPatch &vecPatches, int itime,
         fill_buffer( vecPatches, nDim_particle+3+1, data_double );
 #endif
         #pragma omp master
-        write_scalar( species_group, "chi", data_double[0], H5T_NATIVE_DOUBLE, file_space, mem_space, SMILEI_UNIT_NONE );
+        {
+            auto buffer = stage( data_double );
+            output( [=]() {
+                write_scalar( species_group, "chi", ( *buffer )[0], H5T_NATIVE_DOUBLE, file_space, mem_space, SMILEI_UNIT_NONE );
+            } );
+        }
     }
     
     #pragma omp barrier
@@ -465,58 +560,84 @@ void DiagnosticTrack::run( SmileiMPI *smpi, VectorPatch &vecPatches, int itime,
         // Write out the fields
         #pragma omp master
         {
-            if( write_any_E ) {
-                H5Write Efield_group = species_group->group( "E" );
-                openPMD_->writeRecordAttributes( Efield_group, SMILEI_UNIT_EFIELD );
-                for( unsigned int idim=0; idim<3; idim++ ) {
-                    if( write_E[idim] ) {
-                        write_component( &Efield_group, xyz.substr( idim, 1 ).c_str(), data_double[idim*nParticles_local], H5T_NATIVE_DOUBLE, file_space, mem_space, SMILEI_UNIT_EFIELD );
+            auto buffer = stage( data_double );
+            unsigned int n = nParticles_local;
+            output( [=]() {
+                if( write_any_E ) {
+                    H5Write Efield_group = species_group->group( "E" );
+                    openPMD_->writeRecordAttributes( Efield_group, SMILEI_UNIT_EFIELD );
+                    for( unsigned int idim=0; idim<3; idim++ ) {
+                        if( write_E[idim] ) {
+                            write_component( &Efield_group, xyz.substr( idim, 1 ).c_str(), ( *buffer )[idim*n], H5T_NATIVE_DOUBLE, file_space, mem_space, SMILEI_UNIT_EFIELD );
+                        }
                     }
                 }
-            }
-            
-            if( write_any_B ) {
-                H5Write Bfield_group = species_group->group( "B" );
-                openPMD_->writeRecordAttributes( Bfield_group, SMILEI_UNIT_BFIELD );
-                for( unsigned int idim=0; idim<3; idim++ ) {
-                    if( write_B[idim] ) {
-                        write_component( &Bfield_group, xyz.substr( idim, 1 ).c_str(), data_double[( 3+idim )*nParticles_local], H5T_NATIVE_DOUBLE, file_space, mem_space, SMILEI_UNIT_BFIELD );
+                
+                if( write_any_B ) {
+                    H5Write Bfield_group = species_group->group( "B" );
+                    openPMD_->writeRecordAttributes( Bfield_group, SMILEI_UNIT_BFIELD );
+                    for( unsigned int idim=0; idim<3; idim++ ) {
+                        if( write_B[idim] ) {
+                            write_component( &Bfield_group, xyz.substr( idim, 1 ).c_str(), ( *buffer )[( 3+idim )*n], H5T_NATIVE_DOUBLE, file_space, mem_space, SMILEI_UNIT_BFIELD );
+                        }
                     }
                 }
-            }
+            } );
         }
     } // END if interpolate
     
     #pragma omp master
     {
         data_double.resize( 0 );
-        
-        // PositionOffset (for OpenPMD)
-        H5Write positionoffset_group = species_group->group( "positionOffset" );
-        openPMD_->writeRecordAttributes( positionoffset_group, SMILEI_UNIT_POSITION );
-        vector<uint64_t> np = {nParticles_global};
-        for( unsigned int idim=0; idim<nDim_particle; idim++ ) {
-            H5Write xyz_group = positionoffset_group.group( xyz.substr( idim, 1 ) );
-            openPMD_->writeComponentAttributes( xyz_group, SMILEI_UNIT_POSITION );
-            xyz_group.attr( "value", 0. );
-            xyz_group.attr( "shape", np, H5T_NATIVE_UINT64 );
-        }
-        
-        // Close and flush
         patch_selection.resize( 0 );
         
-        delete file_space;
-        delete mem_space;
-        delete species_group;
+        output( [=]() {
+            // PositionOffset (for OpenPMD)
+            H5Write positionoffset_group = species_group->group( "positionOffset" );
+            openPMD_->writeRecordAttributes( positionoffset_group, SMILEI_UNIT_POSITION );
+            vector<uint64_t> np = {nParticles_global};
+            for( unsigned int idim=0; idim<nDim_particle; idim++ ) {
+                H5Write xyz_group = positionoffset_group.group( xyz.substr( idim, 1 ) );
+                openPMD_->writeComponentAttributes( xyz_group, SMILEI_UNIT_POSITION );
+                xyz_group.attr( "value", 0. );
+                xyz_group.attr( "shape", np, H5T_NATIVE_UINT64 );
+            }
+            
+            // Close and flush
+            delete file_space;
+            delete mem_space;
+            delete species_group;
+            
+            if( flush_timeSelection->theTimeIsNow( itime ) ) {
+                file_->flush();
+            }
+        } );
         
-        if( flush_timeSelection->theTimeIsNow( itime ) ) {
-            file_->flush();
+        // All HDF5 operations are done by the writer, from the staged data
+        if( asynchronous_ ) {
+            auto operations = make_shared<vector<function<void()> > >();
+            operations->swap( staged_operations_ );
+            last_write_ = vecPatches.async_writer_.push( [operations]() {
+                for( unsigned int i=0; i<operations->size(); i++ ) {
+                    ( *operations )[i]();
+                }
+            } );
         }
     }
     #pragma omp barrier
 }
 
 
+void DiagnosticTrack::output( function<void()> operation )
+{
+    if( asynchronous_ ) {
+        staged_operations_.push_back( operation );
+    } else {
+        operation();
+    }
+}
+
+
 void DiagnosticTrack::setIDs( Patch *patch )
 {
     // If filter, IDs are set on-the-fly
@@ -582,10 +703,22 @@ void DiagnosticTrack::fill_buffer( VectorPatch &vecPatches, unsigned int iprop,
 }
 
 
+template<typename T>
+shared_ptr<vector<T> > DiagnosticTrack::stage( vector<T> &buffer )
+{
+    if( asynchronous_ ) {
+        return make_shared<vector<T> >( buffer );
+    } else {
+        // No copy, the operation is executed immediately
+        return shared_ptr<vector<T> >( &buffer, []( vector<T> * ) {} );
+    }
+}
+
+
 template<typename T>
 void DiagnosticTrack::write_scalar( H5Write * location, string name, T &buffer, hid_t dtype, H5Space *file_space, H5Space *mem_space, unsigned int unit_type )
 {
-    H5Write a = location->array( name, buffer, dtype, file_space, mem_space );
+    H5Write a = location->array( name, buffer, dtype, file_space, mem_space, false, &output_filter_ );
     openPMD_->writeRecordAttributes( a, unit_type );
     openPMD_->writeComponentAttributes( a, unit_type );
 }
@@ -593,7 +726,7 @@ void DiagnosticTrack::write_scalar( H5Write * location, string name, T &buffer,
 template<typename T>
 void DiagnosticTrack::write_component( H5Write * location, string name, T &buffer, hid_t dtype, H5Space *file_space, H5Space *mem_space, unsigned int unit_type )
 {
-    H5Write a = location->array( name, buffer, dtype, file_space, mem_space );
+    H5Write a = location->array( name, buffer, dtype, file_space, mem_space, false, &output_filter_ );
     openPMD_->writeComponentAttributes( a, unit_type );
 }
 
@@ -616,8 +749,9 @@ uint64_t DiagnosticTrack::getDiskFootPrint( int istart, int istop, Patch *patch
     // Add necessary timestep headers approximately
     footprint += ndumps * 11250;
     
-    // Add size of each parameter
-    footprint += ndumps * ( uint64_t )( nparams * npart_total * 8 );
+    // Add size of each parameter (before compression)
+    uint64_t bytes = output_filter_.single_precision_ ? 4 : 8;
+    footprint += ndumps * ( uint64_t )( nparams * npart_total * bytes );
     
     return footprint;
 }
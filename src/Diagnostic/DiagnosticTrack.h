@@ -1,7 +1,11 @@
 #ifndef DIAGNOSTICTRACK_H
 #define DIAGNOSTICTRACK_H
 
+#include <functional>
+#include <memory>
+
 #include "Diagnostic.h"
+#include "ParticleExpression.h"
 
 class Patch;
 class Params;
@@ -36,6 +40,11 @@ public :
     //! Get disk footprint of current diagnostic
     uint64_t getDiskFootPrint( int istart, int istop, Patch *patch ) override;
     
+    bool callsHDF5() override
+    {
+        return ! asynchronous_;
+    }
+    
     //! Fills a buffer with the required particle property
     template<typename T> void fill_buffer( VectorPatch &vecPatches, unsigned int iprop, std::vector<T> &buffer );
     
@@ -45,6 +54,12 @@ public :
     //! Write a vector component dataset with the given buffer
     template<typename T> void write_component( H5Write*, std::string, T &, hid_t, H5Space*, H5Space*, unsigned int );
     
+    //! Execute an HDF5 operation now, or stage it for the asynchronous writer
+    void output( std::function<void()> operation );
+    
+    //! Buffer to be used by an HDF5 operation: the buffer itself, or a copy for the asynchronous writer
+    template<typename T> std::shared_ptr<std::vector<T> > stage( std::vector<T> &buffer );
+    
     //! Set a given patch's particles with the required IDs
     void setIDs( Patch * );
     
@@ -64,6 +79,17 @@ private :
     
     H5Write *data_group;
     
+    //! Locations and spaces of the current output
+    H5Write *species_group, *momentum_group, *position_group;
+    H5Space *file_space, *mem_space;
+    
+    //! Tells whether the writes are done by the asynchronous writer
+    bool asynchronous_;
+    //! HDF5 operations of the current output, staged for the asynchronous writer
+    std::vector<std::function<void()> > staged_operations_;
+    //! Ticket of the last asynchronous write
+    uint64_t last_write_;
+    
     //! Number of spatial dimensions
     unsigned int nDim_particle;
     
@@ -76,6 +102,9 @@ private :
     //! Tells whether this diag includes a particle filter
     PyObject *filter;
     
+    //! Filter given as an expression string, evaluated natively (NULL if python function)
+    ParticleExpression *filter_expression_;
+    
     //! Selection of the filtered particles in each patch
     std::vector<std::vector<unsigned int> > patch_selection;
     
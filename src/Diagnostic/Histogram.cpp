@@ -12,8 +12,7 @@ void Histogram::digitize( Species *s,
                           std::vector<int>    &int_buffer,
                           SimWindow *simWindow )
 {
-    unsigned int ipart, npart=s->particles->size();
-    int ind;
+    unsigned int npart=s->particles->size();
     
     for( unsigned int iaxis=0 ; iaxis < axes.size() ; iaxis++ ) {
     
@@ -21,72 +20,79 @@ void Histogram::digitize( Species *s,
         axes[iaxis]->digitize( s, double_buffer, int_buffer, npart, simWindow );
         // Now, double_buffer has the location of each particle along the axis
         
-        // if log scale, loop again and convert to log
-        if( axes[iaxis]->logscale ) {
-            for( ipart = 0 ; ipart < npart ; ipart++ ) {
-                if( int_buffer[ipart] < 0 ) {
-                    continue;
-                }
-                double_buffer[ipart] = log10( abs( double_buffer[ipart] ) );
-            }
-        }
+        digitizeAxis( iaxis, double_buffer, int_buffer, npart );
         
-        // The indexes are "reshaped" in one dimension.
-        // For instance, in 3d, the index has the form  i = i3 + n3*( i2 + n2*i1 )
-        // Here we do the multiplication by n3 or n2 (etc.)
-        if( iaxis>0 ) {
-            for( ipart = 0 ; ipart < npart ; ipart++ ) {
-                int_buffer[ipart] *= axes[iaxis]->nbins;
+    } // loop axes
+}
+
+// Compute the index of each particle along one axis, and accumulate it in the output index
+// The locations along the axis (double_buffer) are not modified, so that they can be shared by several histograms
+void Histogram::digitizeAxis( unsigned int iaxis,
+                              std::vector<double> &double_buffer,
+                              std::vector<int>    &int_buffer,
+                              unsigned int npart )
+{
+    unsigned int ipart;
+    int ind;
+    HistogramAxis *axis = axes[iaxis];
+    
+    // The indexes are "reshaped" in one dimension.
+    // For instance, in 3d, the index has the form  i = i3 + n3*( i2 + n2*i1 )
+    // Here we do the multiplication by n3 or n2 (etc.)
+    if( iaxis>0 ) {
+        for( ipart = 0 ; ipart < npart ; ipart++ ) {
+            int_buffer[ipart] *= axis->nbins;
+        }
+    }
+    
+    // loop again on the particles and calculate the index (converted to log if log scale)
+    // This is separated in two cases: edge_inclusive and edge_exclusive
+    if( !axis->edge_inclusive ) { // if the particles out of the "box" must be excluded
+    
+        for( ipart = 0 ; ipart < npart ; ipart++ ) {
+            // skip already discarded particles
+            if( int_buffer[ipart] < 0 ) {
+                continue;
+            }
+            // calculate index
+            double location = axis->logscale ? log10( abs( double_buffer[ipart] ) ) : double_buffer[ipart];
+            ind = floor( ( location-axis->actual_min ) * axis->coeff );
+            // index valid only if in the "box"
+            if( ind >= 0  &&  ind < axis->nbins ) {
+                int_buffer[ipart] += ind;
+            } else {
+                int_buffer[ipart] = -1;    // discard particle
             }
         }
         
-        // loop again on the particles and calculate the index
-        // This is separated in two cases: edge_inclusive and edge_exclusive
-        if( !axes[iaxis]->edge_inclusive ) { // if the particles out of the "box" must be excluded
-        
-            for( ipart = 0 ; ipart < npart ; ipart++ ) {
-                // skip already discarded particles
-                if( int_buffer[ipart] < 0 ) {
-                    continue;
-                }
-                // calculate index
-                ind = floor( ( double_buffer[ipart]-axes[iaxis]->actual_min ) * axes[iaxis]->coeff );
-                // index valid only if in the "box"
-                if( ind >= 0  &&  ind < axes[iaxis]->nbins ) {
-                    int_buffer[ipart] += ind;
-                } else {
-                    int_buffer[ipart] = -1;    // discard particle
-                }
+    } else { // if the particles out of the "box" must be included
+    
+        for( ipart = 0 ; ipart < npart ; ipart++ ) {
+            // skip already discarded particles
+            if( int_buffer[ipart] < 0 ) {
+                continue;
             }
-            
-        } else { // if the particles out of the "box" must be included
-        
-            for( ipart = 0 ; ipart < npart ; ipart++ ) {
-                // skip already discarded particles
-                if( int_buffer[ipart] < 0 ) {
-                    continue;
-                }
-                // calculate index
-                ind = floor( ( double_buffer[ipart]-axes[iaxis]->actual_min ) * axes[iaxis]->coeff );
-                // move out-of-range indexes back into range
-                if( ind < 0 ) {
-                    ind = 0;
-                }
-                if( ind >= axes[iaxis]->nbins ) {
-                    ind = axes[iaxis]->nbins-1;
-                }
-                int_buffer[ipart] += ind;
+            // calculate index
+            double location = axis->logscale ? log10( abs( double_buffer[ipart] ) ) : double_buffer[ipart];
+            ind = floor( ( location-axis->actual_min ) * axis->coeff );
+            // move out-of-range indexes back into range
+            if( ind < 0 ) {
+                ind = 0;
             }
-            
+            if( ind >= axis->nbins ) {
+                ind = axis->nbins-1;
+            }
+            int_buffer[ipart] += ind;
         }
         
-    } // loop axes
+    }
 }
 
 void Histogram::distribute(
     std::vector<double> &double_buffer,
     std::vector<int>    &int_buffer,
-    std::vector<double> &output_array )
+    double *output_array,
+    bool atomic )
 {
 
     unsigned int ipart, npart=double_buffer.size();
@@ -94,13 +100,23 @@ void Histogram::distribute(
     
     // Sum the data into the data_sum according to the indexes
     // ---------------------------------------------------------------
-    for( ipart = 0 ; ipart < npart ; ipart++ ) {
-        ind = int_buffer[ipart];
-        if( ind<0 ) {
-            continue;    // skip discarded particles
+    if( atomic ) {
+        for( ipart = 0 ; ipart < npart ; ipart++ ) {
+            ind = int_buffer[ipart];
+            if( ind<0 ) {
+                continue;    // skip discarded particles
+            }
+            #pragma omp atomic
+            output_array[ind] += double_buffer[ipart];
+        }
+    } else {
+        for( ipart = 0 ; ipart < npart ; ipart++ ) {
+            ind = int_buffer[ipart];
+            if( ind<0 ) {
+                continue;    // skip discarded particles
+            }
+            output_array[ind] += double_buffer[ipart];
         }
-        #pragma omp atomic
-        output_array[ind] += double_buffer[ipart];
     }
     
 }
@@ -127,3 +143,15 @@ void HistogramAxis::init( string type_, double min_, double max_, int nbins_, bo
     
     coeff = ( ( double )nbins )/( actual_max-actual_min );
 }
+
+// By default, the locations are given by the type of the axis and its coefficients
+string HistogramAxis::key()
+{
+    ostringstream k( "" );
+    k.precision( 17 );
+    k << type;
+    for( unsigned int i=0; i<coefficients.size(); i++ ) {
+        k << " " << coefficients[i];
+    }
+    return k.str();
+}
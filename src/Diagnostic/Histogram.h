@@ -6,6 +6,7 @@
 #include "ParticleData.h"
 #include "Patch.h"
 #include "SimWindow.h"
+#include "ParticleExpression.h"
 #include <algorithm>
 
 // Class for each axis of the particle diags
@@ -20,6 +21,10 @@ public:
     //! Function that goes through the particles and find where they should go in the axis
     virtual void digitize( Species *, std::vector<double> &, std::vector<int> &, unsigned int, SimWindow * ) {};
     
+    //! Identifies the quantity of the axis: axes with the same key give the same locations
+    //! (empty if the locations cannot be shared with other axes)
+    virtual std::string key();
+    
     //! Print some info about the axis
     std::string info( std::string title = "" ) {
         std::ostringstream mystream( "" );
@@ -72,12 +77,14 @@ public:
     
     //! Compute the index of each particle in the final histogram
     void digitize( Species *, std::vector<double> &, std::vector<int> &, SimWindow * );
+    //! Update the index of each particle in the final histogram, from its location along one axis
+    void digitizeAxis( unsigned int, std::vector<double> &, std::vector<int> &, unsigned int );
     //! Calculate the quantity of each particle to be summed in the histogram
     virtual void valuate( Species *, std::vector<double> &, std::vector<int> & ) {
         ERROR( "`deposited_quantity` should not be empty" );
     };
-    //! Add the contribution of each particle in the histogram
-    void distribute( std::vector<double> &, std::vector<int> &, std::vector<double> & );
+    //! Add the contribution of each particle in the histogram (atomically if shared between threads)
+    void distribute( std::vector<double> &, std::vector<int> &, double *, bool );
 
     std::string deposited_quantity;
 
@@ -558,6 +565,10 @@ public:
     {
         Py_DECREF( function );
     };
+    std::string key()
+    {
+        return "";
+    };
 private:
     void digitize( Species *s, std::vector<double> &array, std::vector<int> &index, unsigned int npart, SimWindow *simWindow )
     {
@@ -587,6 +598,31 @@ private:
 };
 #endif
 
+//! Axis given by an expression of the particle properties, evaluated natively
+class HistogramAxis_expression : public HistogramAxis
+{
+public:
+    HistogramAxis_expression( std::string expression, unsigned int nDim_particle, std::string errorPrefix ) :
+        HistogramAxis(),
+        expression_( expression, nDim_particle, errorPrefix )
+    {
+    };
+    ~HistogramAxis_expression() {};
+    std::string key()
+    {
+        return "expression " + expression_.expression();
+    };
+private:
+    void digitize( Species *s, std::vector<double> &array, std::vector<int> &, unsigned int npart, SimWindow * )
+    {
+        if( npart > 0 ) {
+            expression_.evaluate( *s->particles, 0, npart, &array[0] );
+        }
+    };
+    
+    ParticleExpression expression_;
+};
+
 //! Children classes, for various manners to fill the histogram
 class Histogram_number : public Histogram
 {
@@ -1133,6 +1169,26 @@ class Histogram_ekin_vx : public Histogram
     };
 };
 
+//! Deposited quantity given by an expression of the particle properties, evaluated natively
+class Histogram_expression : public Histogram
+{
+public:
+    Histogram_expression( std::string expression, unsigned int nDim_particle, std::string errorPrefix ) :
+        Histogram(),
+        expression_( expression, nDim_particle, errorPrefix )
+    {};
+    ~Histogram_expression() {};
+private:
+    void valuate( Species *s, std::vector<double> &array, std::vector<int> & )
+    {
+        if( array.size() > 0 ) {
+            expression_.evaluate( *s->particles, 0, array.size(), &array[0] );
+        }
+    };
+    
+    ParticleExpression expression_;
+};
+
 #ifdef SMILEI_USE_NUMPY
 class Histogram_user_function : public Histogram
 {
@@ -76,7 +76,8 @@ public:
             } else if( deposited_quantity == "" ) {
                 histogram = new Histogram();
             } else {
-                ERROR( deposited_quantityPrefix << " not understood" );
+                // Any other string is an expression of the particle properties
+                histogram = new Histogram_expression( deposited_quantity, params.nDim_particle, deposited_quantityPrefix );
             }
             histogram->deposited_quantity = deposited_quantity;
             Py_DECREF( deposited_quantity_object );
@@ -95,7 +96,7 @@ public:
         }
         
         // Loop axes and extract their format
-        unsigned int i_user_function = 0;
+        unsigned int i_user_function = 0, i_expression = 0;
         for( unsigned int iaxis=0; iaxis<pyAxes.size(); iaxis++ ) {
             std::ostringstream t( "" );
             t << errorPrefix << ", axis " << iaxis << ": ";
@@ -105,6 +106,9 @@ public:
             if( axis->type == "user_function" ) {
                 axis->type += std::to_string( i_user_function );
                 i_user_function++;
+            } else if( axis->type == "expression" ) {
+                axis->type += std::to_string( i_expression );
+                i_expression++;
             }
             
             histogram->axes.push_back( axis );
@@ -150,7 +154,7 @@ public:
             type_object = PySequence_Fast_GET_ITEM( seq, i );
             i++;
             if( PyTools::py2scalar( type_object, type ) ) {
-                if( type.substr( 0, 13 ) == "user_function" ) {
+                if( type.substr( 0, 13 ) == "user_function" || type.substr( 0, 10 ) == "expression" ) {
                     ERROR( errorPrefix << ": type " << type << " unknown" );
                 }
                 for( unsigned int i=0; i<excluded_axes.size(); i++ ) {
@@ -287,7 +291,9 @@ public:
             }
 #endif
             else {
-                ERROR( errorPrefix << type << " unknown" );
+                // Any other string is an expression of the particle properties
+                axis = new HistogramAxis_expression( type, params.nDim_particle, errorPrefix + "type" );
+                type = "expression";
             }
             
         } else { // hasType = false
@@ -0,0 +1,276 @@
+#include "ParticleBinningScheduler.h"
+
+#include <algorithm>
+
+#include "DiagnosticParticleBinningBase.h"
+#include "VectorPatch.h"
+
+using namespace std;
+
+ParticleBinningScheduler::ParticleBinningScheduler()
+{
+}
+
+ParticleBinningScheduler::~ParticleBinningScheduler()
+{
+}
+
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Identify the binning diagnostics, and allot the private arrays in the order of the list
+// ---------------------------------------------------------------------------------------------------------------------
+void ParticleBinningScheduler::init( vector<Diagnostic *> &diags )
+{
+    binning_.resize( diags.size() );
+    handled_.resize( diags.size() );
+    private_.resize( diags.size() );
+    unsigned int private_size = 0;
+    for( unsigned int idiag=0; idiag<diags.size(); idiag++ ) {
+        binning_[idiag] = dynamic_cast<DiagnosticParticleBinningBase *>( diags[idiag] );
+        handled_[idiag] = binning_[idiag] != NULL;
+        private_[idiag] = handled_[idiag] && private_size + binning_[idiag]->output_size <= max_private_size_;
+        if( private_[idiag] ) {
+            private_size += binning_[idiag]->output_size;
+        }
+    }
+}
+
+
+unsigned int ParticleBinningScheduler::find( vector<string> &keys, string key )
+{
+    unsigned int i = std::find( keys.begin(), keys.end(), key ) - keys.begin();
+    if( i == keys.size() ) {
+        keys.push_back( key );
+    }
+    return i;
+}
+
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Prepare the binning diagnostics, and list the species and shared arrays needed by those due at this timestep
+// ---------------------------------------------------------------------------------------------------------------------
+void ParticleBinningScheduler::prepare( vector<Diagnostic *> &diags, int itime )
+{
+    if( binning_.size() != diags.size() ) {
+        init( diags );
+    }
+
+    due_.clear();
+    axes_.clear();
+    quantities_.clear();
+    axis_id_.clear();
+    quantity_id_.clear();
+    vector<string> axis_keys, quantity_keys;
+    vector<vector<unsigned int> > diags_by_species;
+
+    for( unsigned int idiag=0; idiag<diags.size(); idiag++ ) {
+        if( ! handled_[idiag] ) {
+            continue;
+        }
+        DiagnosticParticleBinningBase *d = binning_[idiag];
+        d->theTimeIsNow = d->prepare( itime );
+        if( ! d->theTimeIsNow ) {
+            continue;
+        }
+        unsigned int i = due_.size();
+        due_.push_back( idiag );
+
+        // Axes with the same key share the locations of the particles
+        // (not the user functions, which are specific to each diagnostic)
+        Histogram *histogram = d->histogram;
+        axis_id_.push_back( vector<unsigned int>( histogram->axes.size() ) );
+        for( unsigned int iaxis=0; iaxis<histogram->axes.size(); iaxis++ ) {
+            HistogramAxis *axis = histogram->axes[iaxis];
+            string key = axis->key();
+            if( key.empty() ) {
+                key = axis->type + " #" + to_string( idiag );
+            }
+            axis_id_[i][iaxis] = find( axis_keys, key );
+            if( axis_id_[i][iaxis] == axes_.size() ) {
+                axes_.push_back( axis );
+            }
+        }
+
+        // Same for the deposited quantity (the text of the expressions is their key)
+        if( histogram->deposited_quantity.empty() ) {
+            quantity_id_.push_back( -1 );
+        } else {
+            string key = histogram->deposited_quantity;
+            if( key == "user_function" ) {
+                key += " #" + to_string( idiag );
+            }
+            quantity_id_.push_back( find( quantity_keys, key ) );
+            if( quantity_id_[i] == ( int )quantities_.size() ) {
+                quantities_.push_back( histogram );
+            }
+        }
+
+        for( unsigned int j=0; j<d->species.size(); j++ ) {
+            unsigned int ispec = d->species[j];
+            if( ispec >= diags_by_species.size() ) {
+                diags_by_species.resize( ispec+1 );
+            }
+            diags_by_species[ispec].push_back( i );
+        }
+    }
+
+    // Species in increasing order, as in each diagnostic
+    species_.clear();
+    species_diags_.clear();
+    for( unsigned int ispec=0; ispec<diags_by_species.size(); ispec++ ) {
+        if( ! diags_by_species[ispec].empty() ) {
+            species_.push_back( ispec );
+            species_diags_.push_back( diags_by_species[ispec] );
+        }
+    }
+
+#ifdef _OPENMP
+    unsigned int nthreads = omp_get_num_threads();
+#else
+    unsigned int nthreads = 1;
+#endif
+    workspaces_.resize( nthreads );
+    for( unsigned int ithread=0; ithread<nthreads; ithread++ ) {
+        Workspace &w = workspaces_[ithread];
+        w.axis_values.resize( axes_.size() );
+        w.quantity_values.resize( quantities_.size() );
+        w.axis_needed.resize( axes_.size() );
+        w.quantity_needed.resize( quantities_.size() );
+        w.index.resize( due_.size() );
+        w.factor.resize( due_.size() );
+        w.useful.resize( due_.size() );
+        w.active.resize( due_.size() );
+        w.accumulators.resize( diags.size() );
+        w.touched.resize( diags.size(), false );
+    }
+}
+
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Bin the particles of all patches, then sum the private arrays of the threads in the outputs
+// ---------------------------------------------------------------------------------------------------------------------
+void ParticleBinningScheduler::run( VectorPatch &vecPatches, SimWindow *simWindow )
+{
+    if( due_.empty() ) {
+        return;
+    }
+
+#ifdef _OPENMP
+    Workspace &w = workspaces_[omp_get_thread_num()];
+#else
+    Workspace &w = workspaces_[0];
+#endif
+
+    // The private arrays are allocated by their thread
+    for( unsigned int i=0; i<due_.size(); i++ ) {
+        unsigned int idiag = due_[i];
+        if( private_[idiag] && w.accumulators[idiag].size() != binning_[idiag]->output_size ) {
+            w.accumulators[idiag].assign( binning_[idiag]->output_size, 0. );
+        }
+    }
+
+    #pragma omp for schedule(runtime) nowait
+    for( unsigned int ipatch=0 ; ipatch<vecPatches.size() ; ipatch++ ) {
+        runPatch( vecPatches( ipatch ), w, simWindow );
+    }
+
+    for( unsigned int i=0; i<due_.size(); i++ ) {
+        unsigned int idiag = due_[i];
+        if( ! w.touched[idiag] ) {
+            continue;
+        }
+        vector<double> &accumulator = w.accumulators[idiag];
+        vector<double> &data_sum = binning_[idiag]->data_sum;
+        #pragma omp critical (binning_accumulators)
+        {
+            for( unsigned int j=0; j<accumulator.size(); j++ ) {
+                data_sum[j] += accumulator[j];
+            }
+        }
+        fill( accumulator.begin(), accumulator.end(), 0. );
+        w.touched[idiag] = false;
+    }
+    #pragma omp barrier
+}
+
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Bin the particles of one patch, species by species
+// ---------------------------------------------------------------------------------------------------------------------
+void ParticleBinningScheduler::runPatch( Patch *patch, Workspace &w, SimWindow *simWindow )
+{
+    for( unsigned int i=0; i<due_.size(); i++ ) {
+        w.useful[i] = binning_[due_[i]]->patchIsUseful( patch );
+    }
+
+    for( unsigned int is=0; is<species_.size(); is++ ) {
+        Species *s = patch->vecSpecies[species_[is]];
+        unsigned int npart = s->particles->size();
+        if( npart == 0 ) {
+            continue;
+        }
+        vector<unsigned int> &diags = species_diags_[is];
+
+        // Select the particles of each diagnostic, and list the shared arrays that they need
+        fill( w.axis_needed.begin(), w.axis_needed.end(), false );
+        fill( w.quantity_needed.begin(), w.quantity_needed.end(), false );
+        bool any = false;
+        for( unsigned int j=0; j<diags.size(); j++ ) {
+            unsigned int i = diags[j];
+            w.active[i] = false;
+            if( ! w.useful[i] ) {
+                continue;
+            }
+            w.index[i].resize( npart );
+            if( binning_[due_[i]]->selectParticles( s, w.index[i], w.factor[i] ) == 0 ) {
+                continue;
+            }
+            w.active[i] = true;
+            any = true;
+            for( unsigned int iaxis=0; iaxis<axis_id_[i].size(); iaxis++ ) {
+                w.axis_needed[axis_id_[i][iaxis]] = true;
+            }
+            if( quantity_id_[i] >= 0 ) {
+                w.quantity_needed[quantity_id_[i]] = true;
+            }
+        }
+        if( ! any ) {
+            continue;
+        }
+
+        // Compute the shared arrays once, for all particles
+        w.all.assign( npart, 0 );
+        for( unsigned int k=0; k<axes_.size(); k++ ) {
+            if( w.axis_needed[k] ) {
+                w.axis_values[k].resize( npart );
+                axes_[k]->digitize( s, w.axis_values[k], w.all, npart, simWindow );
+            }
+        }
+        for( unsigned int k=0; k<quantities_.size(); k++ ) {
+            if( w.quantity_needed[k] ) {
+                w.quantity_values[k].resize( npart );
+                quantities_[k]->valuate( s, w.quantity_values[k], w.all );
+            }
+        }
+
+        // Each diagnostic sums the contributions of its particles
+        for( unsigned int j=0; j<diags.size(); j++ ) {
+            unsigned int i = diags[j];
+            if( ! w.active[i] ) {
+                continue;
+            }
+            unsigned int idiag = due_[i];
+            DiagnosticParticleBinningBase *d = binning_[idiag];
+            for( unsigned int iaxis=0; iaxis<axis_id_[i].size(); iaxis++ ) {
+                d->histogram->digitizeAxis( iaxis, w.axis_values[axis_id_[i][iaxis]], w.index[i], npart );
+            }
+            vector<double> &values = quantity_id_[i] >= 0 ? w.quantity_values[quantity_id_[i]] : w.no_values;
+            if( private_[idiag] ) {
+                d->deposit( s, w.index[i], values, w.factor[i], &w.accumulators[idiag][0], false );
+                w.touched[idiag] = true;
+            } else {
+                d->deposit( s, w.index[i], values, w.factor[i], &d->data_sum[0], true );
+            }
+        }
+    }
+}
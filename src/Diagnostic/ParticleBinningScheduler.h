@@ -0,0 +1,106 @@
+#ifndef PARTICLEBINNINGSCHEDULER_H
+#define PARTICLEBINNINGSCHEDULER_H
+
+#include <vector>
+#include <string>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+class Diagnostic;
+class DiagnosticParticleBinningBase;
+class HistogramAxis;
+class Histogram;
+class Patch;
+class SimWindow;
+class VectorPatch;
+
+//  --------------------------------------------------------------------------------------------------------------------
+//! Class ParticleBinningScheduler: runs together all the particle binning diagnostics due at a timestep
+//
+//! The ParticleBinning, Screen and RadiationSpectrum diagnostics are grouped by species. The particles of each
+//! patch and species are read once for all diagnostics: the locations along the axes and the deposited quantities
+//! which appear in several diagnostics (same type and coefficients, or same expression) are computed only once. Each diagnostic then
+//! sums its histogram from these shared arrays, in arrays private to each thread (when small enough) which are
+//! added to the diagnostic output at the end of the loop on patches.
+//  --------------------------------------------------------------------------------------------------------------------
+class ParticleBinningScheduler
+{
+public:
+    ParticleBinningScheduler();
+    ~ParticleBinningScheduler();
+    ParticleBinningScheduler( const ParticleBinningScheduler & ) = delete;
+    ParticleBinningScheduler &operator=( const ParticleBinningScheduler & ) = delete;
+
+    //! Prepares the binning diagnostics of the list, and gathers those due at this timestep (called by one thread)
+    void prepare( std::vector<Diagnostic *> &diags, int itime );
+
+    //! Bins the particles of all patches in the diagnostics due at this timestep (called by all threads)
+    void run( VectorPatch &vecPatches, SimWindow *simWindow );
+
+    //! Whether the diagnostic idiag of the list is a binning diagnostic, prepared and run by the scheduler
+    bool handles( unsigned int idiag )
+    {
+        return idiag < handled_.size() && handled_[idiag];
+    }
+
+private:
+    //! Arrays of one thread
+    struct Workspace {
+        //! Null index of all particles, to compute the shared arrays for all of them
+        std::vector<int> all;
+        //! Shared locations along the axes, and shared deposited quantities
+        std::vector<std::vector<double> > axis_values, quantity_values;
+        //! Empty deposited quantity, for diagnostics which do not need one
+        std::vector<double> no_values;
+        //! Index in the histogram, and factor of the deposited quantity, for each due diagnostic
+        std::vector<std::vector<int> > index;
+        std::vector<std::vector<double> > factor;
+        //! Whether the current patch is useful to each due diagnostic, and whether these diagnostics bin
+        //! some particles of the current species
+        std::vector<bool> useful, active;
+        //! Whether the shared arrays are needed for the current species
+        std::vector<bool> axis_needed, quantity_needed;
+        //! Private output array of each diagnostic of the list (empty if the output is summed atomically)
+        std::vector<std::vector<double> > accumulators;
+        //! Whether the private array of each diagnostic of the list received data
+        std::vector<bool> touched;
+    };
+
+    //! Bins the particles of one patch
+    void runPatch( Patch *patch, Workspace &w, SimWindow *simWindow );
+
+    //! Identifies the binning diagnostics of the list, and allots them the private arrays
+    void init( std::vector<Diagnostic *> &diags );
+
+    //! Index of the item with the given key in the list of keys (added if needed)
+    static unsigned int find( std::vector<std::string> &keys, std::string key );
+
+    //! Binning diagnostics of the list (NULL for the other diagnostics)
+    std::vector<DiagnosticParticleBinningBase *> binning_;
+    //! Whether each diagnostic of the list is a binning diagnostic
+    std::vector<bool> handled_;
+    //! Whether each diagnostic of the list sums its output in arrays private to each thread
+    std::vector<bool> private_;
+
+    //! Diagnostics due at this timestep (positions in the list)
+    std::vector<unsigned int> due_;
+    //! Species binned by the due diagnostics, and the due diagnostics binning each of them
+    std::vector<unsigned int> species_;
+    std::vector<std::vector<unsigned int> > species_diags_;
+    //! Axes and histograms computing the shared arrays
+    std::vector<HistogramAxis *> axes_;
+    std::vector<Histogram *> quantities_;
+    //! For each due diagnostic, position of the shared array of each axis, and of the deposited quantity (-1 if none)
+    std::vector<std::vector<unsigned int> > axis_id_;
+    std::vector<int> quantity_id_;
+
+    //! Arrays of each thread
+    std::vector<Workspace> workspaces_;
+
+    //! Maximum size of the private arrays of one thread (number of doubles)
+    static const unsigned int max_private_size_ = 1<<21;
+};
+
+#endif
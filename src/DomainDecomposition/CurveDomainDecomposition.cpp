@@ -0,0 +1,197 @@
+
+#include "CurveDomainDecomposition.h"
+
+#include <algorithm>
+#include <cmath>
+#include <mpi.h>
+
+#include "Hilbert_functions.h"
+#include "Tools.h"
+
+using namespace std;
+
+
+CurveDomainDecomposition::CurveDomainDecomposition( Params &params )
+    : DomainDecomposition( params )
+{
+    ndomain_ = params.number_of_patches;
+    ndomain_.resize( params.nDim_field );
+}
+
+
+// Sort the patches by increasing key along the curve
+void CurveDomainDecomposition::tabulate()
+{
+    unsigned int npatches = 1;
+    for( unsigned int i=0; i<ndomain_.size(); i++ ) {
+        npatches *= ndomain_[i];
+    }
+
+    vector<uint64_t> key( npatches );
+    vector<unsigned int> coords( ndomain_.size() );
+    for( unsigned int ipos=0; ipos<npatches; ipos++ ) {
+        unsigned int rest = ipos;
+        for( int i=ndomain_.size()-1; i>=0; i-- ) {
+            coords[i] = rest % ndomain_[i];
+            rest /= ndomain_[i];
+        }
+        key[ipos] = curveKey( coords );
+    }
+
+    patch_position_.resize( npatches );
+    for( unsigned int ipos=0; ipos<npatches; ipos++ ) {
+        patch_position_[ipos] = ipos;
+    }
+    sort( patch_position_.begin(), patch_position_.end(), [&key]( unsigned int a, unsigned int b ) {
+        return key[a] < key[b];
+    } );
+
+    curve_index_.resize( npatches );
+    for( unsigned int h=0; h<npatches; h++ ) {
+        curve_index_[patch_position_[h]] = h;
+    }
+}
+
+
+unsigned int CurveDomainDecomposition::getDomainId( std::vector<int> Coordinates )
+{
+    unsigned int ipos = 0;
+    for( unsigned int i=0; i<ndomain_.size(); i++ ) {
+        if( Coordinates[i] < 0 || Coordinates[i] >= ( int )ndomain_[i] ) {
+            return MPI_PROC_NULL;
+        }
+        ipos = ipos * ndomain_[i] + Coordinates[i];
+    }
+    return curve_index_[ipos];
+}
+
+
+std::vector<unsigned int> CurveDomainDecomposition::getDomainCoordinates( unsigned int Id )
+{
+    std::vector<unsigned int> coords( ndomain_.size() );
+    unsigned int rest = patch_position_[Id];
+    for( int i=ndomain_.size()-1; i>=0; i-- ) {
+        coords[i] = rest % ndomain_[i];
+        rest /= ndomain_[i];
+    }
+    return coords;
+}
+
+
+MortonDomainDecomposition::MortonDomainDecomposition( Params &params )
+    : CurveDomainDecomposition( params )
+{
+    unsigned int nbits = 0;
+    mi_.resize( ndomain_.size(), 0 );
+    for( unsigned int i=0; i<ndomain_.size(); i++ ) {
+        while( ( 1u << mi_[i] ) < ndomain_[i] ) {
+            mi_[i]++;
+        }
+        nbits += mi_[i];
+    }
+    if( nbits > 63 ) {
+        ERROR( "Too many patches for the Morton curve" );
+    }
+    tabulate();
+}
+
+
+// Interleave the bits of the coordinates, from the most significant ones.
+// The directions with more patches start alone.
+uint64_t MortonDomainDecomposition::curveKey( std::vector<unsigned int> &Coordinates )
+{
+    unsigned int mmax = *max_element( mi_.begin(), mi_.end() );
+    uint64_t key = 0;
+    for( int l=mmax-1; l>=0; l-- ) {
+        for( unsigned int i=0; i<mi_.size(); i++ ) {
+            if( l < ( int )mi_[i] ) {
+                key = ( key << 1 ) | ( ( Coordinates[i] >> l ) & 1 );
+            }
+        }
+    }
+    return key;
+}
+
+
+PeanoDomainDecomposition::PeanoDomainDecomposition( Params &params )
+    : CurveDomainDecomposition( params )
+{
+    double nbits = 0.;
+    mi_.resize( ndomain_.size(), 0 );
+    for( unsigned int i=0; i<ndomain_.size(); i++ ) {
+        unsigned int n = 1;
+        while( n < ndomain_[i] ) {
+            n *= 3;
+            mi_[i]++;
+        }
+        nbits += mi_[i] * log2( 3. );
+    }
+    if( nbits > 63. ) {
+        ERROR( "Too many patches for the Peano curve" );
+    }
+    tabulate();
+}
+
+
+// Interleave the base-3 digits of the coordinates, from the most significant ones.
+// A digit is reflected (d -> 2-d) when the sum of the previous digits of the other directions is odd.
+uint64_t PeanoDomainDecomposition::curveKey( std::vector<unsigned int> &Coordinates )
+{
+    unsigned int mmax = *max_element( mi_.begin(), mi_.end() );
+    unsigned int ndim = mi_.size();
+    vector<unsigned int> power( ndim );
+    for( unsigned int i=0; i<ndim; i++ ) {
+        power[i] = 1;
+        for( unsigned int l=1; l<mi_[i]; l++ ) {
+            power[i] *= 3;
+        }
+    }
+    uint64_t key = 0;
+    unsigned int sum_all = 0;
+    vector<unsigned int> sum_dim( ndim, 0 );
+    for( int l=mmax-1; l>=0; l-- ) {
+        for( unsigned int i=0; i<ndim; i++ ) {
+            if( l < ( int )mi_[i] ) {
+                unsigned int digit = ( Coordinates[i] / power[i] ) % 3;
+                power[i] /= 3;
+                if( ( sum_all - sum_dim[i] ) % 2 ) {
+                    digit = 2 - digit;
+                }
+                key = 3 * key + digit;
+                sum_all += digit;
+                sum_dim[i] += digit;
+            }
+        }
+    }
+    return key;
+}
+
+
+GeneralHilbertDomainDecomposition::GeneralHilbertDomainDecomposition( Params &params )
+    : CurveDomainDecomposition( params )
+{
+    unsigned int nbits = 0;
+    mi_.resize( 3, 0 );
+    for( unsigned int i=0; i<ndomain_.size(); i++ ) {
+        while( ( 1u << mi_[i] ) < ndomain_[i] ) {
+            mi_[i]++;
+        }
+        nbits += mi_[i];
+    }
+    if( nbits > 31 ) {
+        ERROR( "Too many patches for the generalized Hilbert curve" );
+    }
+    tabulate();
+}
+
+
+uint64_t GeneralHilbertDomainDecomposition::curveKey( std::vector<unsigned int> &Coordinates )
+{
+    if( ndomain_.size() == 1 ) {
+        return Coordinates[0];
+    } else if( ndomain_.size() == 2 ) {
+        return generalhilbertindex( mi_[0], mi_[1], Coordinates[0], Coordinates[1] );
+    } else {
+        return generalhilbertindex( mi_[0], mi_[1], mi_[2], Coordinates[0], Coordinates[1], Coordinates[2] );
+    }
+}
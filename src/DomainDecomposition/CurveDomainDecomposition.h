@@ -0,0 +1,73 @@
+
+#ifndef CURVEDOMAINDECOMPOSITION_H
+#define CURVEDOMAINDECOMPOSITION_H
+
+#include <cstdint>
+
+#include "DomainDecomposition.h"
+
+//! Patches ordered along a space-filling curve, tabulated at initialization.
+//! The curve is drawn in the smallest box it fits in (e.g. powers of 2 for Morton),
+//! and the patches outside the simulation box are skipped.
+class CurveDomainDecomposition : public DomainDecomposition
+{
+public:
+    CurveDomainDecomposition( Params &params );
+    virtual ~CurveDomainDecomposition( ) {};
+
+    unsigned int getDomainId( std::vector<int> Coordinates ) override;
+    std::vector<unsigned int> getDomainCoordinates( unsigned int Id ) override;
+
+protected:
+    //! Position of the patch of given coordinates along the curve drawn in the enclosing box
+    virtual uint64_t curveKey( std::vector<unsigned int> &Coordinates ) = 0;
+    //! Sort the patches along the curve (to be called by the constructors of the final classes)
+    void tabulate();
+
+    //! Number of digits (bits for Morton and Hilbert, trits for Peano) of the coordinates in each direction
+    std::vector<unsigned int> mi_;
+
+private:
+    //! Index along the curve of each patch, stored in row-major order of the patch coordinates
+    std::vector<unsigned int> curve_index_;
+    //! Row-major position of the patch at each index along the curve
+    std::vector<unsigned int> patch_position_;
+};
+
+
+//! Z-order curve: the bits of the coordinates are interleaved
+class MortonDomainDecomposition final : public CurveDomainDecomposition
+{
+public:
+    MortonDomainDecomposition( Params &params );
+    ~MortonDomainDecomposition( ) override final {};
+
+protected:
+    uint64_t curveKey( std::vector<unsigned int> &Coordinates ) override final;
+};
+
+
+//! Peano (meander) curve: continuous when the number of patches in each direction is a power of 3
+class PeanoDomainDecomposition final : public CurveDomainDecomposition
+{
+public:
+    PeanoDomainDecomposition( Params &params );
+    ~PeanoDomainDecomposition( ) override final {};
+
+protected:
+    uint64_t curveKey( std::vector<unsigned int> &Coordinates ) override final;
+};
+
+
+//! Hilbert curve for any number of patches: the curve of the enclosing power of 2 box, skipping the missing patches
+class GeneralHilbertDomainDecomposition final : public CurveDomainDecomposition
+{
+public:
+    GeneralHilbertDomainDecomposition( Params &params );
+    ~GeneralHilbertDomainDecomposition( ) override final {};
+
+protected:
+    uint64_t curveKey( std::vector<unsigned int> &Coordinates ) override final;
+};
+
+#endif
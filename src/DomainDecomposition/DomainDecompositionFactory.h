@@ -6,6 +6,8 @@
 #include "HilbertDomainDecomposition.h"
 // Patches decomposition along a linearized curve
 #include "LinearizedDomainDecomposition.h"
+// Patches decomposition along other space-filling curves
+#include "CurveDomainDecomposition.h"
 // Domain decomposition (linearized)
 #include "RegionDomainDecomposition.h"
 
@@ -26,6 +28,28 @@ public:
             } else {
                 ERROR( "Unknown geometry" );
             }
+        } else if( ( params.patch_arrangement=="morton" )
+                   || ( params.patch_arrangement=="peano" )
+                   || ( params.patch_arrangement=="generalized_hilbertian" ) ) {
+        
+            // Fields diagnostics fold the curve in blocks of 2^n patches, which must be rectangles
+            bool enable_diagField( params.patch_arrangement != "peano" );
+            for( unsigned int iDim=0 ; iDim<params.nDim_field ; iDim++ ) {
+                if( ( params.number_of_patches[iDim] & ( params.number_of_patches[iDim]-1 ) ) != 0 ) {
+                    enable_diagField = false;
+                }
+            }
+            if( !enable_diagField ) {
+                WARNING( "DiagFields not reliable because of the patch arrangement !!!" );
+            }
+            
+            if( params.patch_arrangement=="morton" ) {
+                domain_decomposition = new MortonDomainDecomposition( params );
+            } else if( params.patch_arrangement=="peano" ) {
+                domain_decomposition = new PeanoDomainDecomposition( params );
+            } else {
+                domain_decomposition = new GeneralHilbertDomainDecomposition( params );
+            }
         } else {
         
             bool enable_diagField( true );
@@ -38,9 +38,10 @@ ElectroMagn::ElectroMagn( Params &params, DomainDecomposition *domain_decomposit
     nrj_new_fields( 0. )
 {
     n_space.resize( params.n_space.size() );
-    // Test if the patch is a small patch (Hilbert or Linearized are for VectorPatch)
+    // Test if the patch is a small patch (Hilbert, Linearized or Curve are for VectorPatch)
     if( ( dynamic_cast<HilbertDomainDecomposition *>( domain_decomposition ) )
-        || ( dynamic_cast<LinearizedDomainDecomposition *>( domain_decomposition ) ) ) {
+        || ( dynamic_cast<LinearizedDomainDecomposition *>( domain_decomposition ) )
+        || ( dynamic_cast<CurveDomainDecomposition *>( domain_decomposition ) ) ) {
         n_space = params.n_space;
     }
     else if ( dynamic_cast<RegionDomainDecomposition*>( domain_decomposition ) ) {
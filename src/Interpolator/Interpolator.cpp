@@ -12,3 +12,115 @@ Interpolator::Interpolator( Params &params, Patch *patch )
 {
 }
 
+
+
+void InterpolatorStencil::resize( unsigned int npoints, unsigned int ndim, unsigned int width )
+{
+    npoints_ = npoints;
+    ndim_ = ndim;
+    width_ = width;
+    for( unsigned int i=0; i<2; i++ ) {
+        first_[i].resize( npoints*ndim );
+        weights_[i].resize( npoints*ndim*width );
+    }
+}
+
+void InterpolatorStencil::set( unsigned int ipoint, unsigned int idim, int primal_center, int dual_center, double *primal_weights, double *dual_weights )
+{
+    unsigned int i = ipoint*ndim_ + idim;
+    int half = ( width_-1 )/2;
+    first_[0][i] = primal_center - half;
+    first_[1][i] = dual_center - half;
+    for( unsigned int iw=0; iw<width_; iw++ ) {
+        weights_[0][i*width_+iw] = primal_weights[iw];
+        weights_[1][i*width_+iw] = dual_weights[iw];
+    }
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Sparse product of the stencil and the field (the fields are stored in row-major order)
+// ---------------------------------------------------------------------------------------------------------------------
+void InterpolatorStencil::interpolate( Field *field, double *result )
+{
+    // The width is a template parameter so that the loops are unrolled as in the interpolators
+    if( ndim_ == 1 ) {
+        if( width_ == 3 ) {
+            interpolate1D<3>( field, result );
+        } else {
+            interpolate1D<5>( field, result );
+        }
+    } else if( ndim_ == 2 ) {
+        if( width_ == 3 ) {
+            interpolate2D<3>( field, result );
+        } else {
+            interpolate2D<5>( field, result );
+        }
+    } else {
+        if( width_ == 3 ) {
+            interpolate3D<3>( field, result );
+        } else {
+            interpolate3D<5>( field, result );
+        }
+    }
+}
+
+template<unsigned int W>
+void InterpolatorStencil::interpolate1D( Field *field, double *result )
+{
+    const double *data = field->data_;
+    unsigned int dx = field->isDual( 0 );
+    const int *first = &first_[dx][0];
+    const double *weights = &weights_[dx][0];
+    for( unsigned int ip=0; ip<npoints_; ip++ ) {
+        const double *cx = &weights[ip*W];
+        const double *f = &data[first[ip]];
+        double res = cx[0] * f[0];
+        for( unsigned int i=1; i<W; i++ ) {
+            res += cx[i] * f[i];
+        }
+        result[ip] = res;
+    }
+}
+
+template<unsigned int W>
+void InterpolatorStencil::interpolate2D( Field *field, double *result )
+{
+    const double *data = field->data_;
+    unsigned int dx = field->isDual( 0 ), dy = field->isDual( 1 );
+    unsigned int ny = field->dims_[1];
+    for( unsigned int ip=0; ip<npoints_; ip++ ) {
+        const double *cx = &weights_[dx][( ip*2 )*W];
+        const double *cy = &weights_[dy][( ip*2+1 )*W];
+        const double *f = &data[first_[dx][ip*2]*ny + first_[dy][ip*2+1]];
+        double res = 0.;
+        for( unsigned int i=0; i<W; i++ ) {
+            for( unsigned int j=0; j<W; j++ ) {
+                res += cx[i] * cy[j] * f[i*ny+j];
+            }
+        }
+        result[ip] = res;
+    }
+}
+
+template<unsigned int W>
+void InterpolatorStencil::interpolate3D( Field *field, double *result )
+{
+    const double *data = field->data_;
+    unsigned int dx = field->isDual( 0 ), dy = field->isDual( 1 ), dz = field->isDual( 2 );
+    unsigned int ny = field->dims_[1], nz = field->dims_[2];
+    for( unsigned int ip=0; ip<npoints_; ip++ ) {
+        const double *cx = &weights_[dx][( ip*3 )*W];
+        const double *cy = &weights_[dy][( ip*3+1 )*W];
+        const double *cz = &weights_[dz][( ip*3+2 )*W];
+        const double *f = &data[( first_[dx][ip*3]*ny + first_[dy][ip*3+1] )*nz + first_[dz][ip*3+2]];
+        double res = 0.;
+        for( unsigned int i=0; i<W; i++ ) {
+            for( unsigned int j=0; j<W; j++ ) {
+                for( unsigned int k=0; k<W; k++ ) {
+                    res += cx[i] * cy[j] * cz[k] * f[( i*ny+j )*nz+k];
+                }
+            }
+        }
+        result[ip] = res;
+    }
+}
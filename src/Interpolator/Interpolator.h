@@ -10,6 +10,54 @@ class ElectroMagn;
 class Particles;
 
 
+//  --------------------------------------------------------------------------------------------------------------------
+//! Class InterpolatorStencil: interpolation weights of a fixed set of points (such as probes)
+//
+//! The weights are the 1D shape coefficients along each dimension, on the primal and dual grids, so that any field
+//! can be interpolated at all points without recomputing the coefficients. The sums are done in the same order as
+//! in the interpolators, which gives the same results.
+//  --------------------------------------------------------------------------------------------------------------------
+class InterpolatorStencil
+{
+public:
+    InterpolatorStencil() : npoints_( 0 ), ndim_( 0 ), width_( 0 ) {};
+    
+    //! Allocates the stencil of npoints points, with width nodes along each of the ndim dimensions
+    void resize( unsigned int npoints, unsigned int ndim, unsigned int width );
+    
+    //! Sets the central nodes and the weights of one point along one dimension
+    void set( unsigned int ipoint, unsigned int idim, int primal_center, int dual_center, double *primal_weights, double *dual_weights );
+    
+    //! Interpolates the field at all points
+    void interpolate( Field *field, double *result );
+    
+    void clear()
+    {
+        npoints_ = 0;
+        for( unsigned int i=0; i<2; i++ ) {
+            first_[i].clear();
+            weights_[i].clear();
+        }
+    }
+    
+    bool empty()
+    {
+        return first_[0].empty();
+    }
+    
+private:
+    template<unsigned int W> void interpolate1D( Field *field, double *result );
+    template<unsigned int W> void interpolate2D( Field *field, double *result );
+    template<unsigned int W> void interpolate3D( Field *field, double *result );
+    
+    unsigned int npoints_, ndim_, width_;
+    //! First node of each point along each dimension, on the primal (0) and dual (1) grids
+    std::vector<int> first_[2];
+    //! Weights of each point along each dimension, on the primal (0) and dual (1) grids
+    std::vector<double> weights_[2];
+};
+
+
 //  --------------------------------------------------------------------------------------------------------------------
 //! Class Interpolator
 //  --------------------------------------------------------------------------------------------------------------------
@@ -24,6 +72,12 @@ public:
     virtual void fieldsSelection( ElectroMagn *EMfields, Particles &particles, double *buffer, int offset, std::vector<unsigned int> *selection ) = 0;
     virtual void oneField( Field **field, Particles &particles, int *istart, int *iend, double *FieldLoc, double *l1=NULL, double *l2=NULL, double *l3=NULL ) =0;
     
+    //! Computes the interpolation stencil of all particles (returns false if not available for this interpolator)
+    virtual bool stencil( Particles &particles, InterpolatorStencil &stencil )
+    {
+        return false;
+    };
+    
     virtual void fieldsAndEnvelope( ElectroMagn *EMfields, Particles &particles, SmileiMPI *smpi, int *istart, int *iend, int ithread, int ipart_ref = 0 )
     {
         ERROR( "Envelope not implemented with this geometry and this order" );
@@ -120,6 +120,18 @@ void Interpolator1D4Order::oneField( Field **field, Particles &particles, int *i
     }
 }
 
+// Interpolation stencil of fixed points (probes)
+bool Interpolator1D4Order::stencil( Particles &particles, InterpolatorStencil &stencil )
+{
+    stencil.resize( particles.size(), 1, 5 );
+    for( unsigned int ipart=0 ; ipart<particles.size(); ipart++ ) {
+        double xjn = particles.position( 0, ipart )*dx_inv_;
+        coeffs( xjn );
+        stencil.set( ipart, 0, ip_, id_, coeffp_, coeffd_ );
+    }
+    return true;
+}
+
 void Interpolator1D4Order::fieldsWrapper( ElectroMagn *EMfields, Particles &particles, SmileiMPI *smpi, int *istart, int *iend, int ithread, int ipart_ref )
 {
     std::vector<double> *Epart = &( smpi->dynamics_Epart[ithread] );
@@ -124,6 +124,20 @@ void Interpolator2D2Order::oneField( Field **field, Particles &particles, int *i
     }
 }
 
+// Interpolation stencil of fixed points (probes)
+bool Interpolator2D2Order::stencil( Particles &particles, InterpolatorStencil &stencil )
+{
+    stencil.resize( particles.size(), 2, 3 );
+    for( unsigned int ipart=0 ; ipart<particles.size(); ipart++ ) {
+        double xpn = particles.position( 0, ipart )*dx_inv_;
+        double ypn = particles.position( 1, ipart )*dy_inv_;
+        coeffs( xpn, ypn );
+        stencil.set( ipart, 0, ip_, id_, coeffxp_, coeffxd_ );
+        stencil.set( ipart, 1, jp_, jd_, coeffyp_, coeffyd_ );
+    }
+    return true;
+}
+
 void Interpolator2D2Order::fieldsWrapper( ElectroMagn *EMfields, Particles &particles, SmileiMPI *smpi, int *istart, int *iend, int ithread, int ipart_ref )
 {
     std::vector<double> *Epart = &( smpi->dynamics_Epart[ithread] );
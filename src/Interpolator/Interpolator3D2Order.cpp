@@ -130,6 +130,22 @@ void Interpolator3D2Order::oneField( Field **field, Particles &particles, int *i
     }
 }
 
+// Interpolation stencil of fixed points (probes)
+bool Interpolator3D2Order::stencil( Particles &particles, InterpolatorStencil &stencil )
+{
+    stencil.resize( particles.size(), 3, 3 );
+    for( unsigned int ipart=0 ; ipart<particles.size(); ipart++ ) {
+        double xpn = particles.position( 0, ipart )*dx_inv_;
+        double ypn = particles.position( 1, ipart )*dy_inv_;
+        double zpn = particles.position( 2, ipart )*dz_inv_;
+        coeffs( xpn, ypn, zpn );
+        stencil.set( ipart, 0, ip_, id_, coeffxp_, coeffxd_ );
+        stencil.set( ipart, 1, jp_, jd_, coeffyp_, coeffyd_ );
+        stencil.set( ipart, 2, kp_, kd_, coeffzp_, coeffzd_ );
+    }
+    return true;
+}
+
 void Interpolator3D2Order::fieldsWrapper( ElectroMagn *EMfields, Particles &particles, SmileiMPI *smpi, int *istart, int *iend, int ithread, int ipart_ref )
 {
     double *ELoc = &( smpi->dynamics_Epart[ithread][0] );
@@ -1,6 +1,7 @@
 #include "IonizationFromRate.h"
 
 #include <cmath>
+#include <algorithm>
 
 #include "Particles.h"
 #include "ParticleData.h"
@@ -8,6 +9,8 @@
 
 using namespace std;
 
+// Names of the particle attributes that the axes of a rate table can use
+static const vector<string> rate_table_attributes = { "x", "y", "z", "px", "py", "pz", "E" };
 
 
 IonizationFromRate::IonizationFromRate( Params &params, Species *species ) : Ionization( params, species )
@@ -18,6 +21,30 @@ IonizationFromRate::IonizationFromRate( Params &params, Species *species ) : Ion
     maximum_charge_state_ = species->maximum_charge_state_;
     ionization_rate_ = species->ionization_rate_;
     
+    // Rates sampled at initialization
+    table_ = NULL;
+    charge_stride_ = 1;
+#ifdef SMILEI_USE_NUMPY
+    if( species->ionization_rate_table_ != Py_None ) {
+        table_ = ( double * ) PyArray_DATA( ( PyArrayObject * ) species->ionization_rate_table_ );
+        unsigned int naxes = species->ionization_rate_axes_.size();
+        axis_attribute_.resize( naxes );
+        axis_min_      .resize( naxes );
+        axis_inv_delta_.resize( naxes );
+        axis_size_     .resize( naxes );
+        axis_stride_   .resize( naxes );
+        for( int a=naxes-1; a>=0; a-- ) {
+            vector<double> &range = species->ionization_rate_ranges_[a];
+            axis_attribute_[a] = find( rate_table_attributes.begin(), rate_table_attributes.end(), species->ionization_rate_axes_[a] ) - rate_table_attributes.begin();
+            axis_min_      [a] = range[0];
+            axis_size_     [a] = ( int ) range[2];
+            axis_inv_delta_[a] = ( axis_size_[a]-1 ) / ( range[1]-range[0] );
+            axis_stride_   [a] = charge_stride_;
+            charge_stride_ *= axis_size_[a];
+        }
+    }
+#endif
+    
     DEBUG( "Finished Creating the FromRate Ionizaton class" );
     
 }
@@ -29,34 +56,40 @@ void IonizationFromRate::operator()( Particles *particles, unsigned int ipart_mi
 
     //unsigned int Z, Zp1, newZ, k_times;
     unsigned int Z, k_times;
-    vector<double> rate;
+    vector<double> &rate = rate_;
     
     // Leave if nothing to do
     if( ipart_min >= ipart_max ) {
         return;
     }
     
+    unsigned int npart = ipart_max - ipart_min;
+    if( table_ ) {
+        // Interpolate the rates sampled at initialization
+        interpolateRate( particles, ipart_min, npart, Epart, ipart_ref );
+    }
 #ifdef SMILEI_USE_NUMPY
     // Run python to evaluate the ionization rate for each particle
-    PyArrayObject *ret;
-    unsigned int npart = ipart_max - ipart_min;
-    #pragma omp critical
-    {
-        ParticleData particleData( npart );
-        particleData.startAt( ipart_min );
-        particleData.set( particles );
-        ret = ( PyArrayObject * )PyObject_CallFunctionObjArgs( ionization_rate_, particleData.get(), NULL );
-        PyTools::checkPyError();
-        if( ret == NULL ) {
-            ERROR( "ionization_rate profile has not provided a correct result" );
-        }
-        double *arr = ( double * ) PyArray_GETPTR1( ret, 0 );
-        rate.resize( npart );
-        // Loop the return value and store
-        for( unsigned int i=0; i<npart; i++ ) {
-            rate[i] = arr[i];
+    else {
+        PyArrayObject *ret;
+        #pragma omp critical
+        {
+            ParticleData particleData( npart );
+            particleData.startAt( ipart_min );
+            particleData.set( particles );
+            ret = ( PyArrayObject * )PyObject_CallFunctionObjArgs( ionization_rate_, particleData.get(), NULL );
+            PyTools::checkPyError();
+            if( ret == NULL ) {
+                ERROR( "ionization_rate profile has not provided a correct result" );
+            }
+            double *arr = ( double * ) PyArray_GETPTR1( ret, 0 );
+            rate.resize( npart );
+            // Loop the return value and store
+            for( unsigned int i=0; i<npart; i++ ) {
+                rate[i] = arr[i];
+            }
+            Py_DECREF( ret );
         }
-        Py_DECREF( ret );
     }
 #endif
     
@@ -102,3 +135,139 @@ void IonizationFromRate::operator()( Particles *particles, unsigned int ipart_mi
         
     } // Loop on particles
 }
+
+
+void IonizationFromRate::interpolateRate( Particles *particles, unsigned int ipart_min, unsigned int npart, vector<double> *Epart, int ipart_ref )
+{
+    const unsigned int naxes = axis_size_.size();
+    rate_    .resize( npart );
+    index_   .resize( npart );
+    fraction_.resize( naxes*npart );
+    unsigned int *index = &index_[0];
+    double *rate = &rate_[0];
+    
+    // Cell of the table containing each particle: charge state first
+    short *charge = &( particles->charge( ipart_min ) );
+    const short Zmax = maximum_charge_state_-1;
+    const unsigned int charge_stride = charge_stride_;
+    #pragma omp simd
+    for( unsigned int k=0; k<npart; k++ ) {
+        short Z = min( charge[k], Zmax );
+        index[k] = Z * charge_stride;
+    }
+    
+    // Then each axis
+    for( unsigned int a=0; a<naxes; a++ ) {
+        const double *value;
+        if( axis_attribute_[a] < 3 ) {
+            value = &( particles->position( axis_attribute_[a], ipart_min ) );
+        } else if( axis_attribute_[a] < 6 ) {
+            value = &( particles->momentum( axis_attribute_[a]-3, ipart_min ) );
+        } else {
+            int nparts = Epart->size()/3;
+            double *Ex = &( ( *Epart )[0*nparts + ipart_min-ipart_ref] );
+            double *Ey = &( ( *Epart )[1*nparts + ipart_min-ipart_ref] );
+            double *Ez = &( ( *Epart )[2*nparts + ipart_min-ipart_ref] );
+            field_.resize( npart );
+            double *field = &field_[0];
+            #pragma omp simd
+            for( unsigned int k=0; k<npart; k++ ) {
+                field[k] = sqrt( Ex[k]*Ex[k] + Ey[k]*Ey[k] + Ez[k]*Ez[k] );
+            }
+            value = field;
+        }
+        const double min = axis_min_[a], inv_delta = axis_inv_delta_[a];
+        const double last = axis_size_[a]-1;
+        const unsigned int stride = axis_stride_[a];
+        double *fraction = &fraction_[a*npart];
+        // Values outside the axis take the rate of its edges
+        #pragma omp simd
+        for( unsigned int k=0; k<npart; k++ ) {
+            double t = std::max( 0., std::min( last, ( value[k]-min )*inv_delta ) );
+            double i = std::min( floor( t ), last-1. );
+            index[k] += ( unsigned int ) i * stride;
+            fraction[k] = t - i;
+        }
+    }
+    
+    // Multilinear interpolation: sum over the 2^naxes corners of the cell
+    #pragma omp simd
+    for( unsigned int k=0; k<npart; k++ ) {
+        rate[k] = 0.;
+    }
+    const double *table = table_;
+    const double *fraction = &fraction_[0];
+    for( unsigned int corner=0; corner < ( 1u<<naxes ); corner++ ) {
+        unsigned int offset = 0;
+        for( unsigned int a=0; a<naxes; a++ ) {
+            if( ( corner>>a ) & 1 ) {
+                offset += axis_stride_[a];
+            }
+        }
+        #pragma omp simd
+        for( unsigned int k=0; k<npart; k++ ) {
+            double w = 1.;
+            for( unsigned int a=0; a<naxes; a++ ) {
+                double f = fraction[a*npart+k];
+                w *= ( ( corner>>a ) & 1 ) ? f : 1.-f;
+            }
+            rate[k] += w * table[index[k] + offset];
+        }
+    }
+}
+
+
+PyObject *IonizationFromRate::sampleRate( Species *species, unsigned int nDim_particle )
+{
+#ifdef SMILEI_USE_NUMPY
+    vector<string> &axes = species->ionization_rate_axes_;
+    vector<vector<double> > &ranges = species->ionization_rate_ranges_;
+    
+    // One fake particle per grid point and per charge state
+    unsigned int npoints = species->maximum_charge_state_;
+    for( unsigned int a=0; a<axes.size(); a++ ) {
+        npoints *= ( unsigned int ) ranges[a][2];
+    }
+    vector<vector<double> > values( rate_table_attributes.size(), vector<double>( npoints, 0. ) );
+    vector<double> weight( npoints, 1. );
+    vector<short> charge( npoints );
+    vector<uint64_t> id( npoints, 0 );
+    for( unsigned int ip=0; ip<npoints; ip++ ) {
+        unsigned int i = ip;
+        for( int a=axes.size()-1; a>=0; a-- ) {
+            unsigned int n = ranges[a][2];
+            unsigned int attribute = find( rate_table_attributes.begin(), rate_table_attributes.end(), axes[a] ) - rate_table_attributes.begin();
+            values[attribute][ip] = ranges[a][0] + ( i%n ) * ( ranges[a][1]-ranges[a][0] ) / ( n-1 );
+            i /= n;
+        }
+        charge[ip] = i;
+    }
+    
+    // Single call to the python function
+    ParticleData particleData( npoints );
+    for( unsigned int i=0; i<rate_table_attributes.size(); i++ ) {
+        if( i < 3 && i >= nDim_particle ) {
+            continue;
+        }
+        particleData.setVectorAttr( values[i], rate_table_attributes[i] );
+    }
+    particleData.setVectorAttr( weight, "weight" );
+    particleData.setVectorAttr( charge, "charge" );
+    particleData.setVectorAttr( id, "id" );
+    PyObject *ret = PyObject_CallFunctionObjArgs( species->ionization_rate_, particleData.get(), NULL );
+    PyTools::checkPyError();
+    if( !ret || !PyArray_Check( ret ) || !PyArray_ISFLOAT( ( PyArrayObject * ) ret ) ) {
+        ERROR( "For species '" << species->name_ << "': ionization_rate must return a numpy array of floats" );
+    }
+    if( PyArray_SIZE( ( PyArrayObject * ) ret ) != npoints ) {
+        ERROR( "For species '" << species->name_ << "': ionization_rate must not change the arrays sizes" );
+    }
+    
+    // Own a contiguous copy, as the result may be a view of the fake particles
+    PyObject *table = PyArray_FROM_OTF( ret, NPY_DOUBLE, NPY_ARRAY_IN_ARRAY | NPY_ARRAY_ENSURECOPY );
+    Py_DECREF( ret );
+    return table;
+#else
+    return Py_None;
+#endif
+}
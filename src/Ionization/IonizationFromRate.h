@@ -21,12 +21,41 @@ public:
     //! apply the FromRate Ionization model to the species
     void operator()( Particles *, unsigned int, unsigned int, std::vector<double> *, Patch *, Projector *, int ipart_ref = 0 ) override;
     
+    //! Sample the user-defined ionization rate of a species on the grid
+    //! defined by its ionization_rate_table axes, for all charge states
+    //! \return contiguous numpy array of the rates, the charge state being the slowest index
+    static PyObject *sampleRate( Species *species, unsigned int nDim_particle );
+    
 private:
 
     int itime;
     unsigned int maximum_charge_state_;
     PyObject *ionization_rate_;
     
+    //! Rate interpolated from the table of the species, without calling python
+    void interpolateRate( Particles *particles, unsigned int ipart_min, unsigned int npart, std::vector<double> *Epart, int ipart_ref );
+    
+    //! Rates sampled at initialization (NULL if the python function is called at each step)
+    double *table_;
+    //! Particle attribute of each axis of the table: 0-2 position, 3-5 momentum, 6 field amplitude
+    std::vector<int> axis_attribute_;
+    //! Minimum, inverse step, number of points and stride of each axis of the table
+    std::vector<double> axis_min_;
+    std::vector<double> axis_inv_delta_;
+    std::vector<int> axis_size_;
+    std::vector<unsigned int> axis_stride_;
+    //! Stride of the charge state in the table
+    unsigned int charge_stride_;
+    
+    //! Rate of each particle
+    std::vector<double> rate_;
+    //! Index in the table of the lower corner of the cell of each particle
+    std::vector<unsigned int> index_;
+    //! Position of each particle inside its cell, along each axis
+    std::vector<double> fraction_;
+    //! Field amplitude of each particle, when the table depends on it
+    std::vector<double> field_;
+    
 };
 
 
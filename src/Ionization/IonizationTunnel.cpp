@@ -2,6 +2,7 @@
 #include "IonizationTables.h"
 
 #include <cmath>
+#include <algorithm>
 
 #include "Particles.h"
 #include "Species.h"
@@ -42,6 +43,8 @@ IonizationTunnel::IonizationTunnel( Params &params, Species *species ) : Ionizat
         gamma_tunnel[Z] = 2.0 * pow( 2.0*Potential[Z], 1.5 );
     }
     
+    rate_table_.set( beta_tunnel, alpha_tunnel, gamma_tunnel, dt );
+    
     DEBUG( "Finished Creating the Tunnel Ionizaton class" );
     
 }
@@ -62,23 +65,54 @@ void IonizationTunnel::operator()( Particles *particles, unsigned int ipart_min,
     double *Ey = &( ( *Epart )[1*nparts] );
     double *Ez = &( ( *Epart )[2*nparts] );
     
-    for( unsigned int ipart=ipart_min ; ipart<ipart_max; ipart++ ) {
+    // Buffers (reused between calls as this operator is called for each cell)
+    if( ipart_max <= ipart_min ) {
+        return;
+    }
+    unsigned int n = ipart_max-ipart_min;
+    if( ran_.size() < n ) {
+        ran_.resize( n );
+        selected_.resize( n );
+    }
+    double *ran = &ran_[0];
+    int *selected = &selected_[0];
     
-        // Current charge state of the ion
-        Z = ( unsigned int )( particles->charge( ipart ) );
-        
-        // If ion already fully ionized then skip
-        if( Z==atomic_number_ ) {
+    // Random numbers of all the particles
+    patch->rand_->uniform( ran, n );
+    
+    // Vectorized selection of the particles which may be ionized: the probability
+    // of the first ionization 1-exp(-W*dt) is below W*dt, which is below the
+    // tabulated bound. The other particles are not ionized, whatever the exact rate.
+    short *charge = &( particles->charge( 0 ) );
+    const int Zmax = atomic_number_;
+    const double EC_to_au_sq = EC_to_au*EC_to_au;
+    #pragma omp simd
+    for( unsigned int k=0 ; k<n; k++ ) {
+        int ipart = ipart_min+k;
+        int Zk = charge[ipart];
+        double E_sq = EC_to_au_sq * ( Ex[ipart-ipart_ref]*Ex[ipart-ipart_ref]
+                                      + Ey[ipart-ipart_ref]*Ey[ipart-ipart_ref]
+                                      + Ez[ipart-ipart_ref]*Ez[ipart-ipart_ref] );
+        double m = std::min( ran[k], 1.-ran[k] );
+        selected[k] = ( Zk < Zmax ) && ( E_sq >= 1e-20 )
+                      && ( m < rate_table_.bound( std::min( Zk, Zmax-1 ), E_sq ) );
+    }
+    
+    // Exact computation for the selected particles
+    for( unsigned int k=0 ; k<n; k++ ) {
+    
+        if( !selected[k] ) {
             continue;
         }
+        unsigned int ipart = ipart_min+k;
+    
+        // Current charge state of the ion
+        Z = ( unsigned int )( particles->charge( ipart ) );
         
         // Absolute value of the electric field normalized in atomic units
         E = EC_to_au * sqrt( pow( *( Ex+ipart-ipart_ref ), 2 )
                              +pow( *( Ey+ipart-ipart_ref ), 2 )
                              +pow( *( Ez+ipart-ipart_ref ), 2 ) );
-        if( E<1e-10 ) {
-            continue;
-        }
         
         // --------------------------------
         // Start of the Monte-Carlo routine
@@ -87,7 +121,7 @@ void IonizationTunnel::operator()( Particles *particles, unsigned int ipart_min,
         invE = 1./E;
         factorJion = factorJion_0 * invE*invE;
         delta      = gamma_tunnel[Z]*invE;
-        ran_p = patch->rand_->uniform();
+        ran_p = ran[k];
         IonizRate_tunnel[Z] = beta_tunnel[Z] * exp( -delta*one_third + alpha_tunnel[Z]*log( delta ) );
         
         // Total ionization potential (used to compute the ionization current)
@@ -2,6 +2,7 @@
 #include "IonizationTables.h"
 
 #include <cmath>
+#include <algorithm>
 
 #include "Particles.h"
 #include "Species.h"
@@ -49,6 +50,20 @@ IonizationTunnelEnvelopeAveraged::IonizationTunnelEnvelopeAveraged( Params &para
     cos_phi             = cos(params.envelope_polarization_phi);
     sin_phi             = sin(params.envelope_polarization_phi);
     
+    // The rate averaged over a linear polarization is multiplied by
+    // sqrt( (3/pi)/delta*2 ), which changes beta and alpha in the table
+    vector<double> beta_table( atomic_number_ ), alpha_table( atomic_number_ ), gamma_table( atomic_number_ );
+    for( unsigned int Z=0 ; Z<atomic_number_ ; Z++ ) {
+        beta_table[Z]  = beta_tunnel[Z];
+        alpha_table[Z] = alpha_tunnel[Z];
+        gamma_table[Z] = gamma_tunnel[Z];
+        if( ellipticity==0. ) {
+            beta_table[Z]  *= sqrt( 6./M_PI );
+            alpha_table[Z] -= 0.5;
+        }
+    }
+    rate_table_.set( beta_table, alpha_table, gamma_table, dt );
+    
     DEBUG( "Finished Creating the Tunnel Envelope Ionizaton Averaged class" );
     
 }
@@ -76,16 +91,50 @@ void IonizationTunnelEnvelopeAveraged::envelopeIonization( Particles *particles,
     double *Ex_env  = &( ( *EnvExabs_part )[0*nparts] );
     double *Phi_env = &( ( *Phipart )[0*nparts] );
     
-    for( unsigned int ipart=ipart_min ; ipart<ipart_max; ipart++ ) {
+    // Buffers (reused between calls as this operator is called for each cell)
+    if( ipart_max <= ipart_min ) {
+        return;
+    }
+    unsigned int n = ipart_max-ipart_min;
+    if( ran_.size() < n ) {
+        ran_.resize( n );
+        selected_.resize( n );
+    }
+    double *ran = &ran_[0];
+    int *selected = &selected_[0];
     
-        // Current charge state of the ion
-        Z = ( unsigned int )( particles->charge( ipart ) );
+    // Random numbers of all the particles
+    patch->rand_->uniform( ran, n );
     
-        // If ion already fully ionized then skip
-        if( Z==atomic_number_ ) {
+    // Vectorized selection of the particles which may be ionized
+    // (see IonizationTunnelRateTable.h)
+    short *charge = &( particles->charge( 0 ) );
+    const int Zmax = atomic_number_;
+    const double EC_to_au_sq = EC_to_au*EC_to_au;
+    #pragma omp simd
+    for( unsigned int k=0 ; k<n; k++ ) {
+        int ipart = ipart_min+k;
+        int Zk = charge[ipart];
+        double E_sq = EC_to_au_sq * ( Ex[ipart-ipart_ref]*Ex[ipart-ipart_ref]
+                                      + Ey[ipart-ipart_ref]*Ey[ipart-ipart_ref]
+                                      + Ez[ipart-ipart_ref]*Ez[ipart-ipart_ref]
+                                      + E_env[ipart-ipart_ref]*E_env[ipart-ipart_ref]
+                                      + Ex_env[ipart-ipart_ref]*Ex_env[ipart-ipart_ref] );
+        double m = std::min( ran[k], 1.-ran[k] );
+        selected[k] = ( Zk < Zmax ) && ( E_sq >= 1e-20 )
+                      && ( m < rate_table_.bound( std::min( Zk, Zmax-1 ), E_sq ) );
+    }
+    
+    // Exact computation for the selected particles
+    for( unsigned int k=0 ; k<n; k++ ) {
+    
+        if( !selected[k] ) {
             continue;
         }
+        unsigned int ipart = ipart_min+k;
     
+        // Current charge state of the ion
+        Z = ( unsigned int )( particles->charge( ipart ) );
     
         // Absolute value of the electric field |E_plasma| (from the plasma) normalized in atomic units
         E_sq    = pow(EC_to_au,2) * (pow( *( Ex+ipart-ipart_ref ), 2 )
@@ -100,17 +149,13 @@ void IonizationTunnelEnvelopeAveraged::envelopeIonization( Particles *particles,
         // |E| = sqrt(|E_plasma|^2+|E_envelope|^2)
         E = sqrt(E_sq+EnvE_sq);
     
-        if( E<1e-10 ) {
-            continue;
-        }
-    
         // --------------------------------
         // Start of the Monte-Carlo routine
         // --------------------------------
     
         invE = 1./E;
         delta      = gamma_tunnel[Z]*invE; // 2*(2I_p)^{3/2}/E
-        ran_p = patch->rand_->uniform();
+        ran_p = ran[k];
         IonizRate_tunnel_envelope[Z] = beta_tunnel[Z] * exp( -delta*one_third + alpha_tunnel[Z]*log( delta ) );
     
         // Corrections on averaged ionization rate given by the polarization ellipticity  
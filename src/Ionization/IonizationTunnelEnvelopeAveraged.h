@@ -6,6 +6,7 @@
 #include <vector>
 
 #include "Ionization.h"
+#include "IonizationTunnelRateTable.h"
 #include "Tools.h"
 
 
@@ -33,6 +34,13 @@ private:
     
     double one_third;
     std::vector<double> alpha_tunnel, beta_tunnel, gamma_tunnel,Ip_times2_to_minus3ov4;
+    
+    //! Bounds of the ionization probabilities, to select the particles which may be ionized
+    IonizationTunnelRateTable rate_table_;
+    
+    //! Buffers for the particles of the current call: random numbers and selection
+    std::vector<double> ran_;
+    std::vector<int> selected_;
 };
 
 
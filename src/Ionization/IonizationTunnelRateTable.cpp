@@ -0,0 +1,35 @@
+#include "IonizationTunnelRateTable.h"
+
+#include <algorithm>
+
+// Field grid (atomic units): 32 points per decade from 1e-3 to 1e4.
+// Below 1e-3 au the rates are negligible for all elements, and the particles
+// in fields above 1e4 au always go through the exact computation.
+void IonizationTunnelRateTable::set( const std::vector<double> &beta, const std::vector<double> &alpha,
+                                     const std::vector<double> &gamma, double dt )
+{
+    const int points_per_decade = 32;
+    const double log10_max = 4.;
+    log10_min_ = -3.;
+    inv_delta_ = points_per_decade;
+    int npoints = int( ( log10_max-log10_min_ )*points_per_decade ) + 1;
+    size_ = npoints;
+
+    // Relative margin for the rounding errors of the exact computation
+    const double margin = 1.+1e-6;
+
+    unsigned int nZ = beta.size();
+    bound_.resize( nZ*size_ );
+    for( unsigned int Z=0; Z<nZ; Z++ ) {
+        for( int i=0; i<size_; i++ ) {
+            // The interval [E_{i-1}, E_i] is [delta_i, delta_{i-1}] in delta
+            double delta_min = gamma[Z] / std::pow( 10., log10_min_ + i/inv_delta_ );
+            double delta_max = i > 0 ? gamma[Z] / std::pow( 10., log10_min_ + ( i-1 )/inv_delta_ )
+                               : std::numeric_limits<double>::max();
+            // log(W) = log(beta) + alpha*log(delta) - delta/3 is maximum at delta = 3*alpha
+            // (or decreasing if alpha <= 0)
+            double delta = std::min( std::max( 3.*alpha[Z], delta_min ), delta_max );
+            bound_[Z*size_+i] = margin * dt * beta[Z] * std::exp( -delta/3. + alpha[Z]*std::log( delta ) );
+        }
+    }
+}
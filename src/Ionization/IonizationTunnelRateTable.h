@@ -0,0 +1,59 @@
+// ----------------------------------------------------------------------------
+//! \file IonizationTunnelRateTable.h
+//
+//! \brief Tabulated bounds of the tunnel ionization rates
+//
+//! \details The tunnel ionization rates of the form
+//! W_Z(E) = beta_Z * delta^alpha_Z * exp(-delta/3), with delta = gamma_Z/E,
+//! are tabulated at initialization for each charge state Z on a log grid of
+//! the field E (in atomic units). Each interval of the grid stores an upper
+//! bound of W_Z*dt on this interval. As the ionization probability
+//! 1-exp(-W_Z*dt) is below W_Z*dt, a particle with a random number above
+//! the bound cannot be ionized: this test selects, in a vectorized loop,
+//! the few particles for which the exact (multiple) ionization is computed.
+// ----------------------------------------------------------------------------
+
+#ifndef IONIZATIONTUNNELRATETABLE_H
+#define IONIZATIONTUNNELRATETABLE_H
+
+#include <vector>
+#include <cmath>
+#include <limits>
+
+class IonizationTunnelRateTable
+{
+public:
+    IonizationTunnelRateTable() : size_( 0 ) {};
+    ~IonizationTunnelRateTable() {};
+
+    //! Compute the bounds of the rates beta[Z] * delta^alpha[Z] * exp(-delta/3)
+    //! with delta = gamma[Z]/E, multiplied by dt, for all charge states Z
+    void set( const std::vector<double> &beta, const std::vector<double> &alpha,
+              const std::vector<double> &gamma, double dt );
+
+    //! Upper bound of W_Z(E)*dt, from the square of the field E_sq (atomic units).
+    //! Above the grid, the bound is infinite.
+    #pragma omp declare simd
+    inline double bound( int Z, double E_sq ) const
+    {
+        double t = ( 0.5*std::log10( E_sq ) - log10_min_ ) * inv_delta_;
+        // Interval 0 is below the grid, interval i>0 is [E_{i-1}, E_i]
+        int i = int( std::floor( t ) ) + 1;
+        i = i < 0 ? 0 : i;
+        int j = i < size_ ? i : size_-1;
+        double b = bound_[Z*size_ + j];
+        return i < size_ ? b : std::numeric_limits<double>::infinity();
+    }
+
+private:
+    //! Bounds of each interval, for each charge state
+    std::vector<double> bound_;
+    //! Number of intervals of each charge state (including the one below the grid)
+    int size_;
+    //! log10 of the first point of the grid
+    double log10_min_;
+    //! Inverse of the log10 step
+    double inv_delta_;
+};
+
+#endif
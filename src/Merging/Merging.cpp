@@ -32,3 +32,56 @@ Merging::Merging( Params &params, Species *species, Random * rand )
 Merging::~Merging()
 {
 }
+
+// -----------------------------------------------------------------------------
+//! Sort the particles of a cell by momentum cell (counting sort)
+//! \param number_of_particles number of particles in the cell
+//! \param momentum_cells      number of momentum cells
+//! \param istart              index of the first particle of the cell
+// -----------------------------------------------------------------------------
+void Merging::sortByMomentumCell( unsigned int number_of_particles,
+                                  unsigned int momentum_cells,
+                                  int istart )
+{
+    sorted_particles_.resize( number_of_particles );
+    particles_per_momentum_cells_.resize( momentum_cells );
+    momentum_cell_particle_index_.resize( momentum_cells );
+    
+    unsigned int * __restrict__ momentum_cell_index = &momentum_cell_index_[0];
+    unsigned int * __restrict__ sorted_particles = &sorted_particles_[0];
+    unsigned int * __restrict__ particles_per_momentum_cells = &particles_per_momentum_cells_[0];
+    unsigned int * __restrict__ momentum_cell_particle_index = &momentum_cell_particle_index_[0];
+    
+    #pragma omp simd
+    for( unsigned int ic = 0 ; ic < momentum_cells ; ic++ ) {
+        particles_per_momentum_cells[ic] = 0;
+    }
+    
+    // Number of particles per momentum cell
+    for( unsigned int ipr = 0 ; ipr < number_of_particles ; ipr++ ) {
+        particles_per_momentum_cells[momentum_cell_index[ipr]] += 1;
+    }
+    
+    // First index of each momentum cell (exclusive prefix sum)
+    unsigned int index = 0;
+    for( unsigned int ic = 0 ; ic < momentum_cells ; ic++ ) {
+        momentum_cell_particle_index[ic] = index;
+        index += particles_per_momentum_cells[ic];
+    }
+    
+    // Stable placement of the particles: momentum_cell_index is reused
+    // to store the position of each particle in the sorted array
+    for( unsigned int ipr = 0 ; ipr < number_of_particles ; ipr++ ) {
+        unsigned int ic = momentum_cell_index[ipr];
+        momentum_cell_index[ipr] = momentum_cell_particle_index[ic];
+        momentum_cell_particle_index[ic] += 1;
+    }
+    #pragma omp simd
+    for( unsigned int ipr = 0 ; ipr < number_of_particles ; ipr++ ) {
+        sorted_particles[momentum_cell_index[ipr]] = istart + ipr;
+    }
+    #pragma omp simd
+    for( unsigned int ic = 0 ; ic < momentum_cells ; ic++ ) {
+        momentum_cell_particle_index[ic] -= particles_per_momentum_cells[ic];
+    }
+}
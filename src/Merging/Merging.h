@@ -53,6 +53,31 @@ protected:
     // Minimum number of particles per cell to process the merging
     unsigned int min_particles_per_cell_;
     
+    //! Sort the particles of a cell by momentum cell (counting sort)
+    //! from momentum_cell_index_. On output, the particles of the momentum
+    //! cell ic are sorted_particles_[momentum_cell_particle_index_[ic] + i]
+    //! for i < particles_per_momentum_cells_[ic].
+    //! \param number_of_particles number of particles in the cell
+    //! \param momentum_cells      number of momentum cells
+    //! \param istart              index of the first particle of the cell
+    void sortByMomentumCell( unsigned int number_of_particles,
+                             unsigned int momentum_cells,
+                             int istart );
+    
+    // Workspaces, kept from one cell to the next to avoid allocations
+    
+    // Momentum cell index of each particle
+    std::vector <unsigned int> momentum_cell_index_;
+    
+    // Particle indexes sorted by momentum cell
+    std::vector <unsigned int> sorted_particles_;
+    
+    // Number of particles per momentum cell
+    std::vector <unsigned int> particles_per_momentum_cells_;
+    
+    // First index of each momentum cell in sorted_particles_
+    std::vector <unsigned int> momentum_cell_particle_index_;
+    
 private:
     
 };
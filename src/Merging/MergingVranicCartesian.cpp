@@ -155,15 +155,17 @@ void MergingVranicCartesian::operator() (
         // int *cell_keys = &( particles.cell_keys[0] );
 
         // Local vector to store the momentum index in the momentum discretization
-        std::vector <unsigned int> momentum_cell_index(number_of_particles,0);
+        std::vector <unsigned int> &momentum_cell_index = momentum_cell_index_;
+        momentum_cell_index.resize( number_of_particles );
 //         unsigned int  * momentum_cell_index = (unsigned int*) aligned_alloc(64, number_of_particles*sizeof(unsigned int));
 
         // Sorted array of particle index
-        std::vector <unsigned int> sorted_particles(number_of_particles,0);
+        std::vector <unsigned int> &sorted_particles = sorted_particles_;
 //         unsigned int  * sorted_particles = (unsigned int*) aligned_alloc(64, number_of_particles*sizeof(unsigned int));
 
         // Particle gamma factor
-        std::vector <double> gamma(number_of_particles,0);
+        std::vector <double> &gamma = gamma_;
+        gamma.resize( number_of_particles );
 //         double  * gamma = (double*) aligned_alloc(64, number_of_particles*sizeof(double));
 
         // Computation of the particle gamma factor
@@ -356,12 +358,12 @@ void MergingVranicCartesian::operator() (
                                     * dim[2];
 
         // Array containing the number of particles per momentum cells
-        std::vector <unsigned int> particles_per_momentum_cells(momentum_cells,0);
+        std::vector <unsigned int> &particles_per_momentum_cells = particles_per_momentum_cells_;
 //         unsigned int  * particles_per_momentum_cells = (unsigned int*) aligned_alloc(64, momentum_cells*sizeof(unsigned int));
 
         // Array containing the first particle index of each momentum cell
         // in the sorted particle array
-        std::vector <unsigned int> momentum_cell_particle_index(momentum_cells,0);
+        std::vector <unsigned int> &momentum_cell_particle_index = momentum_cell_particle_index_;
 //         unsigned int  * momentum_cell_particle_index = (unsigned int*) aligned_alloc(64, momentum_cells*sizeof(unsigned int));
 //
 //         // Initialization when using aligned_alloc
@@ -406,45 +408,8 @@ void MergingVranicCartesian::operator() (
 
         }
 
-        // std::cerr << "number of particles per momentum cells" << std::endl;
-
-        // The number of particles per momentum cells
-        // is then determined.
-        // No vectorization because of random memory accesses
-        for (ipr=0; ipr<number_of_particles; ipr++ ) {
-            // Number of particles per momentum cells
-            particles_per_momentum_cells[momentum_cell_index[ipr]] += 1;
-        }
-
-        // std::cerr << "Computation of the cell index" << std::endl;
-
-        // Computation of the cell index in the sorted array of particles
-        for (ic = 1 ; ic < momentum_cells ; ic++) {
-            momentum_cell_particle_index[ic]  = momentum_cell_particle_index[ic-1] + particles_per_momentum_cells[ic-1];
-            particles_per_momentum_cells[ic-1] = 0;
-        }
-        particles_per_momentum_cells[momentum_cells-1] = 0;
-
-        // std::cerr << "sort particles in correct bins" << std::endl;
-
-        // sort particles in correct bins according to their
-        // momentum properties
-        // Not vectorizable
-        for (ipr=0 ; ipr<number_of_particles; ipr++ ) {
-
-            // Momentum cell index for this particle
-            ic = momentum_cell_index[ipr];
-
-            // std::cerr << " ic: " << ic
-            //           << " ipr: " << ipr
-            //           << " momentum_cell_particle_index[ic]: " << momentum_cell_particle_index[ic]
-            //           << std::endl;
-
-            sorted_particles[momentum_cell_particle_index[ic]
-            + particles_per_momentum_cells[ic]] = istart + ipr;
-
-            particles_per_momentum_cells[ic] += 1;
-        }
+        // Particles are then sorted by momentum cell (counting sort)
+        sortByMomentumCell( number_of_particles, momentum_cells, istart );
 
 
         // For each momentum bin, merge packet of particles composed of
@@ -78,6 +78,10 @@ protected:
     // Minimum momentum value in log scale
     double min_momentum_log_scale_;
 
+    // Workspace, kept from one cell to the next to avoid allocations:
+    // gamma factor (or momentum norm for photons) of the particles
+    std::vector <double> gamma_;
+
 private:
 
 };
@@ -90,33 +90,38 @@ void MergingVranicSpherical::operator() (
         unsigned int theta_dim_ref = dimensions_[1];
         unsigned int theta_dim_min = 1;
         unsigned int phi_dim = dimensions_[2];
-        std::vector <unsigned int> theta_dim(phi_dim,0);
+        std::vector <unsigned int> &theta_dim = theta_dim_;
+        theta_dim.resize( phi_dim );
 //         unsigned int  * theta_dim = (unsigned int*) aligned_alloc(64, phi_dim*sizeof(unsigned int));
 
         // Minima
         double mr_min;
         double theta_min_ref;
-        std::vector <double> theta_min(phi_dim,0);
+        std::vector <double> &theta_min = theta_min_;
+        theta_min.resize( phi_dim );
 //         double  * theta_min = (double*) aligned_alloc(64, phi_dim*sizeof(double));
         double phi_min;
 
         // Maxima
         double mr_max;
         double theta_max_ref;
-        std::vector <double> theta_max(phi_dim,0);
+        std::vector <double> &theta_max = theta_max_;
+        theta_max.resize( phi_dim );
 //         double  * theta_max = (double*) aligned_alloc(64, phi_dim*sizeof(double));
         double phi_max;
 
         // Delta
         double mr_delta;
         double theta_delta_ref;
-        std::vector <double> theta_delta(phi_dim,0);
+        std::vector <double> &theta_delta = theta_delta_;
+        theta_delta.resize( phi_dim );
 //         double  * theta_delta = (double*) aligned_alloc(64, phi_dim*sizeof(double));
         double phi_delta;
 
         // Inverse Delta
         double inv_mr_delta;
-        std::vector <double> inv_theta_delta(phi_dim,0);
+        std::vector <double> &inv_theta_delta = inv_theta_delta_;
+        inv_theta_delta.resize( phi_dim );
 //         double  * inv_theta_delta = (double*) aligned_alloc(64, phi_dim*sizeof(double));
         double inv_phi_delta;
 
@@ -172,20 +177,24 @@ void MergingVranicSpherical::operator() (
         // int *cell_keys = &( particles.cell_keys[0] );
 
         // Norm of the momentum
-        std::vector <double> momentum_norm(number_of_particles,0);
+        std::vector <double> &momentum_norm = momentum_norm_;
+        momentum_norm.resize( number_of_particles );
 //         double  * momentum_norm = (double*) aligned_alloc(64, number_of_particles*sizeof(double));
 
         // Local vector to store the momentum index in the momentum discretization
-        std::vector <unsigned int> momentum_cell_index(number_of_particles,0);
+        std::vector <unsigned int> &momentum_cell_index = momentum_cell_index_;
+        momentum_cell_index.resize( number_of_particles );
 //         unsigned int  * momentum_cell_index = (unsigned int*) aligned_alloc(64, number_of_particles*sizeof(unsigned int));
 
         // Sorted array of particle index
-        std::vector <unsigned int> sorted_particles(number_of_particles,0);
+        std::vector <unsigned int> &sorted_particles = sorted_particles_;
 //         unsigned int  * sorted_particles = (unsigned int*) aligned_alloc(64, number_of_particles*sizeof(unsigned int));
 
         // Local vector to store the momentum angles in the spherical base
-        std::vector <double> particles_phi(number_of_particles,0);
-        std::vector <double> particles_theta(number_of_particles,0);
+        std::vector <double> &particles_phi = particles_phi_;
+        particles_phi.resize( number_of_particles );
+        std::vector <double> &particles_theta = particles_theta_;
+        particles_theta.resize( number_of_particles );
 //         double  * particles_phi = (double*) aligned_alloc(64, number_of_particles*sizeof(double));
 //         double  * particles_theta = (double*) aligned_alloc(64, number_of_particles*sizeof(double));
 
@@ -433,12 +442,12 @@ void MergingVranicSpherical::operator() (
         }
 
         // Array containing the number of particles per momentum cells
-        std::vector <unsigned int> particles_per_momentum_cells(momentum_cells,0);
+        std::vector <unsigned int> &particles_per_momentum_cells = particles_per_momentum_cells_;
 //         unsigned int  * particles_per_momentum_cells = (unsigned int*) aligned_alloc(64, momentum_cells*sizeof(unsigned int));
 
         // Array containing the first particle index of each momentum cell
         // in the sorted particle array
-        std::vector <unsigned int> momentum_cell_particle_index(momentum_cells,0);
+        std::vector <unsigned int> &momentum_cell_particle_index = momentum_cell_particle_index_;
 //         unsigned int  * momentum_cell_particle_index = (unsigned int*) aligned_alloc(64, momentum_cells*sizeof(unsigned int));
 //
 //         // Initialization when using aligned_alloc
@@ -450,7 +459,8 @@ void MergingVranicSpherical::operator() (
 
         // First Cell index in theta for each phi coordinates
         // (necessary since the theta_dim depends on phi)
-        std::vector <unsigned int>  theta_start_index (phi_dim);
+        std::vector <unsigned int> &theta_start_index = theta_start_index_;
+        theta_start_index.resize( phi_dim );
 
         // Computation of the first cell index for each phi
         theta_start_index[0] = 0;
@@ -462,9 +472,12 @@ void MergingVranicSpherical::operator() (
         // Only necessary for mass particles
 
         // Cell direction unit vector in the spherical base
-        std::vector <double> cell_vec_x(momentum_angular_cells,0);
-        std::vector <double> cell_vec_y(momentum_angular_cells,0);
-        std::vector <double> cell_vec_z(momentum_angular_cells,0);
+        std::vector <double> &cell_vec_x = cell_vec_x_;
+        cell_vec_x.resize( momentum_angular_cells );
+        std::vector <double> &cell_vec_y = cell_vec_y_;
+        cell_vec_y.resize( momentum_angular_cells );
+        std::vector <double> &cell_vec_z = cell_vec_z_;
+        cell_vec_z.resize( momentum_angular_cells );
 //         double  * cell_vec_x = (double*) aligned_alloc(64, momentum_angular_cells*sizeof(double));
 //         double  * cell_vec_y = (double*) aligned_alloc(64, momentum_angular_cells*sizeof(double));
 //         double  * cell_vec_z = (double*) aligned_alloc(64, momentum_angular_cells*sizeof(double));
@@ -571,35 +584,8 @@ void MergingVranicSpherical::operator() (
             }
         }
 
-        // The number of particles per momentum cells
-        // is then determined.
-        // No vectorization because of random memory accesses
-        for (ipr=0; ipr<number_of_particles; ipr++ ) {
-            // Number of particles per momentum cells
-            particles_per_momentum_cells[momentum_cell_index[ipr]] += 1;
-        }
-
-        // Computation of the cell index in the sorted array of particles
-        // Noy vectorizable
-        for (ic = 1 ; ic < momentum_cells ; ic++) {
-            momentum_cell_particle_index[ic]  = momentum_cell_particle_index[ic-1] + particles_per_momentum_cells[ic-1];
-            particles_per_momentum_cells[ic-1] = 0;
-        }
-        particles_per_momentum_cells[momentum_cells-1] = 0;
-
-        // sort particles in correct bins according to their
-        // momentum properties
-        // Not vectorizable
-        for (ipr=0 ; ipr<number_of_particles; ipr++ ) {
-
-            // Momentum cell index for this particle
-            ic = momentum_cell_index[ipr];
-
-            sorted_particles[momentum_cell_particle_index[ic]
-            + particles_per_momentum_cells[ic]] = istart + ipr;
-
-            particles_per_momentum_cells[ic] += 1;
-        }
+        // Particles are then sorted by momentum cell (counting sort)
+        sortByMomentumCell( number_of_particles, momentum_cells, istart );
 
         // Debugging
         /*for (mr_i=0 ; mr_i< mr_dim; mr_i++ ) {
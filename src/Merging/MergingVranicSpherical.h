@@ -78,6 +78,26 @@ protected:
     // Minimum momentum value in log scale
     double min_momentum_log_scale_;
 
+    // Workspaces, kept from one cell to the next to avoid allocations
+
+    // Norm and angles of the particle momenta
+    std::vector <double> momentum_norm_;
+    std::vector <double> particles_phi_;
+    std::vector <double> particles_theta_;
+
+    // Discretization in theta for each phi
+    std::vector <unsigned int> theta_dim_;
+    std::vector <double> theta_min_;
+    std::vector <double> theta_max_;
+    std::vector <double> theta_delta_;
+    std::vector <double> inv_theta_delta_;
+    std::vector <unsigned int> theta_start_index_;
+
+    // Direction unit vector of each angular momentum cell
+    std::vector <double> cell_vec_x_;
+    std::vector <double> cell_vec_y_;
+    std::vector <double> cell_vec_z_;
+
 private:
 
 };
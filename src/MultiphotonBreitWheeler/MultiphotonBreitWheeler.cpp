@@ -159,34 +159,32 @@ void MultiphotonBreitWheeler::operator()( Particles &particles,
         momentum[i] =  &( particles.momentum( i, 0 ) );
     }
 
-    // Position shortcut
-    // Commented particles displasment while particles injection not managed  in a better way
-    //    for now particles could be created outside of the local domain
-    //    without been subject do boundary conditions (including domain exchange)
-    //double* position[3];
-    //for ( int i = 0 ; i<n_dimensions_ ; i++ )
-    //    position[i] =  &( particles.position(i,0) );
-
-    // Weight shortcut
-    // double* weight = &( particles.weight(0) );
-
     // Optical depth for the Monte-Carlo process
     double *tau = &( particles.tau( 0 ) );
 
     // Quantum parameter
     double *photon_chi = &( particles.chi( 0 ) );
 
-    // Photon id
-    // uint64_t * id = &( particles.id(0));
-
     // Total energy converted into pairs for this species during this timestep
     this->pair_converted_energy_ = 0;
 
+    // Buffers (reused between calls as this operator is called for each cell)
+    int n = iend-istart;
+    if( n <= 0 ) {
+        return;
+    }
+    if( ( int ) mc_state_.size() < n ) {
+        mc_state_.resize( n );
+    }
+    int *mc_state = &mc_state_[0] - istart;
+
     // _______________________________________________________________
     // Computation
 
-    // 1. Computation of gamma and chi
-    //    Can be vectorized
+    // 1. Computation of gamma and chi, and state of the Monte-Carlo process.
+    //    Photons with enough energy (we also check that photon_chi > chiph_threshold,
+    //    else photon_chi is too low to induce a decay) either start a new process
+    //    (tau <= 0) or have a decay under progress
     #pragma omp simd
     for( int ipart=istart ; ipart<iend; ipart++ ) {
         // Gamma
@@ -200,285 +198,169 @@ void MultiphotonBreitWheeler::operator()( Particles &particles,
                                 ( *gamma )[ipart],
                                 ( *( Ex+ipart-ipart_ref ) ), ( *( Ey+ipart-ipart_ref ) ), ( *( Ez+ipart-ipart_ref ) ),
                                 ( *( Bx+ipart-ipart_ref ) ), ( *( By+ipart-ipart_ref ) ), ( *( Bz+ipart-ipart_ref ) ) );
+
+        if( ( ( *gamma )[ipart] > 2. ) && ( photon_chi[ipart] > chiph_threshold_ ) ) {
+            mc_state[ipart] = ( tau[ipart] <= epsilon_tau_ ) ? 1 : 2;
+        } else {
+            mc_state[ipart] = 0;
+        }
     }
 
-    // 2. Monte-Carlo process
-    //    No vectorized
+    // 2. New final optical depths to reach for the decay
+    //    (the decay starts at the next iteration)
     for( int ipart=istart ; ipart<iend; ipart++ ) {
+        if( mc_state[ipart] == 1 ) {
+            while( tau[ipart] <= epsilon_tau_ ) {
+                tau[ipart] = -log( 1.-rand_->uniform() );
+            }
+        }
+    }
 
-        // If the photon has enough energy
-        // We also check that photon_chi > chiph_threshold,
-        // else photon_chi is too low to induce a decay
-        if( ( ( *gamma )[ipart] > 2. ) && ( photon_chi[ipart] > chiph_threshold_ ) ) {
-            // Init local variables
-            event_time = 0;
-
-            // New even
-            // If tau[ipart] <= 0, this is a new process
-            if( tau[ipart] <= epsilon_tau_ ) {
-                // New final optical depth to reach for emision
-                while( tau[ipart] <= epsilon_tau_ ) {
-                    //tau[ipart] = -log( 1.-Rand::uniform() );
-                    tau[ipart] = -log( 1.-rand_->uniform() );
-                }
+    // 3. Photon decay under progress: update of the optical depth
+    //    from the cross section
+    #pragma omp simd private(temp, event_time)
+    for( int ipart=istart ; ipart<iend; ipart++ ) {
+        if( mc_state[ipart] == 2 ) {
+            temp = MultiphotonBreitWheelerTables.computeBreitWheelerPairProductionRate( photon_chi[ipart], ( *gamma )[ipart] );
 
-            }
+            // Time to decay
+            // If this time is above the remaining iteration time,
+            // There is a synchronization at the end of the pic iteration
+            // and the process continues at the next
+            event_time = std::min( tau[ipart]/temp, dt_ );
 
-            // Photon decay: emission under progress
-            // If epsilon_tau_ > 0
-            else if( tau[ipart] > epsilon_tau_ ) {
-                // from the cross section
-                temp = MultiphotonBreitWheelerTables.computeBreitWheelerPairProductionRate( photon_chi[ipart], ( *gamma )[ipart] );
-                
-                // Time to decay
-                // If this time is above the remaining iteration time,
-                // There is a synchronization at the end of the pic iteration
-                // and the process continues at the next
-                event_time = std::min( tau[ipart]/temp, dt_ );
-
-                // Update of the optical depth
-                tau[ipart] -= temp*event_time;
-
-                // If the final optical depth is reached
-                // The photon decays into pairs
-                if( tau[ipart] <= epsilon_tau_ ) {
-
-                    // Update of the position
-                    // Move the photons
-
-//#ifdef  __DEBUG
-//                    for ( int i = 0 ; i<n_dimensions_ ; i++ )
-//                        particles.position_old(i,ipart) = position[i][ipart];
-//#endif
-//                    for ( int i = 0 ; i<n_dimensions_ ; i++ )
-//                        position[i][ipart]     += event_time*momentum[i][ipart]/(*gamma)[ipart];
-
-                    // Generation of the pairs
-                    MultiphotonBreitWheeler::pair_emission( ipart,
-                                                            particles,
-                                                            ( *gamma )[ipart],
-                                                            dt_ - event_time,
-                                                            MultiphotonBreitWheelerTables );
-
-
-                    // Optical depth becomes negative meaning
-                    // that a new drawing is possible
-                    // at the next Monte-Carlo iteration
-                    tau[ipart] = -1.;
-                }
-            }
+            // Update of the optical depth
+            tau[ipart] -= temp*event_time;
+        }
+    }
+
+    // 4. Record of the photons that reach their final optical depth:
+    //    they decay into pairs
+    decay_index_.resize( 0 );
+    for( int ipart=istart ; ipart<iend; ipart++ ) {
+        if( ( mc_state[ipart] == 2 ) && ( tau[ipart] <= epsilon_tau_ ) ) {
+            decay_index_.push_back( ipart );
         }
     }
-}
 
+    // 5. Generation of all the pairs
+    if( decay_index_.size() > 0 ) {
+        MultiphotonBreitWheeler::pair_emission( particles,
+                                                &( *gamma )[0],
+                                                MultiphotonBreitWheelerTables );
+    }
+}
 
 // -----------------------------------------------------------------------------
-//! Second version of pair_emission:
-//! Perform the creation of pairs from a photon with particles as an argument
-//! \param ipart              photon index
+//! Perform the creation of the pairs of all the photons recorded in
+//! decay_index_, with a single allocation in each pair buffer.
+//! The decayed photons get a weight 0: they are deleted with the particles
+//! leaving the patch (see PartBoundCond::apply).
 //! \param particles          object particles containing the photons and their properties
-//! \param gammaph            photon normalized energy
-//! \param remaining_dt       remaining time before the end of the iteration
+//! \param gammaph            photon normalized energies
 //! \param MultiphotonBreitWheelerTables    Cross-section data tables
 //!                       and useful functions
 //!                       for the multiphoton Breit-Wheeler process
 // -----------------------------------------------------------------------------
-void MultiphotonBreitWheeler::pair_emission( int ipart,
-        Particles &particles,
-        double &gammaph,
-        double remaining_dt,
+void MultiphotonBreitWheeler::pair_emission( Particles &particles,
+        double *gammaph,
         MultiphotonBreitWheelerTables &MultiphotonBreitWheelerTables )
 {
+    int ndecay = decay_index_.size();
+    int *decay_index = &decay_index_[0];
 
-    // _______________________________________________
-    // Parameters
+    // Shortcuts
+    double *weight = &( particles.weight( 0 ) );
+    double *tau = &( particles.tau( 0 ) );
+    double *photon_chi = &( particles.chi( 0 ) );
 
-    int      nparticles;           // Total number of particles in the temporary arrays
-    int      k, i;
-    double   u[3];                 // propagation direction
-    double *chi = new double[2];   // temporary quantum parameters
-    double   inv_chiph_gammaph;    // (gamma_ph - 2) / chi
-    double   p;
-    // Commented particles displasment while particles injection not managed  in a better way
-    //    for now particles could be created outside of the local domain
-    //    without been subject do boundary conditions (including domain exchange)
-    //double   inv_gamma;
-
-    inv_chiph_gammaph = ( gammaph-2. )/particles.chi( ipart );
-
-    // Get the pair quantum parameters to compute the energy
-    chi = MultiphotonBreitWheelerTables.computePairQuantumParameter( particles.chi( ipart ), rand_ );
-    
-    // pair propagation direction // direction of the photon
-    for( k = 0 ; k<3 ; k++ ) {
-        u[k] = particles.momentum( k, ipart )/gammaph;
+    // Electron and positron quantum parameters of each decay
+    // (random draws, not vectorized)
+    pair_chi_.resize( 2*ndecay );
+    for( int idecay=0; idecay<ndecay; idecay++ ) {
+        MultiphotonBreitWheelerTables.computePairQuantumParameter( photon_chi[decay_index[idecay]],
+                &pair_chi_[2*idecay], rand_ );
     }
 
     // _______________________________________________
     // Electron (k=0) and positron (k=1) generation
 
-    for( k=0 ; k < 2 ; k++ ) {
+    for( int k=0 ; k < 2 ; k++ ) {
 
-        // Creation of new electrons in the temporary array new_pair[0]
-        new_pair[k].createParticles( mBW_pair_creation_sampling_[k] );
-        
-        // Final size
-        nparticles = new_pair[k].size();
+        // One allocation for all the new electrons (or positrons)
+        // in the temporary array new_pair[k]
+        int sampling = mBW_pair_creation_sampling_[k];
+        int first = new_pair[k].size();
+        new_pair[k].createParticles( ndecay*sampling );
 
-        // For all new electrons...
-        for( int idNew=nparticles-mBW_pair_creation_sampling_[k]; idNew<nparticles; idNew++ ) {
-
-            // Momentum
-            p = sqrt( pow( 1.+chi[k]*inv_chiph_gammaph, 2 )-1 );
-            for( i=0; i<3; i++ ) {
-                new_pair[k].momentum( i, idNew ) =
-                    p*u[i];
-            }
-
-            // gamma
-            //inv_gamma = 1./sqrt(1.+p*p);
-
-            // Positions
-            for( i=0; i<n_dimensions_; i++ ) {
-                new_pair[k].position( i, idNew )=particles.position( i, ipart );
-//               + new_pair[k].momentum(i,idNew)*remaining_dt*inv_gamma;
+        double *position[3], *position_old[3], *momentum[3];
+        for( int i=0; i<n_dimensions_; i++ ) {
+            position[i] = &( new_pair[k].position( i, 0 ) );
+            position_old[i] = ( particles.Position_old.size() > 0 ) ? &( new_pair[k].position_old( i, 0 ) ) : NULL;
+        }
+        for( int i=0; i<3; i++ ) {
+            momentum[i] = &( new_pair[k].momentum( i, 0 ) );
+        }
+        double *new_weight = &( new_pair[k].weight( 0 ) );
+        short *charge = &( new_pair[k].charge( 0 ) );
+        double *chi = new_pair[k].isQuantumParameter ? &( new_pair[k].chi( 0 ) ) : NULL;
+        double *new_tau = new_pair[k].isMonteCarlo ? &( new_pair[k].tau( 0 ) ) : NULL;
+
+        for( int idecay=0; idecay<ndecay; idecay++ ) {
+            int ipart = decay_index[idecay];
+
+            // The pair propagates in the direction of the photon
+            double p = sqrt( pow( 1.+pair_chi_[2*idecay+k]*( gammaph[ipart]-2. )/photon_chi[ipart], 2 )-1 )
+                       / gammaph[ipart];
+
+            int idNew = first + idecay*sampling;
+            for( int i=0; i<3; i++ ) {
+                double pi = p*particles.momentum( i, ipart );
+                for( int j=idNew; j<idNew+sampling; j++ ) {
+                    momentum[i][j] = pi;
+                }
             }
-
-            // Old positions
-            if( particles.Position_old.size() > 0 ) {
-                for( i=0; i<n_dimensions_; i++ ) {
-                    new_pair[k].position_old( i, idNew )=particles.position( i, ipart ) ;
+            for( int i=0; i<n_dimensions_; i++ ) {
+                double xi = particles.position( i, ipart );
+                for( int j=idNew; j<idNew+sampling; j++ ) {
+                    position[i][j] = xi;
+                }
+                if( position_old[i] ) {
+                    for( int j=idNew; j<idNew+sampling; j++ ) {
+                        position_old[i][j] = xi;
+                    }
                 }
             }
-
-            new_pair[k].weight( idNew )=particles.weight( ipart )*mBW_pair_creation_inv_sampling_[k];
-            new_pair[k].charge( idNew )= k*2-1;
-
-            if( new_pair[k].isQuantumParameter ) {
-                new_pair[k].chi( idNew ) = chi[k];
+            for( int j=idNew; j<idNew+sampling; j++ ) {
+                new_weight[j] = weight[ipart]*mBW_pair_creation_inv_sampling_[k];
+                charge[j] = k*2-1;
             }
-
-            if( new_pair[k].isMonteCarlo ) {
-                new_pair[k].tau( idNew ) = -1.;
+            if( chi ) {
+                for( int j=idNew; j<idNew+sampling; j++ ) {
+                    chi[j] = pair_chi_[2*idecay+k];
+                }
             }
-        }
-    }
-
-    // Total energy converted into pairs during the current timestep
-    pair_converted_energy_ += particles.weight( ipart )*gammaph;
-
-    // The photon with negtive weight will be deleted latter
-    particles.weight( ipart ) = -1;
-
-}
-
-// -----------------------------------------------------------------------------
-//! Clean photons that decayed into pairs (weight <= 0)
-//! \param particles   particle object containing the particle
-//!                    properties of the current species
-//! \param istart      Index of the first particle
-//! \param iend        Index of the last particle
-//! \param ithread     Thread index
-// -----------------------------------------------------------------------------
-void MultiphotonBreitWheeler::decayed_photon_cleaning(
-    Particles &particles,
-    SmileiMPI *smpi,
-    int ibin, int nbin,
-    int *bmin, int *bmax, int ithread )
-{
-    std::vector<double> *Epart = &( smpi->dynamics_Epart[ithread] );
-    std::vector<double> *Bpart = &( smpi->dynamics_Bpart[ithread] );
-    std::vector<double> *gamma = &( smpi->dynamics_invgf[ithread] );
-    std::vector<int> *iold = &( smpi->dynamics_iold[ithread] );
-    std::vector<double> *deltaold = &( smpi->dynamics_deltaold[ithread] );
-
-    std::vector<double> *thetaold = NULL;
-    if ( smpi->dynamics_thetaold.size() )
-        thetaold = &( smpi->dynamics_thetaold[ithread] );
-
-    int nparts = Epart->size()/3;
-
-
-    if( bmax[ibin] > bmin[ibin] ) {
-        // Weight shortcut
-        double *weight = &( particles.weight( 0 ) );
-
-        // Index of the last existing photon (weight > 0)
-        int last_photon_index;
-        int first_photon_index;
-        int ii;
-        int nb_deleted_photon;
-
-        // Backward loop over the photons to fing the first existing photon
-        last_photon_index = bmax[ibin]-1;
-        first_photon_index = bmin[ibin];
-        while( ( last_photon_index >= bmin[ibin] )
-                && ( weight[last_photon_index] <= 0 ) ) {
-            last_photon_index--;
-        }
-        while( ( first_photon_index < bmax[ibin] )
-                && ( weight[first_photon_index] > 0 ) ) {
-            first_photon_index++;
-        }
-        // At this level, last_photon_index is the position of the last photon
-        // that will not be erased
-
-        // Backward loop over the photons to fill holes in the photon particle array
-        for( int ipart=last_photon_index-1 ; ipart>=bmin[ibin]; ipart-- ) {
-            if( weight[ipart] <= 0 ) {
-                if( ipart < last_photon_index ) {
-                    // The last existing photon comes to the position of
-                    // the deleted photon
-                    particles.overwriteParticle( last_photon_index, ipart );
-                    // Overwrite bufferised data
-                    for ( int iDim=2 ; iDim>=0 ; iDim-- ) {
-                        (*Epart)[iDim*nparts+ipart] = (*Epart)[iDim*nparts+last_photon_index];
-                        (*Bpart)[iDim*nparts+ipart] = (*Bpart)[iDim*nparts+last_photon_index];
-                    }
-                    for ( int iDim=n_dimensions_-1 ; iDim>=0 ; iDim-- ) {
-                        (*iold)[iDim*nparts+ipart] = (*iold)[iDim*nparts+last_photon_index];
-                        (*deltaold)[iDim*nparts+ipart] = (*deltaold)[iDim*nparts+last_photon_index];
-                    }
-                    (*gamma)[0*nparts+ipart] = (*gamma)[0*nparts+last_photon_index];
-
-                    if (thetaold) {
-                        (*thetaold)[0*nparts+ipart] = (*thetaold)[0*nparts+last_photon_index];
-                    }
-
-                    last_photon_index --;
-
-
+            if( new_tau ) {
+                for( int j=idNew; j<idNew+sampling; j++ ) {
+                    new_tau[j] = -1.;
                 }
             }
         }
+    }
 
-        // Removal of the photons
-        nb_deleted_photon = bmax[ibin]-last_photon_index-1;
-
-        if( nb_deleted_photon > 0 ) {
-            particles.eraseParticle( last_photon_index+1, nb_deleted_photon );
-            // Erase bufferised data
-            for ( int iDim=2 ; iDim>=0 ; iDim-- ) {
-                Epart->erase(Epart->begin()+iDim*nparts+last_photon_index+1,Epart->begin()+iDim*nparts+last_photon_index+1+nb_deleted_photon);
-                Bpart->erase(Bpart->begin()+iDim*nparts+last_photon_index+1,Bpart->begin()+iDim*nparts+last_photon_index+1+nb_deleted_photon);
-            }
-            for ( int iDim=n_dimensions_-1 ; iDim>=0 ; iDim-- ) {
-                iold->erase(iold->begin()+iDim*nparts+last_photon_index+1,iold->begin()+iDim*nparts+last_photon_index+1+nb_deleted_photon);
-                deltaold->erase(deltaold->begin()+iDim*nparts+last_photon_index+1,deltaold->begin()+iDim*nparts+last_photon_index+1+nb_deleted_photon);
-            }
-            gamma->erase(gamma->begin()+0*nparts+last_photon_index+1,gamma->begin()+0*nparts+last_photon_index+1+nb_deleted_photon);
-
-            if (thetaold) {
-                thetaold->erase(thetaold->begin()+0*nparts+last_photon_index+1,thetaold->begin()+0*nparts+last_photon_index+1+nb_deleted_photon);
-            }
+    // The decayed photons are deleted with the particles leaving the patch
+    // (see PartBoundCond::apply)
+    for( int idecay=0; idecay<ndecay; idecay++ ) {
+        int ipart = decay_index[idecay];
 
+        // Total energy converted into pairs during the current timestep
+        pair_converted_energy_ += weight[ipart]*gammaph[ipart];
 
+        // Optical depth becomes negative meaning
+        // that a new drawing is possible
+        // at the next Monte-Carlo iteration
+        tau[ipart] = -1.;
 
-            bmax[ibin] = last_photon_index+1;
-            for( ii=ibin+1; ii<nbin; ii++ ) {
-                bmin[ii] -= nb_deleted_photon;
-                bmax[ii] -= nb_deleted_photon;
-            }
-        }
+        weight[ipart] = 0.;
     }
 }
@@ -85,33 +85,19 @@ public:
                                int iend,
                                int ithread, int ipart_ref = 0 );
                                
-    //! Second version of pair_emission:
-    //! Perform the creation of pairs from a photon with particles as an argument
-    //! \param ipart              photon index
+    //! Perform the creation of the pairs of all the photons recorded in
+    //! decay_index_, with a single allocation in each pair buffer.
+    //! The decayed photons get a weight 0: they are deleted with the particles
+    //! leaving the patch (see PartBoundCond::apply).
     //! \param particles          object particles containing the photons and their properties
-    //! \param gammaph            photon normalized energy
-    //! \param remaining_dt       remaining time before the end of the iteration
+    //! \param gammaph            photon normalized energies
     //! \param MultiphotonBreitWheelerTables    Cross-section data tables
     //!                       and useful functions
     //!                       for the multiphoton Breit-Wheeler process
-    void pair_emission( int ipart,
-                        Particles &particles,
-                        double &gammaph,
-                        double remaining_dt,
+    void pair_emission( Particles &particles,
+                        double *gammaph,
                         MultiphotonBreitWheelerTables &MultiphotonBreitWheelerTables );
-                        
-    //! Clean photons that decayed into pairs (weight <= 0)
-    //! \param particles   particle object containing the particle
-    //!                    properties of the current species
-    //! \param istart      Index of the first particle
-    //! \param iend        Index of the last particle
-    //! \param ithread     Thread index
-    void decayed_photon_cleaning(
-        Particles &particles,
-        SmileiMPI *smpi,
-        int ibin, int nbin,
-        int *bmin, int *bmax, int ithread );
-        
+
     //! Return the pair converted energy
     double inline getPairEnergy( void )
     {
@@ -158,6 +144,13 @@ private:
     
     //! Espilon to check when tau is near 0
     static constexpr double epsilon_tau_ = 1e-100;
+
+    //! Buffers for the photons of the current call: state of the Monte-Carlo process
+    //! (0: no process, 1: new optical depth to draw, 2: decay under progress),
+    //! indices of the decaying photons and quantum parameters of their pairs
+    std::vector<int> mc_state_;
+    std::vector<int> decay_index_;
+    std::vector<double> pair_chi_;
     
 };
 
@@ -13,8 +13,12 @@
 
 #include "MultiphotonBreitWheelerTables.h"
 #include "MultiphotonBreitWheelerTablesDefault.h"
+#include "QEDTablesGenerator.h"
 #include "H5.h"
 
+#include <sys/stat.h>
+#include <cstdio>
+
 // -----------------------------------------------------------------------------
 // INITILIZATION AND DESTRUCTION
 // -----------------------------------------------------------------------------
@@ -61,6 +65,28 @@ void MultiphotonBreitWheelerTables::initialization( Params &params, SmileiMPI *s
     if( PyTools::nComponents( "MultiphotonBreitWheeler" ) ) {
         // Path to the databases
         PyTools::extract( "table_path", table_path_, "MultiphotonBreitWheeler"  );
+
+        // Parameters of the tables generated at initialization
+        PyTools::extractV( "table_size", table_size_, "MultiphotonBreitWheeler" );
+        PyTools::extractV( "table_chi_range", table_chi_range_, "MultiphotonBreitWheeler" );
+        PyTools::extract( "table_xi_threshold", table_xi_threshold_, "MultiphotonBreitWheeler" );
+        PyTools::extract( "table_xi_power", table_xi_power_, "MultiphotonBreitWheeler" );
+        PyTools::extract( "table_cache_path", table_cache_path_, "MultiphotonBreitWheeler" );
+
+        if( table_size_.size() > 0 ) {
+            if( table_path_.size() > 0 ) {
+                ERROR( "In MultiphotonBreitWheeler, `table_path` and `table_size` cannot be both defined" );
+            }
+            if( table_size_.size() != 2 || table_size_[0] < 2 || table_size_[1] < 2 ) {
+                ERROR( "In MultiphotonBreitWheeler, `table_size` must be a list of 2 sizes above 1"
+                       << " [photon chi, particle chi]" );
+            }
+            if( table_chi_range_.size() != 2 || table_chi_range_[0] <= 0.
+                    || table_chi_range_[1] <= table_chi_range_[0] ) {
+                ERROR( "In MultiphotonBreitWheeler, `table_chi_range` must be a list [min, max]"
+                       << " of 2 increasing positive values" );
+            }
+        }
     }
     
     // Computation of some parameters
@@ -76,6 +102,10 @@ void MultiphotonBreitWheelerTables::initialization( Params &params, SmileiMPI *s
     if( params.hasMultiphotonBreitWheeler ) {
         if (table_path_.size() > 0) {
             MESSAGE( 1,"Reading of the external database, path: " << table_path_ );
+            table_file_ = table_path_ + "/multiphoton_Breit_Wheeler_tables.h5";
+            readTables( params, smpi );
+        } else if( table_size_.size() > 0 ) {
+            generateTables( smpi );
             readTables( params, smpi );
         } else {
             MESSAGE(1,"Default tables (stored in the code) are used:");
@@ -97,6 +127,7 @@ void MultiphotonBreitWheelerTables::initialization( Params &params, SmileiMPI *s
         MESSAGE( 2,"Minimum photon chi: " << xi_.min_photon_chi_ );
         MESSAGE( 2,"Maximum photon chi: " << xi_.max_photon_chi_ );
         
+        compileTables();
     }
 
 }
@@ -105,68 +136,16 @@ void MultiphotonBreitWheelerTables::initialization( Params &params, SmileiMPI *s
 // PHYSICAL COMPUTATION
 // -----------------------------------------------------------------------------
 
-// -----------------------------------------------------------------------------
-//! Computation of the production rate of pairs per photon
-//! \param photon_chi photon quantum parameter
-//! \param gamma photon normalized energy
-// -----------------------------------------------------------------------------
-double MultiphotonBreitWheelerTables::computeBreitWheelerPairProductionRate( double photon_chi, double gamma )
-{
-    // ________________________________________
-    // Parameters
-
-    // Log of the photon quantum parameter particle_chi
-    double logchiph;
-    double logchiphm;
-    double logchiphp;
-    // Index
-    int ichiph;
-    // final value
-    double dNBWdt;
-
-    // ________________________________________
-    // Computation
-
-    logchiph = log10( photon_chi );
-
-    // Lower index for interpolation in the table integfochi
-    ichiph = int( floor( ( logchiph-T_.log10_min_photon_chi_ )
-                         *T_.photon_chi_inv_delta_ ) );
-
-    // If photon_chi is below the lower bound of the table
-    // An asymptotic approximation is used
-    if( ichiph < 0 ) {
-        ichiph = 0;
-        // 0.2296 * sqrt(3) * pi [MG/correction by Antony]
-        dNBWdt = 1.2493450020845291*exp( -8.0/( 3.0*photon_chi ) ) * photon_chi*photon_chi;
-    }
-    // If photon_chi is above the upper bound of the table
-    // An asymptotic approximation is used
-    else if( ichiph >= T_.size_photon_chi_-1 ) {
-        ichiph = T_.size_photon_chi_-2;
-        dNBWdt = 2.067731275227008*pow( photon_chi, 5.0/3.0 );
-    } else {
-        // Upper and lower values for linear interpolation
-        logchiphm = ichiph*T_.photon_chi_delta_ + T_.log10_min_photon_chi_;
-        logchiphp = logchiphm + T_.photon_chi_delta_;
-
-        // Interpolation
-        dNBWdt = ( T_.table_[ichiph+1]*fabs( logchiph-logchiphm ) +
-                   T_.table_[ichiph]*fabs( logchiphp - logchiph ) )*T_.photon_chi_inv_delta_;
-    }
-    return factor_dNBW_dt_*dNBWdt/(photon_chi*gamma);
-}
-
 // -----------------------------------------------------------------------------
 //! Computation of the electron and positron quantum parameters for
 //! the multiphoton Breit-Wheeler pair creation
 //
 //! \param photon_chi photon quantum parameter
+//! \param chi electron and positron quantum parameters (output, size 2)
 // -----------------------------------------------------------------------------
-double *MultiphotonBreitWheelerTables::computePairQuantumParameter( double photon_chi, Random * rand )
+void MultiphotonBreitWheelerTables::computePairQuantumParameter( double photon_chi, double *chi, Random * rand )
 {
     // Parameters
-    double *chi = new double[2];
     double logchiph;
     double log10_chipam, log10_chipap;
     double d;
@@ -214,19 +193,9 @@ double *MultiphotonBreitWheelerTables::computePairQuantumParameter( double photo
         xipp = xip;
     }
 
-    // check boundaries
-    // Lower bound
-    if( xipp < xi_.table_[ichiph*xi_.size_particle_chi_] ) {
-        ichipa = 0;
-    }
-    // Upper bound
-    else if( xipp >= xi_.table_[( ichiph+1 )*xi_.size_particle_chi_-1] ) {
-        ichipa = xi_.size_particle_chi_-2;
-    } else {
-        // Search for the corresponding index ichipa for xip
-        ichipa = userFunctions::searchValuesInMonotonicArray(
-                     &xi_.table_[ichiph*xi_.size_particle_chi_], xipp, xi_.size_particle_chi_ );
-    }
+    // Index ichipa for xip from the inverse of the cumulative distribution
+    // (0 below the lower bound, xi_.size_particle_chi_-2 above the upper bound)
+    ichipa = xi_.cdf_.find( ichiph, xipp );
 
     // Delta for the particle_chi dimension
     delta_chipa = ( log10( 0.5*photon_chi )-xi_.min_particle_chi_[ichiph] )
@@ -256,8 +225,6 @@ double *MultiphotonBreitWheelerTables::computePairQuantumParameter( double photo
         // Positron quantum parameter
         chi[1] = photon_chi - chi[0];
     }
-
-    return chi;
 }
 
 // -----------------------------------------------------------------------------
@@ -271,7 +238,7 @@ double *MultiphotonBreitWheelerTables::computePairQuantumParameter( double photo
 // -----------------------------------------------------------------------------
 void MultiphotonBreitWheelerTables::readTableT( SmileiMPI *smpi )
 {
-    std::string file = table_path_ + "/multiphoton_Breit_Wheeler_tables.h5";
+    std::string file = table_file_;
     if( Tools::fileExists( file ) ) {
         
         if( smpi->isMaster() ) {
@@ -292,8 +259,8 @@ void MultiphotonBreitWheelerTables::readTableT( SmileiMPI *smpi )
     }
     else
     {
-        ERROR("The table T for the nonlinear Breit-Wheeler pair process could not be read from the provided path: `"
-              << table_path_<<"`. Please check that the path is correct.")
+        ERROR("The table T for the nonlinear Breit-Wheeler pair process could not be read from the file `"
+              << table_file_<<"`. Please check that the path is correct.")
     }
 
     // Bcast the table to all MPI ranks
@@ -308,7 +275,7 @@ void MultiphotonBreitWheelerTables::readTableT( SmileiMPI *smpi )
 // -----------------------------------------------------------------------------
 void MultiphotonBreitWheelerTables::readTableXi( SmileiMPI *smpi )
 {
-    std::string file = table_path_ + "/multiphoton_Breit_Wheeler_tables.h5";
+    std::string file = table_file_;
     if( Tools::fileExists( file ) ) {
         
         if( smpi->isMaster() ) {
@@ -333,8 +300,8 @@ void MultiphotonBreitWheelerTables::readTableXi( SmileiMPI *smpi )
     else
     {
         ERROR("The tables chipamin and xip for the nonlinear Breit-Wheeler pair"
-              << " process could not be read from the provided path: `"
-              << table_path_<<"`. Please check that the path is correct.")
+              << " process could not be read from the file `"
+              << table_file_<<"`. Please check that the path is correct.")
     }
     
     // Bcast the table to all MPI ranks
@@ -358,6 +325,80 @@ void MultiphotonBreitWheelerTables::readTables( Params &params, SmileiMPI *smpi
     }
 }
 
+// -----------------------------------------------------------------------------
+// TABLE GENERATION
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+//! Generate the tables with the parameters of the namelist, or find them in the
+//! cache. The tables are written by the master in the same format as the
+//! tool smilei_tables, and then read as external tables.
+//
+//! \param smpi Object of class SmileiMPI containing MPI properties
+// -----------------------------------------------------------------------------
+void MultiphotonBreitWheelerTables::generateTables( SmileiMPI *smpi )
+{
+    std::ostringstream parameters;
+    parameters << "v1" << std::setprecision( 17 )
+               << " " << table_size_[0] << " " << table_size_[1]
+               << " " << table_chi_range_[0] << " " << table_chi_range_[1]
+               << " " << table_xi_threshold_ << " " << table_xi_power_;
+    table_file_ = QEDTablesGenerator::cacheFile( table_cache_path_,
+                  "multiphoton_Breit_Wheeler_tables", parameters.str() );
+
+    // The master decides for all ranks, which may not share the same view of the disk
+    int cached = smpi->isMaster() ? Tools::fileExists( table_file_ ) : 0;
+    MPI_Bcast( &cached, 1, MPI_INT, 0, smpi->world() );
+    if( cached ) {
+        MESSAGE( 1,"Reading of the cached tables `" << table_file_ << "`" );
+        return;
+    }
+
+    MESSAGE( 1,"Generation of the tables (" << table_size_[0] << " x " << table_size_[1] << ")" );
+    double t0 = MPI_Wtime();
+    std::vector<double> T, min_particle_chi, xi;
+    QEDTablesGenerator::computeBreitWheelerTables( table_size_[0], table_size_[1],
+            table_chi_range_[0], table_chi_range_[1], table_xi_power_, table_xi_threshold_,
+            smpi->world(), T, min_particle_chi, xi );
+    MESSAGE( 2,"Done in " << MPI_Wtime() - t0 << " s" );
+
+    // The file is renamed once complete, so that a simulation running at the
+    // same time never reads a partial file
+    if( smpi->isMaster() ) {
+        mkdir( table_cache_path_.c_str(), 0755 );
+        std::string tmp_file = table_file_ + ".tmp";
+        {
+            H5Write f( tmp_file );
+            {
+                H5Write d = f.vect( "integration_dt_dchi", T );
+                d.attr( "min_photon_chi", table_chi_range_[0] );
+                d.attr( "max_photon_chi", table_chi_range_[1] );
+                d.attr( "size_photon_chi", table_size_[0] );
+            }
+            {
+                H5Write d = f.vect( "min_particle_chi_for_xi", min_particle_chi );
+                d.attr( "min_photon_chi", table_chi_range_[0] );
+                d.attr( "max_photon_chi", table_chi_range_[1] );
+                d.attr( "size_photon_chi", table_size_[0] );
+                d.attr( "power", table_xi_power_ );
+                d.attr( "threshold", table_xi_threshold_ );
+            }
+            {
+                H5Write d = f.vect( "xi", xi );
+                d.attr( "min_photon_chi", table_chi_range_[0] );
+                d.attr( "max_photon_chi", table_chi_range_[1] );
+                d.attr( "size_particle_chi", table_size_[1] );
+                d.attr( "size_photon_chi", table_size_[0] );
+            }
+        }
+        if( std::rename( tmp_file.c_str(), table_file_.c_str() ) != 0 ) {
+            ERROR( "The generated tables could not be written in `" << table_file_ << "`" );
+        }
+        MESSAGE( 1,"Tables saved in `" << table_file_ << "`" );
+    }
+    MPI_Barrier( smpi->world() );
+}
+
 // -----------------------------------------------------------------------------
 // TABLE COMMUNICATIONS
 // -----------------------------------------------------------------------------
@@ -546,3 +587,14 @@ void MultiphotonBreitWheelerTables::bcastTableXi( SmileiMPI *smpi )
     xi_.inv_size_particle_chi_minus_one_ = 1./( xi_.size_particle_chi_ - 1. );
 
 }
+
+// -----------------------------------------------------------------------------
+//! Compile the tables into the layouts used by the operators:
+//! interleaved (value, slope) for T,
+//! indexed cumulative distribution functions for xi
+// -----------------------------------------------------------------------------
+void MultiphotonBreitWheelerTables::compileTables()
+{
+    T_.lookup_.set( T_.table_, T_.min_photon_chi_, T_.max_photon_chi_ );
+    xi_.cdf_.set( xi_.table_, xi_.size_photon_chi_, xi_.size_particle_chi_ );
+}
@@ -22,6 +22,7 @@
 #include "Params.h"
 #include "userFunctions.h"
 #include "Random.h"
+#include "LookupTable.h"
 
 //------------------------------------------------------------------------------
 //! MutliphotonBreitWheelerTables class: holds parameters, tables and
@@ -49,14 +50,39 @@ public:
     // ---------------------------------------------------------------------
 
     //! Computation of the production rate of pairs per photon
+    //! (inline so that it can be vectorized in the loops on photons)
     //! \param photon_chi photon quantum parameter
     //! \param gamma photon normalized energy
-    double computeBreitWheelerPairProductionRate( double photon_chi, double gamma );
+    inline double computeBreitWheelerPairProductionRate( double photon_chi, double gamma )
+    {
+        // Log of the photon quantum parameter photon_chi
+        double logchiph = std::log10( photon_chi );
+        // final value
+        double dNBWdt;
+
+        // Inside the table, interpolation
+        if( T_.lookup_.contains( logchiph ) ) {
+            dNBWdt = T_.lookup_( logchiph );
+        }
+        // If photon_chi is below the lower bound of the table
+        // An asymptotic approximation is used
+        else if( logchiph < T_.log10_min_photon_chi_ ) {
+            // 0.2296 * sqrt(3) * pi [MG/correction by Antony]
+            dNBWdt = 1.2493450020845291*std::exp( -8.0/( 3.0*photon_chi ) ) * photon_chi*photon_chi;
+        }
+        // If photon_chi is above the upper bound of the table
+        // An asymptotic approximation is used
+        else {
+            dNBWdt = 2.067731275227008*std::pow( photon_chi, 5.0/3.0 );
+        }
+        return factor_dNBW_dt_*dNBWdt/( photon_chi*gamma );
+    };
 
     //! Computation of the electron and positron quantum parameters for
     //! the multiphoton Breit-Wheeler pair creation
     //! \param photon_chi photon quantum parameter
-    double *computePairQuantumParameter( double photon_chi, Random * rand );
+    //! \param chi electron and positron quantum parameters (output, size 2)
+    void computePairQuantumParameter( double photon_chi, double *chi, Random * rand );
 
 
     // ---------------------------------------------------------------------
@@ -75,6 +101,15 @@ public:
     //! \param smpi Object of class SmileiMPI containing MPI properties
     void readTables( Params &params, SmileiMPI *smpi );
 
+    // ---------------------------------------------------------------------
+    // TABLE GENERATION
+    // ---------------------------------------------------------------------
+
+    //! Generate the tables with the parameters of the namelist, or find them
+    //! in the cache, and set the file from which they are read
+    //! \param smpi Object of class SmileiMPI containing MPI properties
+    void generateTables( SmileiMPI *smpi );
+
     // ---------------------------------------------------------------------
     // TABLE COMMUNICATIONS
     // ---------------------------------------------------------------------
@@ -87,6 +122,10 @@ public:
     //! \param smpi Object of class SmileiMPI containing MPI properties
     void bcastTableXi( SmileiMPI *smpi );
 
+    //! Compile the tables into the layouts used by the operators
+    //! (see LookupTable.h)
+    void compileTables();
+
     // ---------------------------------------------
     // Structure for Table T used for the
     // pair creation Monte-Carlo process
@@ -114,6 +153,9 @@ public:
 
         //! Dimension of the array T
         int size_photon_chi_;
+
+        //! Compiled table for the interpolation
+        LogTable lookup_;
         
     };
 
@@ -165,6 +207,9 @@ public:
         //! 1/(xi_.size_particle_chi_ - 1)
         double inv_size_particle_chi_minus_one_;
 
+        //! Compiled table to invert the cumulative distribution functions
+        CDFTable cdf_;
+
         //! xip threshold
         // double threshold_;
         
@@ -180,6 +225,25 @@ private:
     //! Path to the tables
     std::string table_path_;
 
+    //! File from which the tables are read
+    std::string table_file_;
+
+    //! Sizes [photon chi, particle chi] of the tables generated at initialization
+    //! (empty if the tables are not generated)
+    std::vector<int> table_size_;
+
+    //! Photon chi range of the generated tables
+    std::vector<double> table_chi_range_;
+
+    //! Threshold on xi for the minimum particle chi of the generated tables
+    double table_xi_threshold_;
+
+    //! Number of digits of the minimum particle chi of the generated tables
+    double table_xi_power_;
+
+    //! Directory of the cache of the generated tables
+    std::string table_cache_path_;
+
     // ---------------------------------------------
     // Factors
     // ---------------------------------------------
@@ -210,6 +210,8 @@ Params::Params( SmileiMPI *smpi, std::vector<std::string> namelistsFiles ) :
         srand48( random_seed );
         // Init of the seed for the C++ random generator
         Rand::gen = std::mt19937( random_seed );
+    } else {
+        random_seed = Rand::device();
     }
 
     // communication pattern initialized as partial B exchange
@@ -590,12 +592,15 @@ Params::Params( SmileiMPI *smpi, std::vector<std::string> namelistsFiles ) :
     PyTools::extract( "patch_arrangement", patch_arrangement, "Main"  );
     WARNING( "Patches distribution: " << patch_arrangement );
 
+    // Arrangements following a space-filling curve (as opposed to linearized ones)
+    bool curve_arrangement = ( patch_arrangement == "hilbertian" ) || ( patch_arrangement == "generalized_hilbertian" )
+                             || ( patch_arrangement == "morton" ) || ( patch_arrangement == "peano" );
     int total_number_of_hilbert_patches = 1;
-    if( patch_arrangement == "hilbertian" ) {
+    if( curve_arrangement ) {
         for( unsigned int iDim=0 ; iDim<nDim_field ; iDim++ ) {
             total_number_of_hilbert_patches *= number_of_patches[iDim];
-            if( ( number_of_patches[iDim] & ( number_of_patches[iDim]-1 ) ) != 0 ) {
-                ERROR( "Number of patches in each direction must be a power of 2" );
+            if( patch_arrangement == "hilbertian" && ( number_of_patches[iDim] & ( number_of_patches[iDim]-1 ) ) != 0 ) {
+                ERROR( "Number of patches in each direction must be a power of 2 (or use patch_arrangement = \"generalized_hilbertian\")" );
             }
         }
     }
@@ -611,14 +616,40 @@ Params::Params( SmileiMPI *smpi, std::vector<std::string> namelistsFiles ) :
         PyTools::extract( "cell_load", cell_load, "LoadBalancing"   );
         PyTools::extract( "frozen_particle_load", frozen_particle_load, "LoadBalancing"   );
         PyTools::extract( "initial_balance", initial_balance, "LoadBalancing"   );
+        PyTools::extract( "load_model", load_model, "LoadBalancing"   );
+        if( load_model != "particles" && load_model != "timers" ) {
+            ERROR( "In LoadBalancing, `load_model` must be \"particles\" or \"timers\"" );
+        }
+        PyTools::extract( "load_smoothing", load_smoothing, "LoadBalancing"   );
+        if( load_smoothing <= 0. || load_smoothing > 1. ) {
+            ERROR( "In LoadBalancing, `load_smoothing` must be in ]0, 1]" );
+        }
+        PyTools::extract( "adaptive", adaptive_load_balancing, "LoadBalancing"   );
+        PyTools::extract( "horizon", load_balancing_horizon, "LoadBalancing"   );
+        PyTools::extract( "migration_bandwidth", migration_bandwidth, "LoadBalancing"   );
+        if( adaptive_load_balancing && ( load_balancing_horizon == 0 || migration_bandwidth <= 0. ) ) {
+            ERROR( "In LoadBalancing, `horizon` and `migration_bandwidth` must be positive" );
+        }
+        PyTools::extract( "hierarchical", hierarchical_load_balancing, "LoadBalancing"   );
+        PyTools::extract( "ranks_per_node", ranks_per_node, "LoadBalancing"   );
+        PyTools::extract( "node_imbalance_tolerance", node_imbalance_tolerance, "LoadBalancing"   );
+        if( ranks_per_node < 0 || node_imbalance_tolerance < 0. ) {
+            ERROR( "In LoadBalancing, `ranks_per_node` and `node_imbalance_tolerance` must be positive" );
+        }
     } else {
+        load_model = "particles";
+        load_smoothing = 0.5;
+        adaptive_load_balancing = false;
+        hierarchical_load_balancing = false;
+        ranks_per_node = 0;
+        node_imbalance_tolerance = 0.1;
         load_balancing_time_selection = new TimeSelection();
     }
 
     has_load_balancing = ( smpi->getSize()>1 )  && ( ! load_balancing_time_selection->isEmpty() );
 
-    if( has_load_balancing && patch_arrangement != "hilbertian" ) {
-        ERROR( "Dynamic load balancing is only available for Hilbert decomposition" );
+    if( has_load_balancing && !curve_arrangement ) {
+        ERROR( "Dynamic load balancing is only available for space-filling curve decompositions" );
     }
     if( has_load_balancing && total_number_of_hilbert_patches < 2*smpi->getSize() ) {
         ERROR( "Dynamic load balancing requires to use at least 2 patches per MPI process." );
@@ -1209,6 +1240,16 @@ void Params::print_init()
         MESSAGE( 1, "Happens: " << load_balancing_time_selection->info() );
         MESSAGE( 1, "Cell load coefficient = " << cell_load );
         MESSAGE( 1, "Frozen particle load coefficient = " << frozen_particle_load );
+        if( load_model == "timers" ) {
+            MESSAGE( 1, "Patch loads measured by timers (smoothing coefficient = " << load_smoothing << ")" );
+        }
+        if( adaptive_load_balancing ) {
+            MESSAGE( 1, "Adaptive: only when the gain over " << load_balancing_horizon << " iterations exceeds the migration cost" );
+            MESSAGE( 1, "Migration bandwidth = " << migration_bandwidth << " bytes/s" );
+        }
+        if( hierarchical_load_balancing ) {
+            MESSAGE( 1, "Hierarchical: patches move between nodes when their imbalance exceeds " << node_imbalance_tolerance );
+        }
     }
 
     TITLE( "Vectorization: " );
@@ -270,6 +270,22 @@ public:
     double cell_load;
     //! Load coefficient applied to a frozen particle (default = 0.1)
     double frozen_particle_load;
+    //! Load model used by the dynamic load balancing: "particles" (default) or "timers"
+    std::string load_model;
+    //! Exponential smoothing coefficient applied to the measured patch loads (default = 0.5)
+    double load_smoothing;
+    //! True if load balancing only happens when the measured imbalance is worth it
+    bool adaptive_load_balancing;
+    //! Number of iterations over which the gain of a load balancing is evaluated
+    unsigned int load_balancing_horizon;
+    //! Estimated bandwidth (bytes/s) of patch exchanges, used to evaluate the cost of a load balancing
+    double migration_bandwidth;
+    //! True if the load balancing first distributes the patches between nodes, then between the ranks of each node
+    bool hierarchical_load_balancing;
+    //! Number of consecutive ranks forming a node (0 = detect the nodes)
+    int ranks_per_node;
+    //! Relative load imbalance between nodes above which patches are exchanged between nodes
+    double node_imbalance_tolerance;
     //! Return if number of patch = number of MPI process, to tune IO //ism
     bool one_patch_per_MPI;
     //! Compute an initially balanced patch distribution right from the start
@@ -0,0 +1,452 @@
+#include "ParticleExpression.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <cctype>
+#include <algorithm>
+
+#include "Particles.h"
+#include "Tools.h"
+
+using namespace std;
+
+// Number of particles evaluated at once by each operation
+static const unsigned int block_size = 64;
+
+ParticleExpression::ParticleExpression( string expression, unsigned int nDim_particle, string error_prefix ) :
+    max_depth_( 0 ),
+    depth_( 0 ),
+    expression_( expression ),
+    nDim_particle_( nDim_particle ),
+    error_prefix_( error_prefix ),
+    token_start_( 0 ),
+    position_( 0 )
+{
+    nextToken();
+    if( token_.empty() ) {
+        ERROR( error_prefix_ << ": empty expression" );
+    }
+    parseOr();
+    if( ! token_.empty() ) {
+        syntaxError( "unexpected `" + token_ + "`" );
+    }
+}
+
+ParticleExpression::~ParticleExpression()
+{
+}
+
+
+void ParticleExpression::nextToken()
+{
+    while( position_ < expression_.size() && isspace( expression_[position_] ) ) {
+        position_++;
+    }
+    token_start_ = position_;
+    if( position_ >= expression_.size() ) {
+        token_ = "";
+        return;
+    }
+    char c = expression_[position_];
+    if( isdigit( c ) || c == '.' ) {
+        // Number, with an optional exponent
+        const char *start = expression_.c_str() + position_;
+        char *end;
+        strtod( start, &end );
+        if( end == start ) {
+            syntaxError( "invalid number" );
+        }
+        position_ += end - start;
+    } else if( isalpha( c ) || c == '_' ) {
+        while( position_ < expression_.size() && ( isalnum( expression_[position_] ) || expression_[position_] == '_' ) ) {
+            position_++;
+        }
+    } else {
+        // Operators of two characters, then of one character
+        string two = expression_.substr( position_, 2 );
+        if( two == "**" || two == "<=" || two == ">=" || two == "==" || two == "!=" ) {
+            position_ += 2;
+        } else if( string( "<>+-*/%(),&|~" ).find( c ) != string::npos ) {
+            position_++;
+        } else {
+            syntaxError( string( "unexpected character `" ) + c + "`" );
+        }
+    }
+    token_ = expression_.substr( token_start_, position_ - token_start_ );
+}
+
+
+void ParticleExpression::syntaxError( string message )
+{
+    ERROR( error_prefix_ << ": " << message << " at position " << token_start_ << " in `" << expression_ << "`" );
+}
+
+
+void ParticleExpression::emit( Operation operation, double value, unsigned int component )
+{
+    Instruction instruction;
+    instruction.operation = operation;
+    instruction.value = value;
+    instruction.component = component;
+    program_.push_back( instruction );
+
+    if( operation <= chi ) {
+        depth_++;
+    } else if( operation >= add ) {
+        depth_--;
+    }
+    max_depth_ = max( max_depth_, depth_ );
+}
+
+
+void ParticleExpression::parseOr()
+{
+    parseAnd();
+    while( token_ == "or" || token_ == "|" ) {
+        nextToken();
+        parseAnd();
+        emit( logical_or );
+    }
+}
+
+void ParticleExpression::parseAnd()
+{
+    parseNot();
+    while( token_ == "and" || token_ == "&" ) {
+        nextToken();
+        parseNot();
+        emit( logical_and );
+    }
+}
+
+void ParticleExpression::parseNot()
+{
+    if( token_ == "not" || token_ == "~" ) {
+        nextToken();
+        parseNot();
+        emit( logical_not );
+    } else {
+        parseComparison();
+    }
+}
+
+void ParticleExpression::parseComparison()
+{
+    parseSum();
+    const string comparisons[6] = { "<", "<=", ">", ">=", "==", "!=" };
+    const Operation operations[6] = { less, less_equal, greater, greater_equal, equal, not_equal };
+    for( unsigned int i=0; i<6; i++ ) {
+        if( token_ == comparisons[i] ) {
+            nextToken();
+            parseSum();
+            emit( operations[i] );
+            if( find( comparisons, comparisons+6, token_ ) != comparisons+6 ) {
+                syntaxError( "chained comparisons are not supported (use `and`)" );
+            }
+            break;
+        }
+    }
+}
+
+void ParticleExpression::parseSum()
+{
+    parseProduct();
+    while( token_ == "+" || token_ == "-" ) {
+        Operation operation = token_ == "+" ? add : subtract;
+        nextToken();
+        parseProduct();
+        emit( operation );
+    }
+}
+
+void ParticleExpression::parseProduct()
+{
+    parseUnary();
+    while( token_ == "*" || token_ == "/" || token_ == "%" ) {
+        Operation operation = token_ == "*" ? multiply : ( token_ == "/" ? divide : modulo );
+        nextToken();
+        parseUnary();
+        emit( operation );
+    }
+}
+
+void ParticleExpression::parseUnary()
+{
+    if( token_ == "-" ) {
+        nextToken();
+        parseUnary();
+        emit( negative );
+    } else if( token_ == "+" ) {
+        nextToken();
+        parseUnary();
+    } else {
+        parsePower();
+    }
+}
+
+void ParticleExpression::parsePower()
+{
+    parsePrimary();
+    if( token_ == "**" ) {
+        nextToken();
+        parseUnary();
+        emit( power );
+    }
+}
+
+void ParticleExpression::parsePrimary()
+{
+    if( token_.empty() ) {
+        syntaxError( "unexpected end of expression" );
+    }
+
+    // Number
+    if( isdigit( token_[0] ) || token_[0] == '.' ) {
+        emit( constant, strtod( token_.c_str(), NULL ) );
+        nextToken();
+        return;
+    }
+
+    // Parentheses
+    if( token_ == "(" ) {
+        nextToken();
+        parseOr();
+        if( token_ != ")" ) {
+            syntaxError( "expected `)`" );
+        }
+        nextToken();
+        return;
+    }
+
+    if( ! isalpha( token_[0] ) && token_[0] != '_' ) {
+        syntaxError( "unexpected `" + token_ + "`" );
+    }
+    string name = token_;
+    nextToken();
+
+    // Function
+    if( token_ == "(" ) {
+        const string functions[10] = { "abs", "sqrt", "exp", "log", "sin", "cos", "tan", "floor", "min", "max" };
+        const Operation operations[10] = { absolute, square_root, exponential, logarithm, sine, cosine, tangent, floor_value, minimum, maximum };
+        unsigned int i = find( functions, functions+10, name ) - functions;
+        if( i == 10 ) {
+            syntaxError( "unknown function `" + name + "`" );
+        }
+        unsigned int nargs = operations[i] >= add ? 2 : 1;
+        nextToken();
+        for( unsigned int iarg=0; iarg<nargs; iarg++ ) {
+            if( iarg > 0 ) {
+                if( token_ != "," ) {
+                    syntaxError( "function `" + name + "` requires 2 arguments" );
+                }
+                nextToken();
+            }
+            parseOr();
+        }
+        if( token_ != ")" ) {
+            syntaxError( "expected `)` after the argument" + string( nargs > 1 ? "s" : "" ) + " of `" + name + "`" );
+        }
+        nextToken();
+        emit( operations[i] );
+        return;
+    }
+
+    // Variable
+    const string xyz = "xyz";
+    if( name.size() == 1 && xyz.find( name ) != string::npos ) {
+        unsigned int idim = xyz.find( name );
+        if( idim >= nDim_particle_ ) {
+            ERROR( error_prefix_ << ": `" << name << "` is not available in " << nDim_particle_ << "D in `" << expression_ << "`" );
+        }
+        emit( position, 0., idim );
+    } else if( name.size() == 2 && name[0] == 'p' && xyz.find( name[1] ) != string::npos ) {
+        emit( momentum, 0., xyz.find( name[1] ) );
+    } else if( name == "weight" ) {
+        emit( weight );
+    } else if( name == "charge" ) {
+        emit( charge );
+    } else if( name == "id" ) {
+        emit( id );
+    } else if( name == "chi" ) {
+        emit( chi );
+    } else if( name == "pi" ) {
+        emit( constant, M_PI );
+    } else {
+        ERROR( error_prefix_ << ": unknown variable `" << name << "` in `" << expression_ << "`" );
+    }
+}
+
+
+// Helpers applying an operation on one block of values
+template<typename F>
+static inline void apply_unary( double *a, unsigned int n, F f )
+{
+    for( unsigned int i=0; i<n; i++ ) {
+        a[i] = f( a[i] );
+    }
+}
+
+template<typename F>
+static inline void apply_binary( double *a, const double *b, unsigned int n, F f )
+{
+    for( unsigned int i=0; i<n; i++ ) {
+        a[i] = f( a[i], b[i] );
+    }
+}
+
+template<typename T>
+static inline void load( double *a, const T *column, unsigned int n )
+{
+    for( unsigned int i=0; i<n; i++ ) {
+        a[i] = ( double )column[i];
+    }
+}
+
+
+void ParticleExpression::evaluate( Particles &particles, unsigned int istart, unsigned int iend, double *result ) const
+{
+    if( istart >= iend ) {
+        return;
+    }
+    for( unsigned int k=0; k<program_.size(); k++ ) {
+        if( program_[k].operation == chi && particles.Chi.size() < iend ) {
+            ERROR( error_prefix_ << ": `chi` is not available for this species" );
+        }
+    }
+
+    vector<double> stack( max_depth_ * block_size );
+    for( unsigned int i0=istart; i0<iend; i0+=block_size ) {
+        unsigned int n = min( block_size, iend - i0 );
+        // Number of blocks on the stack
+        unsigned int top = 0;
+        for( unsigned int k=0; k<program_.size(); k++ ) {
+            const Instruction &instruction = program_[k];
+            if( instruction.operation <= chi ) {
+                top++;
+            }
+            // Top of the stack, and the value below
+            double *b = &stack[( top-1 ) * block_size];
+            double *a = instruction.operation >= add ? b - block_size : NULL;
+            switch( instruction.operation ) {
+                case constant:
+                    fill( b, b+n, instruction.value );
+                    break;
+                case position:
+                    load( b, &particles.Position[instruction.component][i0], n );
+                    break;
+                case momentum:
+                    load( b, &particles.Momentum[instruction.component][i0], n );
+                    break;
+                case weight:
+                    load( b, &particles.Weight[i0], n );
+                    break;
+                case charge:
+                    load( b, &particles.Charge[i0], n );
+                    break;
+                case id:
+                    load( b, &particles.Id[i0], n );
+                    break;
+                case chi:
+                    load( b, &particles.Chi[i0], n );
+                    break;
+                case negative:
+                    apply_unary( b, n, []( double x ) { return -x; } );
+                    break;
+                case logical_not:
+                    apply_unary( b, n, []( double x ) { return x == 0. ? 1. : 0.; } );
+                    break;
+                case absolute:
+                    apply_unary( b, n, []( double x ) { return std::abs( x ); } );
+                    break;
+                case square_root:
+                    apply_unary( b, n, []( double x ) { return std::sqrt( x ); } );
+                    break;
+                case exponential:
+                    apply_unary( b, n, []( double x ) { return std::exp( x ); } );
+                    break;
+                case logarithm:
+                    apply_unary( b, n, []( double x ) { return std::log( x ); } );
+                    break;
+                case sine:
+                    apply_unary( b, n, []( double x ) { return std::sin( x ); } );
+                    break;
+                case cosine:
+                    apply_unary( b, n, []( double x ) { return std::cos( x ); } );
+                    break;
+                case tangent:
+                    apply_unary( b, n, []( double x ) { return std::tan( x ); } );
+                    break;
+                case floor_value:
+                    apply_unary( b, n, []( double x ) { return std::floor( x ); } );
+                    break;
+                case add:
+                    apply_binary( a, b, n, []( double x, double y ) { return x + y; } );
+                    break;
+                case subtract:
+                    apply_binary( a, b, n, []( double x, double y ) { return x - y; } );
+                    break;
+                case multiply:
+                    apply_binary( a, b, n, []( double x, double y ) { return x * y; } );
+                    break;
+                case divide:
+                    apply_binary( a, b, n, []( double x, double y ) { return x / y; } );
+                    break;
+                case modulo:
+                    // Same sign as the divisor, as in python
+                    apply_binary( a, b, n, []( double x, double y ) { return x - std::floor( x / y ) * y; } );
+                    break;
+                case power:
+                    apply_binary( a, b, n, []( double x, double y ) { return std::pow( x, y ); } );
+                    break;
+                case minimum:
+                    apply_binary( a, b, n, []( double x, double y ) { return std::min( x, y ); } );
+                    break;
+                case maximum:
+                    apply_binary( a, b, n, []( double x, double y ) { return std::max( x, y ); } );
+                    break;
+                case less:
+                    apply_binary( a, b, n, []( double x, double y ) { return x < y ? 1. : 0.; } );
+                    break;
+                case less_equal:
+                    apply_binary( a, b, n, []( double x, double y ) { return x <= y ? 1. : 0.; } );
+                    break;
+                case greater:
+                    apply_binary( a, b, n, []( double x, double y ) { return x > y ? 1. : 0.; } );
+                    break;
+                case greater_equal:
+                    apply_binary( a, b, n, []( double x, double y ) { return x >= y ? 1. : 0.; } );
+                    break;
+                case equal:
+                    apply_binary( a, b, n, []( double x, double y ) { return x == y ? 1. : 0.; } );
+                    break;
+                case not_equal:
+                    apply_binary( a, b, n, []( double x, double y ) { return x != y ? 1. : 0.; } );
+                    break;
+                case logical_and:
+                    apply_binary( a, b, n, []( double x, double y ) { return x != 0. && y != 0. ? 1. : 0.; } );
+                    break;
+                case logical_or:
+                    apply_binary( a, b, n, []( double x, double y ) { return x != 0. || y != 0. ? 1. : 0.; } );
+                    break;
+            }
+            if( instruction.operation >= add ) {
+                top--;
+            }
+        }
+        copy( &stack[0], &stack[n], result + ( i0 - istart ) );
+    }
+}
+
+
+void ParticleExpression::select( Particles &particles, vector<unsigned int> &selection ) const
+{
+    selection.resize( 0 );
+    unsigned int npart = particles.size();
+    vector<double> values( npart );
+    evaluate( particles, 0, npart, values.data() );
+    for( unsigned int i=0; i<npart; i++ ) {
+        if( values[i] != 0. ) {
+            selection.push_back( i );
+        }
+    }
+}
@@ -0,0 +1,87 @@
+#ifndef PARTICLEEXPRESSION_H
+#define PARTICLEEXPRESSION_H
+
+#include <string>
+#include <vector>
+
+class Particles;
+
+//----------------------------------------------------------------------------------------------------------------------
+//! ParticleExpression class: arithmetic and logical expression of the particle properties
+//
+//! The expression, such as "px > 10 and abs(y) < 5", is parsed once into a list of stack operations.
+//! It is then evaluated natively, by blocks of particles, without calling python.
+//! The variables have the same names as the attributes of the python ParticleData object:
+//! x, y, z, px, py, pz, weight, charge, id and chi. Booleans are represented by 1 and 0.
+//----------------------------------------------------------------------------------------------------------------------
+class ParticleExpression
+{
+public:
+    //! Parses the expression (ERROR if it is not valid)
+    ParticleExpression( std::string expression, unsigned int nDim_particle, std::string error_prefix );
+    ~ParticleExpression();
+
+    //! Calculates the expression for the particles istart to iend-1
+    void evaluate( Particles &particles, unsigned int istart, unsigned int iend, double *result ) const;
+
+    //! Lists the indices of the particles for which the expression is true (non-zero)
+    void select( Particles &particles, std::vector<unsigned int> &selection ) const;
+
+    //! Text of the expression
+    std::string expression() const
+    {
+        return expression_;
+    }
+
+private:
+
+    enum Operation {
+        // Values pushed on the stack
+        constant, position, momentum, weight, charge, id, chi,
+        // Unary operations on the top of the stack
+        negative, logical_not, absolute, square_root, exponential, logarithm, sine, cosine, tangent, floor_value,
+        // Binary operations on the two top values of the stack
+        add, subtract, multiply, divide, modulo, power, minimum, maximum,
+        less, less_equal, greater, greater_equal, equal, not_equal, logical_and, logical_or
+    };
+
+    struct Instruction {
+        Operation operation;
+        //! Value of a constant, or component of the position or momentum
+        double value;
+        unsigned int component;
+    };
+
+    // Recursive descent parser, by order of precedence
+    void parseOr();
+    void parseAnd();
+    void parseNot();
+    void parseComparison();
+    void parseSum();
+    void parseProduct();
+    void parseUnary();
+    void parsePower();
+    void parsePrimary();
+
+    //! Reads the next token of the expression
+    void nextToken();
+    //! Stops with an error message pointing at the current token
+    void syntaxError( std::string message );
+    //! Appends an instruction, and updates the stack depth
+    void emit( Operation operation, double value = 0., unsigned int component = 0 );
+
+    //! List of instructions
+    std::vector<Instruction> program_;
+    //! Maximum depth of the stack during the evaluation
+    unsigned int max_depth_, depth_;
+
+    std::string expression_;
+    unsigned int nDim_particle_;
+    std::string error_prefix_;
+
+    //! Parser state: current token, and its position in the expression
+    std::string token_;
+    size_t token_start_, position_;
+};
+
+#endif
@@ -65,6 +65,9 @@ Patch::Patch( Params &params, SmileiMPI *smpi, DomainDecomposition *domain_decom
     patch_timers.resize( 15, 0. );
 #endif
 
+    load_timer_ = 0.;
+    measured_load_ = -1.;
+
 } // END Patch::Patch
 
 
@@ -84,6 +87,9 @@ Patch::Patch( Patch *patch, Params &params, SmileiMPI *smpi, DomainDecomposition
     patch_timers.resize( 15, 0. );
 #endif
 
+    load_timer_ = 0.;
+    measured_load_ = -1.;
+
 }
 
 void Patch::initStep1( Params &params )
@@ -112,7 +118,7 @@ void Patch::initStep1( Params &params )
     }
     
     // Initialize the random number generator
-    rand_ = new Random( params.random_seed );
+    rand_ = new Random( params.random_seed, hindex );
     
     // Obtain the cell_volume
     cell_volume = params.cell_volume;
@@ -96,6 +96,11 @@ public:
     std::vector<double> patch_timers;
 #endif
     
+    //! Time spent computing this patch since the last load balancing (always on)
+    double load_timer_;
+    //! Smoothed measured load of the patch (negative when not measured yet)
+    double measured_load_;
+    
     // Random number generator.
     Random * rand_;
     
@@ -0,0 +1,146 @@
+#include "PatchScheduler.h"
+
+#include <algorithm>
+
+#include <mpi.h>
+
+#include "VectorPatch.h"
+
+using namespace std;
+
+PatchScheduler::PatchScheduler() :
+    first_hindex_( 0 )
+{
+}
+
+PatchScheduler::~PatchScheduler()
+{
+#ifdef _OPENMP
+    for( unsigned int i=0; i<locks_.size(); i++ ) {
+        omp_destroy_lock( &locks_[i] );
+    }
+#endif
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Sort the patches by decreasing cost and distribute them to the threads (Longest Processing Time first)
+// ---------------------------------------------------------------------------------------------------------------------
+void PatchScheduler::distribute( VectorPatch &vecPatches )
+{
+    #pragma omp single
+    {
+        unsigned int npatches = vecPatches.size();
+        
+        // The costs measured in the previous loop are meaningless if the patches changed
+        if( cost_.size() != npatches || ( npatches > 0 && vecPatches( 0 )->hindex != first_hindex_ ) ) {
+            cost_.resize( npatches );
+            for( unsigned int ipatch=0; ipatch<npatches; ipatch++ ) {
+                cost_[ipatch] = 1.;
+                for( unsigned int ispec=0; ispec<vecPatches( ipatch )->vecSpecies.size(); ispec++ ) {
+                    cost_[ipatch] += vecPatches( ipatch )->vecSpecies[ispec]->getNbrOfParticles();
+                }
+            }
+        }
+        if( npatches > 0 ) {
+            first_hindex_ = vecPatches( 0 )->hindex;
+        }
+        
+        order_.resize( npatches );
+        for( unsigned int ipatch=0; ipatch<npatches; ipatch++ ) {
+            order_[ipatch] = ipatch;
+        }
+        const vector<double> &cost = cost_;
+        stable_sort( order_.begin(), order_.end(), [&cost]( unsigned int a, unsigned int b ) {
+            return cost[a] > cost[b];
+        } );
+        
+#ifdef _OPENMP
+        unsigned int nthreads = omp_get_num_threads();
+#else
+        unsigned int nthreads = 1;
+#endif
+        if( queues_.size() != nthreads ) {
+            queues_.resize( nthreads );
+            first_.resize( nthreads );
+            last_.resize( nthreads );
+            current_.resize( nthreads );
+            start_.resize( nthreads );
+#ifdef _OPENMP
+            for( unsigned int i=0; i<locks_.size(); i++ ) {
+                omp_destroy_lock( &locks_[i] );
+            }
+            locks_.resize( nthreads );
+            for( unsigned int i=0; i<nthreads; i++ ) {
+                omp_init_lock( &locks_[i] );
+            }
+#endif
+        }
+        
+        // Each patch goes to the least loaded thread, so that queues stay sorted by decreasing cost
+        vector<double> thread_load( nthreads, 0. );
+        for( unsigned int ithread=0; ithread<nthreads; ithread++ ) {
+            queues_[ithread].resize( 0 );
+        }
+        for( unsigned int i=0; i<npatches; i++ ) {
+            unsigned int ithread = min_element( thread_load.begin(), thread_load.end() ) - thread_load.begin();
+            queues_[ithread].push_back( order_[i] );
+            thread_load[ithread] += cost_[order_[i]];
+        }
+        for( unsigned int ithread=0; ithread<nthreads; ithread++ ) {
+            first_[ithread] = 0;
+            last_[ithread] = queues_[ithread].size();
+            current_[ithread] = -1;
+        }
+    } // implicit barrier
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Measure the time of the patch just treated and give the next one: own queue first, then steal from the others
+// ---------------------------------------------------------------------------------------------------------------------
+bool PatchScheduler::next( unsigned int &ipatch )
+{
+#ifdef _OPENMP
+    unsigned int ithread = omp_get_thread_num();
+#else
+    unsigned int ithread = 0;
+#endif
+    unsigned int nthreads = queues_.size();
+    
+    if( current_[ithread] >= 0 ) {
+        cost_[current_[ithread]] = MPI_Wtime() - start_[ithread];
+        current_[ithread] = -1;
+    }
+    
+    bool found = pop( ithread, true, ipatch );
+    for( unsigned int i=1; i<nthreads && !found; i++ ) {
+        found = pop( ( ithread+i )%nthreads, false, ipatch );
+    }
+    
+    if( found ) {
+        current_[ithread] = ipatch;
+        start_[ithread] = MPI_Wtime();
+    }
+    return found;
+}
+
+bool PatchScheduler::pop( unsigned int iqueue, bool front, unsigned int &ipatch )
+{
+    bool found = false;
+#ifdef _OPENMP
+    omp_set_lock( &locks_[iqueue] );
+#endif
+    if( first_[iqueue] < last_[iqueue] ) {
+        if( front ) {
+            ipatch = queues_[iqueue][first_[iqueue]];
+            first_[iqueue]++;
+        } else {
+            last_[iqueue]--;
+            ipatch = queues_[iqueue][last_[iqueue]];
+        }
+        found = true;
+    }
+#ifdef _OPENMP
+    omp_unset_lock( &locks_[iqueue] );
+#endif
+    return found;
+}
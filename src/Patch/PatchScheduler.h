@@ -0,0 +1,60 @@
+#ifndef PATCHSCHEDULER_H
+#define PATCHSCHEDULER_H
+
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+class VectorPatch;
+
+//  --------------------------------------------------------------------------------------------------------------------
+//! Class PatchScheduler
+//! Distributes the patches of a VectorPatch to the OpenMP threads, largest cost first.
+//! Each thread treats its own queue from the most expensive patch, and steals the cheapest
+//! patches of the other threads when its queue is empty.
+//! The cost of each patch is the time measured during the previous loop (number of particles at first).
+//  --------------------------------------------------------------------------------------------------------------------
+class PatchScheduler
+{
+public:
+    PatchScheduler();
+    ~PatchScheduler();
+    PatchScheduler( const PatchScheduler & ) = delete;
+    PatchScheduler &operator=( const PatchScheduler & ) = delete;
+    
+    //! Sort the patches by decreasing cost and fill the thread queues (called by all threads)
+    void distribute( VectorPatch &vecPatches );
+    
+    //! Give the next patch to be treated by the current thread. Returns false when all patches are done.
+    bool next( unsigned int &ipatch );
+    
+private:
+    //! Cost of each patch
+    std::vector<double> cost_;
+    //! Patches sorted by decreasing cost
+    std::vector<unsigned int> order_;
+    //! Patch queue of each thread
+    std::vector<std::vector<unsigned int> > queues_;
+    //! Position of the first remaining patch in each queue (popped by the owner)
+    std::vector<unsigned int> first_;
+    //! Position after the last remaining patch in each queue (stolen by other threads)
+    std::vector<unsigned int> last_;
+    //! Patch currently treated by each thread (-1 if none)
+    std::vector<int> current_;
+    //! Start time of the current patch of each thread
+    std::vector<double> start_;
+    //! Hindex of the first patch at the last distribution, to detect that patches changed
+    unsigned int first_hindex_;
+    
+#ifdef _OPENMP
+    //! One lock per queue
+    std::vector<omp_lock_t> locks_;
+#endif
+    
+    //! Try to take a patch from the front (own queue) or the back (stolen) of queue iqueue
+    bool pop( unsigned int iqueue, bool front, unsigned int &ipatch );
+};
+
+#endif
@@ -56,6 +56,7 @@ public:
     
         vecPatches.diag_flag = ( params.restart? false : true );
         vecPatches.lastIterationPatchesMoved = itime;
+        vecPatches.lastIterationLoadBalance = itime;
         
         // Compute npatches (1 is std MPI behavior)
         unsigned int npatches, firstpatch;
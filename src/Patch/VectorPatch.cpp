@@ -325,8 +325,10 @@ void VectorPatch::dynamics( Params &params,
     
     timers.particles.restart();
     ostringstream t;
-    #pragma omp for schedule(runtime)
-    for( unsigned int ipatch=0 ; ipatch<this->size() ; ipatch++ ) {
+    dynamics_scheduler_.distribute( *this );
+    unsigned int ipatch;
+    while( dynamics_scheduler_.next( ipatch ) ) {
+        double load_timer = MPI_Wtime();
         ( *this )( ipatch )->EMfields->restartRhoJ();
         for( unsigned int ispec=0 ; ispec<( *this )( ipatch )->vecSpecies.size() ; ispec++ ) {
             Species *spec = species( ipatch, ispec );
@@ -372,8 +374,10 @@ void VectorPatch::dynamics( Params &params,
                 } // end if condition on vectorization
             } // end if condition on species
         } // end loop on species
+        ( *this )( ipatch )->load_timer_ += MPI_Wtime() - load_timer;
         //MESSAGE("species dynamics");
     } // end loop on patches
+    #pragma omp barrier
 
 
     timers.particles.update( params.printNow( itime ) );
@@ -471,8 +475,10 @@ void VectorPatch::finalizeAndSortParticles( Params &params, SmileiMPI *smpi, Sim
     // Particle importation from physical mechanisms
     // ----------------------------------------
 
-    #pragma omp for schedule(runtime)
-    for( unsigned int ipatch=0 ; ipatch<this->size() ; ipatch++ ) {
+    import_scheduler_.distribute( *this );
+    unsigned int ipatch;
+    while( import_scheduler_.next( ipatch ) ) {
+        double load_timer = MPI_Wtime();
         // Particle importation for all species
         for( unsigned int ispec=0 ; ispec<( *this )( ipatch )->vecSpecies.size() ; ispec++ ) {
             if( ( *this )( ipatch )->vecSpecies[ispec]->isProj( time_dual, simWindow ) || diag_flag ) {
@@ -482,7 +488,9 @@ void VectorPatch::finalizeAndSortParticles( Params &params, SmileiMPI *smpi, Sim
                         localDiags );
             }
         }
+        ( *this )( ipatch )->load_timer_ += MPI_Wtime() - load_timer;
     }
+    #pragma omp barrier
 
     timers.syncPart.update( params.printNow( itime ) );
 
@@ -494,15 +502,18 @@ void VectorPatch::mergeParticles(Params &params, SmileiMPI *smpi, double time_du
 {
     timers.particleMerging.restart();
     
-    #pragma omp for schedule(runtime)
-    for( unsigned int ipatch=0 ; ipatch<this->size() ; ipatch++ ) {
+    merging_scheduler_.distribute( *this );
+    unsigned int ipatch;
+    while( merging_scheduler_.next( ipatch ) ) {
+        double load_timer = MPI_Wtime();
         // Particle importation for all species
         for( unsigned int ispec=0 ; ispec<( *this )( ipatch )->vecSpecies.size() ; ispec++ ) {
             // Check if the particle merging is activated for this species
             if (species( ipatch, ispec )->has_merging_) {
 
-                // Check the time selection
-                if( species( ipatch, ispec )->merging_time_selection_->theTimeIsNow( itime ) ) {
+                // Check the time selection (adaptive merging is checked at each timestep)
+                if( species( ipatch, ispec )->merge_adaptive_
+                 || species( ipatch, ispec )->merging_time_selection_->theTimeIsNow( itime ) ) {
                     species( ipatch, ispec )->mergeParticles( time_dual, ispec,
                             params,
                             ( *this )( ipatch ), smpi,
@@ -510,7 +521,9 @@ void VectorPatch::mergeParticles(Params &params, SmileiMPI *smpi, double time_du
                 }
             }
         }
+        ( *this )( ipatch )->load_timer_ += MPI_Wtime() - load_timer;
     }
+    #pragma omp barrier
     
     timers.particleMerging.update( params.printNow( itime ) );
     
@@ -1276,6 +1289,9 @@ void VectorPatch::initAllDiags( Params &params, SmileiMPI *smpi )
 
 void VectorPatch::closeAllDiags( SmileiMPI *smpi )
 {
+    // Finish the asynchronous writes
+    async_writer_.wait();
+    
     // MPI master closes all global diags
     if( smpi->isMaster() )
         for( unsigned int idiag = 0 ; idiag < globalDiags.size() ; idiag++ ) {
@@ -1298,17 +1314,33 @@ void VectorPatch::runAllDiags( Params &params, SmileiMPI *smpi, unsigned int iti
 {
     // Global diags: scalars + particles
     timers.diags.restart();
+
+    // The particle binning diagnostics due at this timestep are computed together, in one pass over the particles
+    #pragma omp single
+    binning_scheduler_.prepare( globalDiags, itime );
+    binning_scheduler_.run( *this, simWindow );
+
     for( unsigned int idiag = 0 ; idiag < globalDiags.size() ; idiag++ ) {
         diag_timers[idiag]->restart();
 
         #pragma omp single
-        globalDiags[idiag]->theTimeIsNow = globalDiags[idiag]->prepare( itime );
+        {
+            if( ! binning_scheduler_.handles( idiag ) ) {
+                globalDiags[idiag]->theTimeIsNow = globalDiags[idiag]->prepare( itime );
+            }
+            // HDF5 is never called concurrently with the asynchronous writes
+            if( globalDiags[idiag]->theTimeIsNow && globalDiags[idiag]->callsHDF5() ) {
+                async_writer_.wait();
+            }
+        }
         #pragma omp barrier
         if( globalDiags[idiag]->theTimeIsNow ) {
-            // All patches run
-            #pragma omp for schedule(runtime)
-            for( unsigned int ipatch=0 ; ipatch<size() ; ipatch++ ) {
-                globalDiags[idiag]->run( ( *this )( ipatch ), itime, simWindow );
+            // All patches run (already done by the scheduler for binning diagnostics)
+            if( ! binning_scheduler_.handles( idiag ) ) {
+                #pragma omp for schedule(runtime)
+                for( unsigned int ipatch=0 ; ipatch<size() ; ipatch++ ) {
+                    globalDiags[idiag]->run( ( *this )( ipatch ), itime, simWindow );
+                }
             }
             // MPI procs gather the data and compute
             #pragma omp single
@@ -1326,7 +1358,12 @@ void VectorPatch::runAllDiags( Params &params, SmileiMPI *smpi, unsigned int iti
         diag_timers[globalDiags.size()+idiag]->restart();
 
         #pragma omp single
-        localDiags[idiag]->theTimeIsNow = localDiags[idiag]->prepare( itime );
+        {
+            localDiags[idiag]->theTimeIsNow = localDiags[idiag]->prepare( itime );
+            if( localDiags[idiag]->theTimeIsNow && localDiags[idiag]->callsHDF5() ) {
+                async_writer_.wait();
+            }
+        }
         #pragma omp barrier
         // All MPI run their stuff and write out
         if( localDiags[idiag]->theTimeIsNow ) {
@@ -2712,6 +2749,7 @@ void VectorPatch::loadBalance( Params &params, double time_dual, SmileiMPI *smpi
 
     // Tell that the patches moved this iteration (needed for probes)
     lastIterationPatchesMoved = itime;
+    lastIterationLoadBalance = itime;
 
 }
 
@@ -3553,6 +3591,14 @@ void VectorPatch::applyAntennas( double time )
     }
 }
 
+// The random numbers of each patch only depend on the seed, the patch index and the timestep
+void VectorPatch::resetRandom( int itime )
+{
+    for( unsigned int ipatch=0 ; ipatch<size() ; ipatch++ ) {
+        patches_[ipatch]->rand_->reset( patches_[ipatch]->Hindex(), itime );
+    }
+}
+
 // For each patch, apply the collisions
 void VectorPatch::applyCollisions( Params &params, int itime, Timers &timers )
 {
@@ -3567,12 +3613,16 @@ void VectorPatch::applyCollisions( Params &params, int itime, Timers &timers )
     
     unsigned int ncoll = patches_[0]->vecCollisions.size();
     
-    #pragma omp for schedule(runtime)
-    for( unsigned int ipatch=0 ; ipatch<size() ; ipatch++ ) {
+    collisions_scheduler_.distribute( *this );
+    unsigned int ipatch;
+    while( collisions_scheduler_.next( ipatch ) ) {
+        double load_timer = MPI_Wtime();
         for( unsigned int icoll=0 ; icoll<ncoll; icoll++ ) {
             patches_[ipatch]->vecCollisions[icoll]->collide( params, patches_[ipatch], itime, localDiags );
         }
+        patches_[ipatch]->load_timer_ += MPI_Wtime() - load_timer;
     }
+    #pragma omp barrier
     
     #pragma omp single
     for( unsigned int icoll=0 ; icoll<ncoll; icoll++ ) {
@@ -3926,6 +3976,7 @@ void VectorPatch::ponderomotiveUpdateSusceptibilityAndMomentum( Params &params,
 
     #pragma omp for schedule(runtime)
     for( unsigned int ipatch=0 ; ipatch<this->size() ; ipatch++ ) {
+        double load_timer = MPI_Wtime();
         ( *this )( ipatch )->EMfields->restartEnvChi();
         for( unsigned int ispec=0 ; ispec<( *this )( ipatch )->vecSpecies.size() ; ispec++ ) {
             if( ( *this )( ipatch )->vecSpecies[ispec]->isProj( time_dual, simWindow ) || diag_flag ) {
@@ -3955,6 +4006,7 @@ void VectorPatch::ponderomotiveUpdateSusceptibilityAndMomentum( Params &params,
                 } // end condition on ponderomotive dynamics
             } // end diagnostic or projection if condition on species
         } // end loop on species
+        ( *this )( ipatch )->load_timer_ += MPI_Wtime() - load_timer;
     } // end loop on patches
 
     timers.particles.update( );
@@ -3979,6 +4031,7 @@ void VectorPatch::ponderomotiveUpdatePositionAndCurrents( Params &params,
 
     #pragma omp for schedule(runtime)
     for( unsigned int ipatch=0 ; ipatch<this->size() ; ipatch++ ) {
+        double load_timer = MPI_Wtime();
         for( unsigned int ispec=0 ; ispec<( *this )( ipatch )->vecSpecies.size() ; ispec++ ) {
             if( ( *this )( ipatch )->vecSpecies[ispec]->isProj( time_dual, simWindow ) || diag_flag ) {
                 if( species( ipatch, ispec )->ponderomotive_dynamics ) {
@@ -4008,6 +4061,7 @@ void VectorPatch::ponderomotiveUpdatePositionAndCurrents( Params &params,
                 } // end condition on ponderomotive dynamics
             } // end diagnostic or projection if condition on species
         } // end loop on species
+        ( *this )( ipatch )->load_timer_ += MPI_Wtime() - load_timer;
     } // end loop on patches
 
     timers.particles.update( params.printNow( itime ) );
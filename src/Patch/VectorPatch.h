@@ -19,6 +19,9 @@
 #include "Timers.h"
 #include "RadiationTables.h"
 #include "ParticleCreator.h"
+#include "PatchScheduler.h"
+#include "AsyncWriter.h"
+#include "ParticleBinningScheduler.h"
 
 class Field;
 class Timer;
@@ -204,6 +207,9 @@ public :
     //! For all patches, apply the antenna current
     void applyAntennas( double time );
     
+    //! For all patches, restart the random numbers for the timestep itime
+    void resetRandom( int itime );
+    
     //! For all patches, apply collisions
     void applyCollisions( Params &params, int itime, Timers &timer );
     
@@ -375,8 +381,17 @@ public :
     //! Tells which iteration was last time the patches moved (by moving window or load balancing)
     unsigned int lastIterationPatchesMoved;
     
+    //! Tells which iteration was last time the load was balanced (start of the patch load timers)
+    unsigned int lastIterationLoadBalance;
+    
     DomainDecomposition *domain_decomposition_;
     
+    //! Background writes of the asynchronous diagnostics
+    AsyncWriter async_writer_;
+    
+    //! Single pass over the particles for all the particle binning diagnostics
+    ParticleBinningScheduler binning_scheduler_;
+    
     
     //! Methods to access readably to patch PIC operators.
     //!   - patches_ should not be access outsied of VectorPatch
@@ -408,6 +423,13 @@ public :
     
 private :
 
+    //  Cost-aware distribution of the patches to the threads in the main particle loops
+    // ---------------------------
+    PatchScheduler dynamics_scheduler_;
+    PatchScheduler import_scheduler_;
+    PatchScheduler merging_scheduler_;
+    PatchScheduler collisions_scheduler_;
+    
     //  Internal balancing members
     // ---------------------------
     std::vector<Patch *> recv_patches_;
@@ -279,6 +279,14 @@ class LoadBalancing(SmileiSingleton):
     initial_balance      = True
     cell_load            = 1.0
     frozen_particle_load = 0.1
+    load_model           = "particles"
+    load_smoothing       = 0.5
+    adaptive             = False
+    horizon              = 1000
+    migration_bandwidth  = 1.e9
+    hierarchical         = False
+    ranks_per_node       = 0
+    node_imbalance_tolerance = 0.1
 
 class MultipleDecomposition(SmileiSingleton):
     """Multiple Decomposition parameters"""
@@ -361,6 +369,8 @@ class Species(SmileiComponent):
     merge_min_packet_size = 4
     merge_max_packet_size = 4
     merge_min_particles_per_cell = 4
+    merge_adaptive = False
+    merge_max_particles_per_step = 0
     merge_min_momentum_cell_length = [1e-10,1e-10,1e-10]
     merge_momentum_cell_size = [16,16,16]
     merge_accumulation_correction = True
@@ -375,6 +385,7 @@ class Species(SmileiComponent):
     ionization_model = "none"
     ionization_electrons = None
     ionization_rate = None
+    ionization_rate_table = []
     atomic_number = None
     maximum_charge_state = 0
     is_test = False
@@ -430,6 +441,9 @@ class Collisions(SmileiComponent):
     coulomb_log = 0.
     coulomb_log_factor = 1.
     debug_every = 0
+    every = 1
+    adaptive_every = 0
+    adaptive_s = 0.1
     ionizing = False
     nuclear_reaction = None
     nuclear_reaction_multiplier = 0.
@@ -447,6 +461,7 @@ class DiagProbe(SmileiComponent):
     fields = []
     flush_every = 1
     time_integral = False
+    aggregators_per_node = 0
 
 class DiagParticleBinning(SmileiComponent):
     """Particle Binning diagnostic"""
@@ -496,6 +511,12 @@ class DiagFields(SmileiComponent):
     time_average = 1
     subgrid = None
     flush_every = 1
+    asynchronous = False
+    precision = "double"
+    deflate = 0
+    shuffle = False
+    compression_plugin = []
+    aggregators_per_node = 0
 
 class DiagTrackParticles(SmileiComponent):
     """Track diagnostic"""
@@ -503,6 +524,11 @@ class DiagTrackParticles(SmileiComponent):
     species = None
     every = 0
     flush_every = 1
+    asynchronous = False
+    precision = "double"
+    deflate = 0
+    shuffle = False
+    compression_plugin = []
     filter = None
     attributes = ["x", "y", "z", "px", "py", "pz", "w"]
 
@@ -558,6 +584,14 @@ class RadiationReaction(SmileiComponent):
     # Parameters for computing the tables
     Niel_computation_method = "table"
 
+    # Tables generated at initialization: sizes [particle chi, photon chi],
+    # particle chi range, parameters of the minimum photon chi, and cache directory
+    table_size = []
+    table_chi_range = [1e-4, 1e3]
+    table_xi_threshold = 1e-3
+    table_xi_power = 4
+    table_cache_path = "."
+
 # MutliphotonBreitWheeler pair creation
 class MultiphotonBreitWheeler(SmileiComponent):
     """
@@ -566,6 +600,14 @@ class MultiphotonBreitWheeler(SmileiComponent):
     # Path the tables/databases
     table_path = ""
 
+    # Tables generated at initialization: sizes [photon chi, particle chi],
+    # photon chi range, parameters of the minimum particle chi, and cache directory
+    table_size = []
+    table_chi_range = [1e-2, 1e2]
+    table_xi_threshold = 1e-9
+    table_xi_power = 5
+    table_cache_path = "."
+
 # Smilei-defined
 smilei_mpi_rank = 0
 smilei_mpi_size = 1
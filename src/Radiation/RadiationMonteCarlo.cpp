@@ -126,16 +126,144 @@ void RadiationMonteCarlo::operator()(
     // Optical depth for the Monte-Carlo process
     double* chi = &( particles.chi(0));
 
+    // Thresholds of the discontinuous and continuous emissions
+    const double minimum_chi_discontinuous = RadiationTables.getMinimumChiDiscontinuous();
+    const double minimum_chi_continuous = RadiationTables.getMinimumChiContinuous();
+
+    // Buffers (reused between calls as this operator is called for each cell)
+    int n = iend-istart;
+    if( n <= 0 ) {
+        return;
+    }
+    if( ( int ) gamma_start_.size() < n ) {
+        gamma_start_.resize( n );
+        chi_start_.resize( n );
+        rad_norm_energy_.resize( n );
+        discontinuous_.resize( n );
+        mc_index_.resize( n );
+        first_emission_time_.resize( n );
+    }
+    double *gamma_start = &gamma_start_[0] - istart;
+    double *chi_start = &chi_start_[0] - istart;
+    double *rad_norm_energy = &rad_norm_energy_[0] - istart;
+    int *discontinuous = &discontinuous_[0] - istart;
+    int *mc_index = &mc_index_[0];
+    double *first_emission_time = &first_emission_time_[0];
+
     // _______________________________________________________________
-    // Computation
+    // Computation of the quantum parameter of all particles:
+    // the continuous emission is applied immediately, and the particles
+    // with a discontinuous emission are flagged for the Monte-Carlo process
 
+    #pragma omp simd private(gamma, particle_chi, temp, charge_over_mass_square)
     for( int ipart=istart ; ipart<iend; ipart++ ) {
         charge_over_mass_square = ( double )( charge[ipart] )*one_over_mass_square;
 
+        // Gamma
+        gamma = sqrt( 1.0 + momentum[0][ipart]*momentum[0][ipart]
+                      + momentum[1][ipart]*momentum[1][ipart]
+                      + momentum[2][ipart]*momentum[2][ipart] );
+
+        // Computation of the Lorentz invariant quantum parameter
+        particle_chi = Radiation::computeParticleChi( charge_over_mass_square,
+                       momentum[0][ipart], momentum[1][ipart], momentum[2][ipart],
+                       gamma,
+                       ( *( Ex+ipart-ipart_ref ) ), ( *( Ey+ipart-ipart_ref ) ), ( *( Ez+ipart-ipart_ref ) ),
+                       ( *( Bx+ipart-ipart_ref ) ), ( *( By+ipart-ipart_ref ) ), ( *( Bz+ipart-ipart_ref ) ) );
+
+        gamma_start[ipart] = gamma;
+        chi_start[ipart] = particle_chi;
+
+        // New discontinuous emission, or emission under progress
+        // (no emission for particles with 0 kinetic energy)
+        discontinuous[ipart] = ( gamma > 1. )
+                                      && ( ( particle_chi > minimum_chi_discontinuous ) || ( tau[ipart] > epsilon_tau_ ) );
+
+        // Continuous emission during the whole timestep
+        rad_norm_energy[ipart] = 0.;
+        if( ( gamma > 1. ) && !discontinuous[ipart]
+            && ( particle_chi > minimum_chi_continuous ) ) {
+
+            // Radiated energy during the time step
+            temp = RadiationTables.getRidgersCorrectedRadiatedEnergy( particle_chi, dt_ );
+
+            // Effect on the momentum
+            temp *= gamma/( gamma*gamma - 1. );
+            momentum[0][ipart] -= temp*momentum[0][ipart];
+            momentum[1][ipart] -= temp*momentum[1][ipart];
+            momentum[2][ipart] -= temp*momentum[2][ipart];
+
+            // Exact energy loss due to the radiation
+            rad_norm_energy[ipart] = gamma - sqrt( 1.0
+                                            + momentum[0][ipart]*momentum[0][ipart]
+                                            + momentum[1][ipart]*momentum[1][ipart]
+                                            + momentum[2][ipart]*momentum[2][ipart] );
+        }
+    }
+
+    double radiated_energy_loc = 0;
+
+    #pragma omp simd reduction(+:radiated_energy_loc)
+    for( int ipart=istart ; ipart<iend; ipart++ ) {
+        radiated_energy_loc += weight[ipart]*rad_norm_energy[ipart];
+    }
+    radiated_energy += radiated_energy_loc;
+
+    // _______________________________________________________________
+    // Monte-Carlo process, for the flagged particles only
+
+    int nmc = 0;
+    for( int ipart=istart ; ipart<iend; ipart++ ) {
+        if( discontinuous[ipart] ) {
+            mc_index[nmc++] = ipart;
+        }
+    }
+
+    // New final optical depths to reach for emission
+    for( int i=0 ; i<nmc; i++ ) {
+        int ipart = mc_index[i];
+        if( chi_start[ipart] > minimum_chi_discontinuous ) {
+            while( tau[ipart] <= epsilon_tau_ ) {
+                tau[ipart] = -log( 1.-rand_->uniform() );
+            }
+        }
+    }
+
+    // First Monte-Carlo iteration for all flagged particles (they all have tau > epsilon_tau_).
+    // Most of them do not reach the final optical depth during the timestep and are done.
+    #pragma omp simd private(temp)
+    for( int i=0 ; i<nmc; i++ ) {
+        int ipart = mc_index[i];
+        temp = RadiationTables.computePhotonProductionYield( chi_start[ipart], gamma_start[ipart] );
+        first_emission_time[i] = std::min( tau[ipart]/temp, dt_ );
+        tau[ipart] -= temp*first_emission_time[i];
+    }
+
+    emission_index_.resize( 0 );
+    emission_chi_.resize( 0 );
+    emission_momentum_.resize( 0 );
+
+    // The particles which emit continue with the scalar Monte-Carlo loop
+    for( int i=0 ; i<nmc; i++ ) {
+        int ipart = mc_index[i];
+        if( tau[ipart] > epsilon_tau_ ) {
+            continue;
+        }
+        charge_over_mass_square = ( double )( charge[ipart] )*one_over_mass_square;
+
+        // Emission of a photon at the end of the first iteration
+        radiated_energy += RadiationMonteCarlo::photonEmission( ipart,
+                                             chi_start[ipart], gamma_start[ipart],
+                                             momentum,
+                                             weight,
+                                             photon_species,
+                                             RadiationTables );
+        tau[ipart] = -1.;
+
         // Init local variables
         emission_time = 0;
-        local_it_time = 0;
-        mc_it_nb = 0;
+        local_it_time = first_emission_time[i];
+        mc_it_nb = 1;
 
         // Monte-Carlo Manager inside the time step
         while( ( local_it_time < dt_ )
@@ -157,18 +285,14 @@ void RadiationMonteCarlo::operator()(
                            ( *( Ex+ipart-ipart_ref ) ), ( *( Ey+ipart-ipart_ref ) ), ( *( Ez+ipart-ipart_ref ) ),
                            ( *( Bx+ipart-ipart_ref ) ), ( *( By+ipart-ipart_ref ) ), ( *( Bz+ipart-ipart_ref ) ) );
 
-            // Update the quantum parameter in species
-            // chi[ipart] = particle_chi;
-
             // Discontinuous emission: New emission
             // If tau[ipart] <= 0, this is a new emission
             // We also check that particle_chi > chipa_threshold,
             // else particle_chi is too low to induce a discontinuous emission
-            if( ( particle_chi > RadiationTables.getMinimumChiDiscontinuous() )
+            if( ( particle_chi > minimum_chi_discontinuous )
                     && ( tau[ipart] <= epsilon_tau_ ) ) {
                 // New final optical depth to reach for emision
                 while( tau[ipart] <= epsilon_tau_ ) {
-                    //tau[ipart] = -log( 1.-Rand::uniform() );
                     tau[ipart] = -log( 1.-rand_->uniform() );
                 }
 
@@ -196,7 +320,6 @@ void RadiationMonteCarlo::operator()(
                     // Radiated energy is incremented only if the macro-photon is not created
                     radiated_energy += RadiationMonteCarlo::photonEmission( ipart,
                                                          particle_chi, gamma,
-                                                         position,
                                                          momentum,
                                                          weight,
                                                          photon_species,
@@ -220,25 +343,25 @@ void RadiationMonteCarlo::operator()(
             // particle_chi needs to be above the continuous threshold
             // No discontiuous emission is in progress:
             // tau[ipart] <= epsilon_tau_
-            else if( ( particle_chi <= RadiationTables.getMinimumChiDiscontinuous() )
+            else if( ( particle_chi <= minimum_chi_discontinuous )
                      && ( tau[ipart] <= epsilon_tau_ )
-                     && ( particle_chi > RadiationTables.getMinimumChiContinuous() )
+                     && ( particle_chi > minimum_chi_continuous )
                      && ( gamma > 1. ) ) {
 
                 // Remaining time of the iteration
                 emission_time = dt_ - local_it_time;
-                
+
                 // Radiated energy during emission_time
                 cont_rad_energy =
                     RadiationTables.getRidgersCorrectedRadiatedEnergy( particle_chi,
                             emission_time );
-                
+
                 // Effect on the momentum
                 temp = cont_rad_energy*gamma/( gamma*gamma-1. );
                 for( int i = 0 ; i<3 ; i++ ) {
                     momentum[i][ipart] -= temp*momentum[i][ipart];
                 }
-                
+
                 // Incrementation of the radiated energy cumulative parameter
                 radiated_energy += weight[ipart]*( gamma - sqrt( 1.0
                                                     + momentum[0][ipart]*momentum[0][ipart]
@@ -256,7 +379,12 @@ void RadiationMonteCarlo::operator()(
         }
 
     }
-    
+
+    // _______________________________________________________________
+    // Creation of all the macro-photons at once
+
+    createPhotons( position, weight );
+
     // ____________________________________________________
     // Update of the quantum parameter chi
     
@@ -281,12 +409,11 @@ void RadiationMonteCarlo::operator()(
 }
 
 // ---------------------------------------------------------------------------------------------------------------------
-//! Perform the photon emission (creation of a super-photon
-//! and slow down of the emitting particle)
+//! Perform the photon emission (slow down of the emitting particle).
+//! The super-photon is only recorded: all photons are created by createPhotons
 //! \param ipart              particle index
 //! \param particle_chi              particle quantum parameter
 //! \param particle_gamma            particle gamma factor
-//! \param position           particle position
 //! \param momentum           particle momentum
 //! \param RadiationTables    Cross-section data tables and useful functions
 //                        for nonlinear inverse Compton scattering
@@ -294,7 +421,6 @@ void RadiationMonteCarlo::operator()(
 double RadiationMonteCarlo::photonEmission( int ipart,
         double &particle_chi,
         double &particle_gamma,
-        double *position[3],
         double *momentum[3],
         double *weight,
         Species *photon_species,
@@ -306,112 +432,91 @@ double RadiationMonteCarlo::photonEmission( int ipart,
     double gammaph;    // Photon gamma factor
     double inv_old_norm_p;
     double radiated_energy = 0;
-    //double new_norm_p;
 
     // Get the photon quantum parameter from the table xip
-    // photon_chi = RadiationTables.computeRandomPhotonChi( particle_chi );
     photon_chi = RadiationTables.computeRandomPhotonChiWithInterpolation( particle_chi, rand_ );
 
     // compute the photon gamma factor
     gammaph = photon_chi/particle_chi*( particle_gamma-1.0 );
 
-    // ____________________________________________________
-    // Creation of the new photon
-
     // ____________________________________________________
     // Update of the particle properties
     // direction d'emission // direction de l'electron (1/gamma << 1)
     // With momentum conservation
-    
+
     inv_old_norm_p = gammaph/std::sqrt( particle_gamma*particle_gamma - 1.0 );
     momentum[0][ipart] -= momentum[0][ipart]*inv_old_norm_p;
     momentum[1][ipart] -= momentum[1][ipart]*inv_old_norm_p;
     momentum[2][ipart] -= momentum[2][ipart]*inv_old_norm_p;
 
-    // With energy conservation
-    /*inv_old_norm_p = 1./sqrt(particle_gamma*particle_gamma - 1.0);
-    particle_gamma -= gammaph;
-    new_norm_p = sqrt(particle_gamma*particle_gamma - 1.0);
-    px *= new_norm_p * inv_old_norm_p;
-    py *= new_norm_p * inv_old_norm_p;
-    pz *= new_norm_p * inv_old_norm_p;*/
-
-    // Creation of macro-photons if requested
+    // Macro-photons are recorded if requested
     // Check that the photon_species is defined and the threshold on the energy
     if( photon_species
             && ( gammaph >= radiation_photon_gamma_threshold_ ) ) {
-        /* ---------------------------------------------------------------------
-        // First method: emission of a single photon
 
-        // Creation of the new photon in the temporary array new_photons_
-        new_photons_.createParticle();
-
-        int idNew = new_photons_.size() - 1;
-
-        for (int i=0; i<n_dimensions_; i++) {
-            new_photons_.position(i,idNew)=position[i][ipart];
-        }
-
-        inv_old_norm_p = 1./sqrt(momentum[0][ipart]*momentum[0][ipart]
-                                + momentum[1][ipart]*momentum[1][ipart]
-                                + momentum[2][ipart]*momentum[2][ipart]);
+        // Inverse of the momentum norm
+        inv_old_norm_p = 1./sqrt( momentum[0][ipart]*momentum[0][ipart]
+                                  + momentum[1][ipart]*momentum[1][ipart]
+                                  + momentum[2][ipart]*momentum[2][ipart] );
 
-        for (unsigned int i=0; i<3; i++) {
-            new_photons_.momentum(i,idNew) =
-            gammaph*momentum[i][ipart]*inv_old_norm_p;
+        emission_index_.push_back( ipart );
+        emission_chi_.push_back( photon_chi );
+        for( int i=0; i<3; i++ ) {
+            emission_momentum_.push_back( gammaph*momentum[i][ipart]*inv_old_norm_p );
         }
 
-        new_photons_.weight(idNew)=weight[ipart];
-        new_photons_.charge(idNew)=0;
-        --------------------------------------------------------------------- */
-
-        // Second method: emission of several photons for statistics following
-        // the parameter radiation_photon_sampling_
+    }
+    // Addition of the emitted energy in the cumulating parameter
+    // for the scalar diagnostics
+    else {
+        gammaph = particle_gamma - sqrt( 1.0 + momentum[0][ipart]*momentum[0][ipart]
+                                         + momentum[1][ipart]*momentum[1][ipart]
+                                         + momentum[2][ipart]*momentum[2][ipart] );
+        radiated_energy += weight[ipart]*gammaph;
+    }
 
-        // Creation of new photons in the temporary array new_photons_
-        new_photons_.createParticles( radiation_photon_sampling_ );
+    return radiated_energy;
+}
 
-        // Final size
-        int npart = new_photons_.size();
+// ---------------------------------------------------------------------------------------------------------------------
+//! Create the macro-photons recorded by photonEmission in new_photons_,
+//! with radiation_photon_sampling_ macro-photons per emission
+//! \param position           particle position
+//! \param weight             particle weight
+// ---------------------------------------------------------------------------------------------------------------------
+void RadiationMonteCarlo::createPhotons( double *position[3], double *weight )
+{
+    int nemission = emission_index_.size();
+    if( nemission == 0 ) {
+        return;
+    }
 
-        // Inverse of the momentum norm
-        inv_old_norm_p = 1./sqrt( momentum[0][ipart]*momentum[0][ipart]
-                                  + momentum[1][ipart]*momentum[1][ipart]
-                                  + momentum[2][ipart]*momentum[2][ipart] );
+    // One allocation for all new photons
+    int istart = new_photons_.size();
+    new_photons_.createParticles( nemission*radiation_photon_sampling_ );
 
-        // For all new photons...
-        for( int idNew=npart-radiation_photon_sampling_; idNew<npart; idNew++ ) {
+    for( int iemission=0; iemission<nemission; iemission++ ) {
+        int ipart = emission_index_[iemission];
+        int first = istart + iemission*radiation_photon_sampling_;
+        for( int idNew=first; idNew<first+radiation_photon_sampling_; idNew++ ) {
             for( int i=0; i<n_dimensions_; i++ ) {
                 new_photons_.position( i, idNew )=position[i][ipart];
             }
 
             for( int i=0; i<3; i++ ) {
-                new_photons_.momentum( i, idNew ) =
-                    gammaph*momentum[i][ipart]*inv_old_norm_p;
+                new_photons_.momentum( i, idNew ) = emission_momentum_[3*iemission+i];
             }
 
             new_photons_.weight( idNew )=weight[ipart]*inv_radiation_photon_sampling_;
             new_photons_.charge( idNew )=0;
 
             if( new_photons_.isQuantumParameter ) {
-                new_photons_.chi( idNew ) = photon_chi;
+                new_photons_.chi( idNew ) = emission_chi_[iemission];
             }
 
             if( new_photons_.isMonteCarlo ) {
                 new_photons_.tau( idNew ) = -1.;
             }
-
         }
-
     }
-    // Addition of the emitted energy in the cumulating parameter
-    // for the scalar diagnostics
-    else {
-        gammaph = particle_gamma - sqrt( 1.0 + momentum[0][ipart]*momentum[0][ipart]
-                                         + momentum[1][ipart]*momentum[1][ipart]
-                                         + momentum[2][ipart]*momentum[2][ipart] );
-        radiated_energy += weight[ipart]*gammaph;
-    }
-    
-    return radiated_energy;
 }
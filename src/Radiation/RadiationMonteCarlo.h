@@ -58,12 +58,11 @@ public:
        );
         
     // ---------------------------------------------------------------------
-    //! Perform the phoon emission (creation of a super-photon
-    //! and slow down of the emitting particle)
+    //! Perform the phoon emission (slow down of the emitting particle
+    //! and record of the super-photon)
     //! \param ipart              particle index
     //! \param particle_chi          particle quantum parameter
     //! \param particle_gamma          particle gamma factor
-    //! \param position           particle position
     //! \param momentum           particle momentum
     //! \param RadiationTables    Cross-section data tables and useful functions
     //                        for nonlinear inverse Compton scattering
@@ -71,11 +70,17 @@ public:
     double photonEmission( int ipart,
                          double &particle_chi,
                          double &particle_gamma,
-                         double *position[3],
                          double *momentum[3],
                          double *weight,
                          Species *photon_species,
                          RadiationTables &RadiationTables );
+    
+    // ---------------------------------------------------------------------
+    //! Create all the super-photons recorded by photonEmission
+    //! \param position           particle position
+    //! \param weight             particle weight
+    // ---------------------------------------------------------------------
+    void createPhotons( double *position[3], double *weight );
                          
 protected:
 
@@ -99,6 +104,22 @@ protected:
     //! Espilon to check when tau is near 0
     const double epsilon_tau_ = 1e-100;
     
+    //! Index of the emitting particle, photon quantum parameter and
+    //! photon momentum (3 components) of each emission of the current call
+    std::vector<int> emission_index_;
+    std::vector<double> emission_chi_;
+    std::vector<double> emission_momentum_;
+    
+    //! Buffers for the particles of the current call: Lorentz factor and quantum parameter
+    //! at the beginning of the timestep, continuously radiated energy, flag for the Monte-Carlo process,
+    //! indices of the flagged particles and duration of their first Monte-Carlo iteration
+    std::vector<double> gamma_start_;
+    std::vector<double> chi_start_;
+    std::vector<double> rad_norm_energy_;
+    std::vector<int> discontinuous_;
+    std::vector<int> mc_index_;
+    std::vector<double> first_emission_time_;
+    
 private:
 
 };
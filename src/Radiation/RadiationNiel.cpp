@@ -219,9 +219,9 @@ void RadiationNiel::operator()(
     //double t2 = MPI_Wtime();
 
     // Computation of the diffusion coefficients
-    // Using the table (non-vectorized)
+    // Using the table (vectorized)
     if( niel_computation_method == "table" ) {
-        // #pragma omp simd
+        #pragma omp simd private(temp)
         for( ipart=0 ; ipart < nbparticles; ipart++ ) {
 
             // Below particle_chi = minimum_chi_continuous_, radiation losses are negligible
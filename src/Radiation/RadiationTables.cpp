@@ -10,8 +10,12 @@
 
 #include "RadiationTables.h"
 #include "RadiationTablesDefault.h"
+#include "QEDTablesGenerator.h"
 #include "H5.h"
 
+#include <sys/stat.h>
+#include <cstdio>
+
 // -----------------------------------------------------------------------------
 // INITILIZATION AND DESTRUCTION
 // -----------------------------------------------------------------------------
@@ -110,6 +114,28 @@ void RadiationTables::initialization( Params &params , SmileiMPI *smpi )
             // Path to the databases
             PyTools::extract( "table_path", table_path_, "RadiationReaction"  );
 
+            // Parameters of the tables generated at initialization
+            PyTools::extractV( "table_size", table_size_, "RadiationReaction" );
+            PyTools::extractV( "table_chi_range", table_chi_range_, "RadiationReaction" );
+            PyTools::extract( "table_xi_threshold", table_xi_threshold_, "RadiationReaction" );
+            PyTools::extract( "table_xi_power", table_xi_power_, "RadiationReaction" );
+            PyTools::extract( "table_cache_path", table_cache_path_, "RadiationReaction" );
+
+            if( table_size_.size() > 0 ) {
+                if( table_path_.size() > 0 ) {
+                    ERROR( "In RadiationReaction, `table_path` and `table_size` cannot be both defined" );
+                }
+                if( table_size_.size() != 2 || table_size_[0] < 2 || table_size_[1] < 2 ) {
+                    ERROR( "In RadiationReaction, `table_size` must be a list of 2 sizes above 1"
+                           << " [particle chi, photon chi]" );
+                }
+                if( table_chi_range_.size() != 2 || table_chi_range_[0] <= 0.
+                        || table_chi_range_[1] <= table_chi_range_[0] ) {
+                    ERROR( "In RadiationReaction, `table_chi_range` must be a list [min, max]"
+                           << " of 2 increasing positive values" );
+                }
+            }
+
             // Radiation threshold on the quantum parameter particle_chi
             PyTools::extract( "minimum_chi_continuous",
                               minimum_chi_continuous_, "RadiationReaction" );
@@ -170,6 +196,10 @@ void RadiationTables::initialization( Params &params , SmileiMPI *smpi )
     if( params.hasMCRadiation || params.hasNielRadiation ) {
         if (table_path_.size() > 0) {
             MESSAGE( 1,"Reading of the external database" );
+            table_file_ = table_path_ + "/radiation_tables.h5";
+            readTables( params, smpi );
+        } else if( table_size_.size() > 0 ) {
+            generateTables( smpi );
             readTables( params, smpi );
         } else {
             MESSAGE(1,"Default tables (stored in the code) are used:");
@@ -200,6 +230,10 @@ void RadiationTables::initialization( Params &params , SmileiMPI *smpi )
         MESSAGE( 2,"Maximum particle quantum parameter chi: "
                  << niel_.max_particle_chi_ );
     }
+
+    if( params.hasMCRadiation || params.hasNielRadiation ) {
+        compileTables();
+    }
 }
 
 
@@ -375,10 +409,10 @@ double RadiationTables::computeRandomPhotonChiWithInterpolation( double particle
 
     // If the randomly computed xi if below the first one of the row,
     // we take the first one which corresponds to the minimal photon photon_chi
-    if( xi <= xi_.table_[ichipa*xi_.size_photon_chi_] ) {
+    if( xi <= xi_.cdf_( ichipa, 0 ) ) {
         ichiph_1 = 0;
         ichiph_2 = 0;
-        xi = xi_.table_[ichipa*xi_.size_photon_chi_];
+        xi = xi_.cdf_( ichipa, 0 );
     }
     // Above the last xi of the row, the last one corresponds
     // to the maximal photon photon_chi
@@ -388,11 +422,9 @@ double RadiationTables::computeRandomPhotonChiWithInterpolation( double particle
     // If nearest point: ichiph = xi_.size_photon_chi_-1
     // }
     else {
-        // Search for the corresponding index ichiph for xi
-        ichiph_1 = userFunctions::searchValuesInMonotonicArray(
-                     &xi_.table_[ichipa*xi_.size_photon_chi_], xi, xi_.size_photon_chi_ );
-        ichiph_2 = userFunctions::searchValuesInMonotonicArray(
-                  &xi_.table_[(ichipa+1)*xi_.size_photon_chi_], xi, xi_.size_photon_chi_ );
+        // Index ichiph for xi from the inverse of the cumulative distribution
+        ichiph_1 = xi_.cdf_.find( ichipa, xi );
+        ichiph_2 = xi_.cdf_.find( ichipa+1, xi );
     }
 
     // Corresponding particle_chi for ichipa
@@ -471,74 +503,6 @@ double RadiationTables::computeRandomPhotonChiWithInterpolation( double particle
     return photon_chi;
 }
 
-// ---------------------------------------------------------------------------------------------------------------------
-//! Computation of the Cross Section dNph/dt which is also
-//! the number of photons generated per time unit.
-//
-//! \param particle_chi particle quantum parameter
-//! \param particle_gamma particle gamma factor
-// ---------------------------------------------------------------------------------------------------------------------
-double RadiationTables::computePhotonProductionYield( double particle_chi, double particle_gamma )
-{
-
-    // Log of the particle quantum parameter particle_chi
-    double logchipa;
-    double logchipam;
-    double logchipap;
-    // Index
-    int ichipa;
-    // final value
-    double dNphdt;
-
-    logchipa = std::log10( particle_chi );
-
-    // Lower index for interpolation in the table integfochi_
-    ichipa = int( floor( ( logchipa-integfochi_.log10_min_particle_chi_ )
-                         *integfochi_.inv_particle_chi_delta_ ) );
-
-    // If we are not in the table...
-    if( ichipa < 0 ) {
-        ichipa = 0;
-        dNphdt = integfochi_.table_[ichipa];
-    } else if( ichipa >= integfochi_.size_particle_chi_-1 ) {
-        ichipa = integfochi_.size_particle_chi_-2;
-        dNphdt = integfochi_.table_[ichipa];
-    } else {
-        // Upper and lower values for linear interpolation
-        logchipam = ichipa*integfochi_.particle_chi_delta_ + integfochi_.log10_min_particle_chi_;
-        logchipap = logchipam + integfochi_.particle_chi_delta_;
-
-        // Interpolation
-        dNphdt = ( integfochi_.table_[ichipa+1]*fabs( logchipa-logchipam ) +
-                   integfochi_.table_[ichipa]*fabs( logchipap - logchipa ) )*integfochi_.inv_particle_chi_delta_;
-    }
-
-    return factor_dNph_dt_*dNphdt*particle_chi/particle_gamma;
-
-}
-
-
-// -----------------------------------------------------------------------------
-//! Return the value of the function h(particle_chi) of Niel et al.
-//! from the computed table niel_.table
-//! \param particle_chi particle quantum parameter
-// -----------------------------------------------------------------------------
-double RadiationTables::getHNielFromTable( double particle_chi )
-{
-    int ichipa;
-    double d;
-
-    // Position in the niel_.table
-    d = ( std::log10( particle_chi )-niel_.log10_min_particle_chi_ )*niel_.inv_particle_chi_delta_;
-    ichipa = int( floor( d ) );
-
-    // distance for interpolation
-    d = d - floor( d );
-
-    // Linear interpolation
-    return niel_.table_[ichipa]*( 1.-d ) + niel_.table_[ichipa+1]*( d );
-}
-
 // -----------------------------------------------------------------------------
 //! Return the stochastic diffusive component of the pusher
 //! of Niel et al.
@@ -579,7 +543,7 @@ double RadiationTables::getHNielFromTable( double particle_chi )
 // -----------------------------------------------------------------------------
 void RadiationTables::readHTable( SmileiMPI *smpi )
 {
-    std::string file = table_path_ + "/radiation_tables.h5";
+    std::string file = table_file_;
     if( Tools::fileExists( file ) ) {
         if( smpi->isMaster() ) {
             H5Read f( file );
@@ -595,8 +559,8 @@ void RadiationTables::readHTable( SmileiMPI *smpi )
             f.vect( "h", niel_.table_ );
         }
     } else {
-        ERROR("The table H could not be read from the provided path: `"
-              << table_path_<<"`. Please check that the path is correct.")
+        ERROR("The table H could not be read from the file `"
+              << table_file_<<"`. Please check that the path is correct.")
     }
 
     // checks
@@ -617,7 +581,7 @@ void RadiationTables::readHTable( SmileiMPI *smpi )
 // -----------------------------------------------------------------------------
 void RadiationTables::readIntegfochiTable( SmileiMPI *smpi )
 {
-    std::string file = table_path_ + "/radiation_tables.h5";
+    std::string file = table_file_;
     if( Tools::fileExists( file ) ) {
         if( smpi->isMaster() ) {
             H5Read f( file );
@@ -638,8 +602,8 @@ void RadiationTables::readIntegfochiTable( SmileiMPI *smpi )
     }
     // Else, the table can not be found, we throw an error
     else {
-        ERROR("The table `integfochi` could not be read from the provided path: `"
-              << table_path_<<"`. Please check that the path is correct.")
+        ERROR("The table `integfochi` could not be read from the file `"
+              << table_file_<<"`. Please check that the path is correct.")
     }
 
 }
@@ -651,7 +615,7 @@ void RadiationTables::readIntegfochiTable( SmileiMPI *smpi )
 // -----------------------------------------------------------------------------
 void RadiationTables::readXiTable( SmileiMPI *smpi )
 {
-    std::string file = table_path_ + "/radiation_tables.h5";
+    std::string file = table_file_;
     if( Tools::fileExists( file ) ) {
         if( smpi->isMaster() ) {
             H5Read f( file );
@@ -676,8 +640,8 @@ void RadiationTables::readXiTable( SmileiMPI *smpi )
     }
     // Else, the table can not be found, we throw an error
     else {
-        ERROR("The table `xi` could not be read from the provided path: `"
-              << table_path_<<"`. Please check that the path is correct.")
+        ERROR("The table `xi` could not be read from the file `"
+              << table_file_<<"`. Please check that the path is correct.")
     }
 }
 
@@ -700,6 +664,85 @@ void RadiationTables::readTables( Params &params, SmileiMPI *smpi )
     }
 }
 
+// -----------------------------------------------------------------------------
+// TABLE GENERATION
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+//! Generate the tables with the parameters of the namelist, or find them in the
+//! cache. The tables are written by the master in the same format as the
+//! tool smilei_tables, and then read as external tables.
+//
+//! \param smpi Object of class SmileiMPI containing MPI properties
+// -----------------------------------------------------------------------------
+void RadiationTables::generateTables( SmileiMPI *smpi )
+{
+    std::ostringstream parameters;
+    parameters << "v1" << std::setprecision( 17 )
+               << " " << table_size_[0] << " " << table_size_[1]
+               << " " << table_chi_range_[0] << " " << table_chi_range_[1]
+               << " " << table_xi_threshold_ << " " << table_xi_power_;
+    table_file_ = QEDTablesGenerator::cacheFile( table_cache_path_, "radiation_tables", parameters.str() );
+
+    // The master decides for all ranks, which may not share the same view of the disk
+    int cached = smpi->isMaster() ? Tools::fileExists( table_file_ ) : 0;
+    MPI_Bcast( &cached, 1, MPI_INT, 0, smpi->world() );
+    if( cached ) {
+        MESSAGE( 1,"Reading of the cached tables `" << table_file_ << "`" );
+        return;
+    }
+
+    MESSAGE( 1,"Generation of the tables (" << table_size_[0] << " x " << table_size_[1] << ")" );
+    double t0 = MPI_Wtime();
+    std::vector<double> integfochi, h, min_photon_chi, xi;
+    QEDTablesGenerator::computeRadiationTables( table_size_[0], table_size_[1],
+            table_chi_range_[0], table_chi_range_[1], table_xi_power_, table_xi_threshold_,
+            smpi->world(), integfochi, h, min_photon_chi, xi );
+    MESSAGE( 2,"Done in " << MPI_Wtime() - t0 << " s" );
+
+    // The file is renamed once complete, so that a simulation running at the
+    // same time never reads a partial file
+    if( smpi->isMaster() ) {
+        mkdir( table_cache_path_.c_str(), 0755 );
+        std::string tmp_file = table_file_ + ".tmp";
+        {
+            H5Write f( tmp_file );
+            {
+                H5Write d = f.vect( "integfochi", integfochi );
+                d.attr( "min_particle_chi", table_chi_range_[0] );
+                d.attr( "max_particle_chi", table_chi_range_[1] );
+                d.attr( "size_particle_chi", table_size_[0] );
+            }
+            {
+                H5Write d = f.vect( "h", h );
+                d.attr( "min_particle_chi", table_chi_range_[0] );
+                d.attr( "max_particle_chi", table_chi_range_[1] );
+                d.attr( "size_particle_chi", table_size_[0] );
+            }
+            {
+                H5Write d = f.vect( "min_photon_chi_for_xi", min_photon_chi );
+                d.attr( "min_particle_chi", table_chi_range_[0] );
+                d.attr( "max_particle_chi", table_chi_range_[1] );
+                d.attr( "size_particle_chi", table_size_[0] );
+                d.attr( "power", table_xi_power_ );
+                d.attr( "threshold", table_xi_threshold_ );
+            }
+            {
+                H5Write d = f.vect( "xi", xi );
+                d.attr( "min_particle_chi", table_chi_range_[0] );
+                d.attr( "max_particle_chi", table_chi_range_[1] );
+                d.attr( "size_particle_chi", table_size_[0] );
+                d.attr( "size_photon_chi", table_size_[1] );
+            }
+        }
+        if( std::rename( tmp_file.c_str(), table_file_.c_str() ) != 0 ) {
+            ERROR( "The generated tables could not be written in `" << table_file_ << "`" );
+        }
+        MESSAGE( 1,"Tables saved in `" << table_file_ << "`" );
+    }
+    MPI_Barrier( smpi->world() );
+}
+
 // -----------------------------------------------------------------------------
 // TABLE COMMUNICATIONS
 // -----------------------------------------------------------------------------
@@ -1029,3 +1072,17 @@ void RadiationTables::bcastTableXi( SmileiMPI *smpi )
     // }
     // -----------------------------------------------------------------------
 }
+
+// -----------------------------------------------------------------------------
+//! Compile the tables into the layouts used by the operators:
+//! interleaved (value, slope) for integfochi and h,
+//! indexed cumulative distribution functions for xi
+// -----------------------------------------------------------------------------
+void RadiationTables::compileTables()
+{
+    integfochi_.lookup_.set( integfochi_.table_,
+                             integfochi_.min_particle_chi_, integfochi_.max_particle_chi_ );
+    niel_.lookup_.set( niel_.table_,
+                       niel_.min_particle_chi_, niel_.max_particle_chi_ );
+    xi_.cdf_.set( xi_.table_, xi_.size_particle_chi_, xi_.size_photon_chi_ );
+}
@@ -24,6 +24,7 @@
 #include "RadiationTools.h"
 #include "H5.h"
 #include "Random.h"
+#include "LookupTable.h"
 
 //------------------------------------------------------------------------------
 //! RadiationTables class: holds parameters, tables and functions to compute
@@ -53,7 +54,11 @@ public:
     
     //! Computation of the photon production yield dNph/dt which is
     //! also the cross-section for the Monte-Carlo
-    double computePhotonProductionYield( double particle_chi, double particle_gamma );
+    //! (inline so that it can be vectorized in the loops on particles)
+    inline double computePhotonProductionYield( double particle_chi, double particle_gamma )
+    {
+        return factor_dNph_dt_*integfochi_.lookup_( std::log10( particle_chi ) )*particle_chi/particle_gamma;
+    };
 
     //! Determine randomly a photon quantum parameter photon_chi
     //! for an emission process
@@ -77,8 +82,12 @@ public:
 
     //! Return the value of the function h(particle_chi) of Niel et al.
     //! from the computed table niel_.table
+    //! (inline so that it can be vectorized in the loops on particles)
     //! \param particle_chi particle quantum parameter
-    double getHNielFromTable( double particle_chi );
+    inline double getHNielFromTable( double particle_chi )
+    {
+        return niel_.lookup_( std::log10( particle_chi ) );
+    };
 
     //! Return the stochastic diffusive component of the pusher
     //! of Niel et al.
@@ -157,6 +166,15 @@ public:
     //! \param smpi Object of class SmileiMPI containing MPI properties
     void readTables( Params &params, SmileiMPI *smpi );
 
+    // ---------------------------------------------------------------------
+    // TABLE GENERATION
+    // ---------------------------------------------------------------------
+
+    //! Generate the tables with the parameters of the namelist, or find them
+    //! in the cache, and set the file from which they are read
+    //! \param smpi Object of class SmileiMPI containing MPI properties
+    void generateTables( SmileiMPI *smpi );
+
     // ---------------------------------------------------------------------
     // TABLE COMMUNICATIONS
     // ---------------------------------------------------------------------
@@ -173,6 +191,10 @@ public:
     //! \param smpi Object of class SmileiMPI containing MPI properties
     void bcastTableXi( SmileiMPI *smpi );
 
+    //! Compile the tables into the layouts used by the operators
+    //! (see LookupTable.h)
+    void compileTables();
+
     // ---------------------------------------------
     // Table h for the
     // stochastic diffusive operator of Niel et al.
@@ -204,6 +226,9 @@ public:
         
         //! Dimension of the array h
         int size_particle_chi_;
+
+        //! Compiled table for the interpolation
+        LogTable lookup_;
         
     };
     
@@ -239,6 +264,9 @@ public:
 
         //! Inverse delta chi for the table integfochi_table
         double inv_particle_chi_delta_;
+
+        //! Compiled table for the interpolation
+        LogTable lookup_;
         
     };
     
@@ -285,6 +313,9 @@ public:
         //! 1/(xi_.size_photon_chi_ - 1)
         double inv_size_photon_chi_minus_one_;
 
+        //! Compiled table to invert the cumulative distribution functions
+        CDFTable cdf_;
+
         //! xip power
         // double power_;
 
@@ -306,6 +337,25 @@ private:
     //! Path to the tables
     std::string table_path_;
 
+    //! File from which the tables are read
+    std::string table_file_;
+
+    //! Sizes [particle chi, photon chi] of the tables generated at initialization
+    //! (empty if the tables are not generated)
+    std::vector<int> table_size_;
+
+    //! Particle chi range of the generated tables
+    std::vector<double> table_chi_range_;
+
+    //! Threshold on xi for the minimum photon chi of the generated tables
+    double table_xi_threshold_;
+
+    //! Number of digits of the minimum photon chi of the generated tables
+    double table_xi_power_;
+
+    //! Directory of the cache of the generated tables
+    std::string table_cache_path_;
+
     //! Flag that activate the table computation
     bool compute_table_;
 
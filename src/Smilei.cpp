@@ -374,6 +374,7 @@ int main( int argc, char *argv[] )
                 if( params.keep_python_running_ ) {
                     PyTools::setIteration( itime ); // sets python variable "Main.iteration" for users
                 }
+                vecPatches.resetRandom( itime );
             }
 
             // Patch reconfiguration
@@ -564,7 +565,8 @@ int main( int argc, char *argv[] )
             
         } //End omp parallel region
         
-        if( params.has_load_balancing && params.load_balancing_time_selection->theTimeIsNow( itime ) ) {
+        if( params.has_load_balancing && params.load_balancing_time_selection->theTimeIsNow( itime )
+            && smpi.needs_load_balancing( params, vecPatches, itime ) ) {
             count_dlb++;
             if (params.multiple_decomposition && count_dlb%5 ==0 ) {
                 if ( params.geometry != "AMcylindrical" ) {
@@ -126,6 +126,7 @@ void SmileiMPI::init( Params &params, DomainDecomposition *domain_decomposition
     patch_count.resize( smilei_sz, 0 );
     capabilities.resize( smilei_sz, 1 );
     Tcapabilities = smilei_sz;
+    init_nodes( params );
 
     if( smilei_rk == 0 ) {
         remove( "patch_load.txt" ) ;
@@ -133,6 +134,7 @@ void SmileiMPI::init( Params &params, DomainDecomposition *domain_decomposition
     // Initialize patch distribution
     if( !params.restart ) {
         init_patch_count( params, domain_decomposition );
+        report_halo_exchange( params, domain_decomposition );
     }
 
     // Initialize buffers for particles push vectorization
@@ -413,6 +415,56 @@ void SmileiMPI::init_patch_count( Params &params, DomainDecomposition *domain_de
 } // END init_patch_count
 
 
+// ---------------------------------------------------------------------------------------------------------------------
+//  Evaluate the communication volume of the current patch distribution:
+//  faces of the local patches shared with patches owned by other MPI ranks
+// ---------------------------------------------------------------------------------------------------------------------
+void SmileiMPI::report_halo_exchange( Params &params, DomainDecomposition *domain_decomposition )
+{
+    unsigned int ndim = params.nDim_field;
+    int first_patch = patch_refHindexes[smilei_rk];
+    int last_patch = first_patch + patch_count[smilei_rk];
+
+    double cells_per_patch = 1.;
+    for( unsigned int idim=0; idim<ndim; idim++ ) {
+        cells_per_patch *= params.n_space[idim];
+    }
+
+    // Surface (in cells) of the local domain facing other ranks, and bytes sent per field
+    double surface = 0., halo_bytes = 0.;
+    for( int h=first_patch; h<last_patch; h++ ) {
+        vector<unsigned int> coords = domain_decomposition->getDomainCoordinates( h );
+        vector<int> xcall( coords.begin(), coords.end() );
+        for( unsigned int idim=0; idim<ndim; idim++ ) {
+            double face = cells_per_patch / params.n_space[idim];
+            for( int side=-1; side<=1; side+=2 ) {
+                xcall[idim] = coords[idim] + side;
+                if( params.EM_BCs[idim][0]=="periodic" ) {
+                    xcall[idim] = ( xcall[idim] + domain_decomposition->ndomain_[idim] ) % domain_decomposition->ndomain_[idim];
+                }
+                int neighbor = domain_decomposition->getDomainId( xcall );
+                if( neighbor != MPI_PROC_NULL && ( neighbor < first_patch || neighbor >= last_patch ) ) {
+                    surface += face;
+                    halo_bytes += face * params.oversize[idim] * sizeof( double );
+                }
+            }
+            xcall[idim] = coords[idim];
+        }
+    }
+    double ratio = surface / ( patch_count[smilei_rk] * cells_per_patch );
+
+    double sums_loc[2] = { ratio, halo_bytes }, sums[2], max_loc[2] = { ratio, halo_bytes }, maxs[2];
+    MPI_Reduce( sums_loc, sums, 2, MPI_DOUBLE, MPI_SUM, 0, world_ );
+    MPI_Reduce( max_loc, maxs, 2, MPI_DOUBLE, MPI_MAX, 0, world_ );
+
+    MESSAGE( 1, "Patch arrangement: " << params.patch_arrangement );
+    MESSAGE( 1, "Surface-to-volume ratio of the MPI domains: mean = " << sums[0]/smilei_sz << ", max = " << maxs[0] );
+    MESSAGE( 1, "Estimated halo exchange between ranks for each field: total = "
+             << ( long )sums[1] << " bytes, max per rank = " << ( long )maxs[1] << " bytes" );
+
+} // END report_halo_exchange
+
+
 // ---------------------------------------------------------------------------------------------------------------------
 //  Recompute patch distribution
 // ---------------------------------------------------------------------------------------------------------------------
@@ -443,6 +495,46 @@ void SmileiMPI::recompute_patch_count( Params &params, VectorPatch &vecpatches,
     unsigned int tot_species_number = vecpatches( 0 )->vecSpecies.size();
     cells_load = ncells_perpatch*params.cell_load ;
 
+    //Estimate the particle contribution to the load of each patch
+    std::vector<double> Lpart( patch_count[smilei_rk], 0. );
+    for( unsigned int ipatch=0; ipatch < ( unsigned int )patch_count[smilei_rk]; ipatch++ ) {
+        for( unsigned int ispecies = 0; ispecies < tot_species_number; ispecies++ ) {
+            Lpart[ipatch] += vecpatches( ipatch )->vecSpecies[ispecies]->getNbrOfParticles()*( 1+( params.frozen_particle_load-1 )*( time_dual < vecpatches( ipatch )->vecSpecies[ispecies]->time_frozen_ ) ) ;
+        }
+    }
+
+    //With measured loads, the particle contribution is replaced by the smoothed compute time of the patch,
+    //converted in units of particle load. Patches which have not been measured yet keep the estimate.
+    if( params.load_model == "timers" ) {
+        double sums_loc[2] = {0., 0.}, sums[2];
+        for( unsigned int ipatch=0; ipatch < ( unsigned int )patch_count[smilei_rk]; ipatch++ ) {
+            Patch *patch = vecpatches( ipatch );
+            if( patch->load_timer_ > 0. ) {
+                if( patch->measured_load_ < 0. ) {
+                    patch->measured_load_ = patch->load_timer_;
+                } else {
+                    patch->measured_load_ = params.load_smoothing * patch->load_timer_ + ( 1.-params.load_smoothing ) * patch->measured_load_;
+                }
+            }
+            if( patch->measured_load_ >= 0. ) {
+                sums_loc[0] += patch->measured_load_;
+                sums_loc[1] += Lpart[ipatch];
+            }
+        }
+        MPI_Allreduce( sums_loc, sums, 2, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD );
+        //sums[0]/sums[1] = compute time of a particle. Fallback to the estimate if it cannot be evaluated.
+        if( sums[0] > 0. && sums[1] > 0. ) {
+            for( unsigned int ipatch=0; ipatch < ( unsigned int )patch_count[smilei_rk]; ipatch++ ) {
+                if( vecpatches( ipatch )->measured_load_ >= 0. ) {
+                    Lpart[ipatch] = vecpatches( ipatch )->measured_load_ * sums[1] / sums[0];
+                }
+            }
+        }
+    }
+    for( unsigned int ipatch=0; ipatch < ( unsigned int )patch_count[smilei_rk]; ipatch++ ) {
+        vecpatches( ipatch )->load_timer_ = 0.;
+    }
+
     Lp.resize( patch_count[smilei_rk] );
     if( smilei_rk > 0 ) {
         Lp_left.resize( patch_count[smilei_rk-1] );
@@ -457,15 +549,9 @@ void SmileiMPI::recompute_patch_count( Params &params, VectorPatch &vecpatches,
 
         Tload_loc = 0.;
         Ncur = 0; // Variation of the number of patches assigned to current rank r.
+        //Local Loads of each Patch (Lp) = cells + particles contributions
         for( unsigned int ipatch=0; ipatch < ( unsigned int )patch_count[smilei_rk]; ipatch++ ) {
-            Lp[ipatch] =  cells_load ;
-        }
-
-        //Compute particle contribution to Local Loads of each Patch (Lp)
-        for( unsigned int ipatch=0; ipatch < ( unsigned int )patch_count[smilei_rk]; ipatch++ ) {
-            for( unsigned int ispecies = 0; ispecies < tot_species_number; ispecies++ ) {
-                Lp[ipatch] += vecpatches( ipatch )->vecSpecies[ispecies]->getNbrOfParticles()*( 1+( params.frozen_particle_load-1 )*( time_dual < vecpatches( ipatch )->vecSpecies[ispecies]->time_frozen_ ) ) ;
-            }
+            Lp[ipatch] = cells_load + Lpart[ipatch];
             Tload_loc += Lp[ipatch];
         }
 
@@ -511,11 +597,21 @@ void SmileiMPI::recompute_patch_count( Params &params, VectorPatch &vecpatches,
         MPI_Wait( &request0, &status );
     }
 
+    //Optimal begining and end of the current rank on the curve
+    double target_left = smilei_rk*Tload, target_right = ( smilei_rk+1 )*Tload;
+    if( params.hierarchical_load_balancing ) {
+        double node_imbalance = hierarchical_targets( params, Tload_loc, target_left, target_right );
+        if( smilei_rk==0 ) {
+            fout << "\tnode imbalance = " << node_imbalance
+                 << ( node_imbalance > params.node_imbalance_tolerance ? " : patches move between nodes" : " : balancing inside nodes only" ) << endl;
+        }
+    }
+
     if( smilei_rk > 0 ) {
         //Tcur is now initialized as the total load currently carried by previous ranks.
         Tcur = Tscan - Tload_loc;
         //Check if my rank should start with additional patches from left neighbour.
-        target = smilei_rk*Tload; //target here points at the optimal begining for current rank
+        target = target_left; //target here points at the optimal begining for current rank
         if( Tcur > target ) {
             j = Lp_left.size()-1;
             while( abs( Tcur-target ) > abs( Tcur-Lp_left[j] - target ) && j>0 ) { //Leave at least 1 patch to my neighbour.
@@ -537,7 +633,7 @@ void SmileiMPI::recompute_patch_count( Params &params, VectorPatch &vecpatches,
     if( smilei_rk < smilei_sz-1 ) {
         //Tcur is now initialized as the total load carried by previous ranks + my load.
         Tcur = Tscan;
-        target = ( smilei_rk+1 )*Tload;
+        target = target_right;
 
         //Check if my rank should start with additional patches from right neighbour ...
         if( Tcur < target ) {
@@ -585,6 +681,137 @@ void SmileiMPI::recompute_patch_count( Params &params, VectorPatch &vecpatches,
 } // END recompute_patch_count
 
 
+// ---------------------------------------------------------------------------------------------------------------------
+//  Find the node of each MPI process. Nodes are either detected (shared memory) or simulated by groups of ranks.
+// ---------------------------------------------------------------------------------------------------------------------
+void SmileiMPI::init_nodes( Params &params )
+{
+    rank_node.resize( smilei_sz, 0 );
+    if( !params.has_load_balancing || !params.hierarchical_load_balancing ) {
+        return;
+    }
+
+    // The node is identified by its first rank
+    int node_leader;
+    if( params.ranks_per_node > 0 ) {
+        node_leader = ( smilei_rk / params.ranks_per_node ) * params.ranks_per_node;
+    } else {
+        MPI_Comm node_comm;
+        MPI_Comm_split_type( world_, MPI_COMM_TYPE_SHARED, smilei_rk, MPI_INFO_NULL, &node_comm );
+        MPI_Allreduce( &smilei_rk, &node_leader, 1, MPI_INT, MPI_MIN, node_comm );
+        MPI_Comm_free( &node_comm );
+    }
+    vector<int> leaders( smilei_sz );
+    MPI_Allgather( &node_leader, 1, MPI_INT, &leaders[0], 1, MPI_INT, world_ );
+
+    // Ranks of a node must be consecutive, otherwise the curve cannot be cut per node
+    for( int rk=1; rk<smilei_sz; rk++ ) {
+        if( leaders[rk] == leaders[rk-1] ) {
+            rank_node[rk] = rank_node[rk-1];
+        } else if( leaders[rk] == rk ) {
+            rank_node[rk] = rank_node[rk-1]+1;
+        } else {
+            WARNING( "Ranks of a node are not consecutive: load balancing ignores nodes" );
+            rank_node.assign( smilei_sz, 0 );
+            break;
+        }
+    }
+}
+
+
+// ---------------------------------------------------------------------------------------------------------------------
+//  The boundaries between nodes are kept where they are, unless the load of the nodes is too unbalanced.
+//  Inside a node, the load is shared evenly between ranks. Returns the node imbalance.
+// ---------------------------------------------------------------------------------------------------------------------
+double SmileiMPI::hierarchical_targets( Params &params, double Tload_loc, double &target_left, double &target_right )
+{
+    vector<double> rank_load( smilei_sz );
+    MPI_Allgather( &Tload_loc, 1, MPI_DOUBLE, &rank_load[0], 1, MPI_DOUBLE, world_ );
+
+    unsigned int nnodes = rank_node.back()+1;
+    vector<double> node_load( nnodes, 0. ), node_start( nnodes+1, 0. );
+    vector<int> node_first( nnodes, 0 ), node_size( nnodes, 0 );
+    double total_load = 0.;
+    for( int rk=0; rk<smilei_sz; rk++ ) {
+        int n = rank_node[rk];
+        if( node_size[n] == 0 ) {
+            node_first[n] = rk;
+            node_start[n] = total_load;
+        }
+        node_size[n]++;
+        node_load[n] += rank_load[rk];
+        total_load += rank_load[rk];
+    }
+    node_start[nnodes] = total_load;
+
+    // Load of the most loaded node relative to its share
+    double node_imbalance = 0.;
+    for( unsigned int n=0; n<nnodes; n++ ) {
+        node_imbalance = max( node_imbalance, node_load[n] * smilei_sz / ( total_load * node_size[n] ) - 1. );
+    }
+    if( node_imbalance > params.node_imbalance_tolerance ) {
+        for( unsigned int n=0; n<nnodes; n++ ) {
+            node_start[n] = total_load * node_first[n] / smilei_sz;
+        }
+    }
+
+    int n = rank_node[smilei_rk];
+    double node_target = node_start[n+1] - node_start[n];
+    target_left  = node_start[n] + node_target * ( smilei_rk   - node_first[n] ) / node_size[n];
+    target_right = node_start[n] + node_target * ( smilei_rk+1 - node_first[n] ) / node_size[n];
+
+    return node_imbalance;
+}
+
+
+// ---------------------------------------------------------------------------------------------------------------------
+//  Adaptive load balancing : compare the time lost in imbalance to the cost of moving the patches
+// ---------------------------------------------------------------------------------------------------------------------
+bool SmileiMPI::needs_load_balancing( Params &params, VectorPatch &vecpatches, int itime )
+{
+    if( ! params.adaptive_load_balancing ) {
+        return true;
+    }
+
+    //Measured compute time per iteration and memory of the local patches
+    int niterations = max( itime - ( int )vecpatches.lastIterationLoadBalance, 1 );
+    double local[2] = {0., 0.}, global_max[2], global_sum;
+    for( unsigned int ipatch=0; ipatch < vecpatches.size(); ipatch++ ) {
+        local[0] += vecpatches( ipatch )->load_timer_;
+        local[1] += vecpatches( ipatch )->EMfields->getMemFootPrint();
+        for( unsigned int ispec=0; ispec < vecpatches( ipatch )->vecSpecies.size(); ispec++ ) {
+            local[1] += vecpatches( ipatch )->vecSpecies[ispec]->getMemFootPrint();
+        }
+    }
+    local[0] /= niterations;
+
+    MPI_Allreduce( local, global_max, 2, MPI_DOUBLE, MPI_MAX, world_ );
+    MPI_Allreduce( &local[0], &global_sum, 1, MPI_DOUBLE, MPI_SUM, world_ );
+
+    double mean_load = global_sum / smilei_sz;
+    if( global_max[0] <= 0. ) {
+        return false;
+    }
+    //Time lost waiting for the most loaded rank during the next iterations
+    double gain = params.load_balancing_horizon * ( global_max[0] - mean_load );
+    //Time to send away the excess of data of the most loaded rank
+    double cost = ( global_max[0] - mean_load ) / global_max[0] * global_max[1] / params.migration_bandwidth;
+
+    bool balance = gain > cost;
+
+    if( isMaster() ) {
+        ofstream fout;
+        fout.open( "patch_load.txt", std::ofstream::out | std::ofstream::app );
+        fout << "\titeration " << itime << ": imbalance = " << global_max[0]/mean_load
+             << ", expected gain = " << gain << " s, migration cost = " << cost << " s"
+             << ( balance ? "" : " (skipped)" ) << endl;
+        fout.close();
+    }
+
+    return balance;
+}
+
+
 // ----------------------------------------------------------------------
 // Returns the rank of the MPI process currently owning patch h.
 // ----------------------------------------------------------------------
@@ -721,6 +948,10 @@ void SmileiMPI::isend_species( Patch *patch, int to, int &maxtag, int tag, Param
     } else {
         patch->buffer_scalars.resize( 2*nspec );
     }
+    // Measured load of the patch
+    if( params.has_load_balancing ) {
+        patch->buffer_scalars.push_back( patch->measured_load_ );
+    }
     unsigned int i = 0;
     // Energy lost at boundaries
     for( unsigned int ispec=0; ispec<nspec; ispec++ ) {
@@ -852,6 +1083,9 @@ void SmileiMPI::recv_species( Patch *patch, int from, int &tag, Params &params )
     } else {
         patch->buffer_scalars.resize( 2*nspec );
     }
+    if( params.has_load_balancing ) {
+        patch->buffer_scalars.resize( patch->buffer_scalars.size()+1 );
+    }
     MPI_Status status;
     MPI_Recv( &patch->buffer_scalars[0], patch->buffer_scalars.size(), MPI_DOUBLE, from, tag, world_, &status );
     tag++;
@@ -873,6 +1107,11 @@ void SmileiMPI::recv_species( Patch *patch, int from, int &tag, Params &params )
             i++;
         }
     }
+    // Measured load of the patch
+    if( params.has_load_balancing ) {
+        patch->measured_load_ = patch->buffer_scalars[i];
+        i++;
+    }
     
 }
 
@@ -54,9 +54,17 @@ public:
 
     // Initialize the patch_count vector. Patches are distributed in order to balance the load between MPI processes.
     virtual void init_patch_count( Params &params, DomainDecomposition *domain_decomposition );
+    // Print the surface-to-volume ratio of the MPI domains and the estimated size of the halo exchanges between ranks
+    void report_halo_exchange( Params &params, DomainDecomposition *domain_decomposition );
 
     // Recompute the patch_count vector. Browse patches and redistribute them in order to balance the load between MPI processes.
     void recompute_patch_count( Params &params, VectorPatch &vecpatches, double time_dual );
+    // Tells if the measured load imbalance is worth a load balancing (always true when not adaptive)
+    bool needs_load_balancing( Params &params, VectorPatch &vecpatches, int itime );
+    // Find the node hosting each MPI process, for the hierarchical load balancing
+    void init_nodes( Params &params );
+    // Target loads at the boundaries of the current rank when the curve is first cut per node, then per rank
+    double hierarchical_targets( Params &params, double Tload_loc, double &target_left, double &target_right );
     // Returns the rank of the MPI process currently owning patch h.
     int hrank( int h );
 
@@ -277,6 +285,8 @@ protected:
     //Number of patches owned by each mpi process.
     std::vector<int>  patch_count, capabilities, patch_refHindexes;
     int Tcapabilities; //Default = smilei_sz (1 per MPI rank)
+    //Node index of each mpi process (nodes hold consecutive ranks)
+    std::vector<int> rank_node;
 };
 
 
@@ -38,6 +38,8 @@ PartBoundCond::PartBoundCond( Params &params, Species *species, Patch *patch ) :
     bc_zmax  = NULL;
 
     dt_ = params.timestep;
+
+    delete_weightless_ = ( species->Multiphoton_Breit_Wheeler_process != NULL );
     
     // -----------------------------
     // Define limits of local domain
@@ -41,8 +41,17 @@ public:
     //! Be careful, once an a BC along a given dimension set keep_part to 0, it will remain to 0.
     inline void apply( Particles &particles, SmileiMPI* smpi, int imin, int imax, Species *species, int ithread, double &nrj_tot )
     {
-        for (int ipart=imin ; ipart<imax ; ipart++ ) {
-            particles.cell_keys[ipart] = 0;
+        if( delete_weightless_ ) {
+            // Photons decayed into pairs (weight set to 0) are deleted
+            // with the particles leaving the domain
+            double *weight = particles.getPtrWeight();
+            for (int ipart=imin ; ipart<imax ; ipart++ ) {
+                particles.cell_keys[ipart] = ( weight[ipart] > 0 ) ? 0 : -1;
+            }
+        } else {
+            for (int ipart=imin ; ipart<imax ; ipart++ ) {
+                particles.cell_keys[ipart] = 0;
+            }
         }
 
         double nrj_iPart = 0.;
@@ -91,6 +100,10 @@ private:
 
     double dt_;
 
+    //! Particles with a weight <= 0 are flagged for deletion (cell_keys = -1)
+    //! (photons decayed by the multiphoton Breit-Wheeler process)
+    bool delete_weightless_;
+
 };
 
 #endif
@@ -52,6 +52,7 @@ using namespace std;
 Species::Species( Params &params, Patch *patch ) :
     c_part_max_( 1 ),
     ionization_rate_( Py_None ),
+    ionization_rate_table_( Py_None ),
     pusher_name_( "boris" ),
     radiation_model_( "none" ),
     time_frozen_( 0 ),
@@ -113,6 +114,9 @@ Species::Species( Params &params, Patch *patch ) :
 
     merge_min_momentum_cell_length_.resize(3);
 
+    merge_adaptive_ = false;
+    merge_max_particles_per_step_ = 0;
+
     particles_to_move = new Particles();
 
 }//END Species creator
@@ -321,6 +325,9 @@ Species::~Species()
     if( ionization_rate_!=Py_None ) {
         Py_DECREF( ionization_rate_ );
     }
+    if( ionization_rate_table_!=Py_None ) {
+        Py_DECREF( ionization_rate_table_ );
+    }
 
 }
 
@@ -451,10 +458,6 @@ void Species::dynamics( double time_dual, unsigned int ispec,
                         particles->first_index[ibin],
                         particles->last_index[ibin],
                         ithread );
-                
-                // Suppression of the decayed photons into pairs
-                Multiphoton_Breit_Wheeler_process->decayed_photon_cleaning(
-                    *particles, smpi, ibin, particles->first_index.size(), &particles->first_index[0], &particles->last_index[0], ithread );
                     
 #ifdef  __DETAILED_TIMERS
                 patch->patch_timers[6] += MPI_Wtime() - timer;
@@ -772,6 +775,10 @@ void Species::extractParticles()
     particles_to_move->clear();
     for ( int ipart=0 ; ipart<(int)(getNbrOfParticles()) ; ipart++ ) {
         if ( particles->cell_keys[ipart] == -1 ) {
+            // Photons decayed into pairs (weight set to 0) are only deleted
+            if( Multiphoton_Breit_Wheeler_process && particles->weight( ipart ) <= 0 ) {
+                continue;
+            }
             particles->copyParticle( ipart, *particles_to_move );
         }
     }
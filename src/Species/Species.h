@@ -76,6 +76,15 @@ public:
     //! user defined ionization rate profile
     PyObject *ionization_rate_;
 
+    //! user defined ionization rate sampled at initialization (numpy array), or None
+    PyObject *ionization_rate_table_;
+
+    //! particle attribute of each axis of ionization_rate_table_
+    std::vector<std::string> ionization_rate_axes_;
+
+    //! min, max and number of points of each axis of ionization_rate_table_
+    std::vector<std::vector<double> > ionization_rate_ranges_;
+
     //! thermalizing temperature for thermalizing BCs [\f$m_e c^2\f$]
     std::vector<double> thermal_boundary_temperature_;
     //! mean velocity used when thermalizing BCs are used [\f$c\f$]
@@ -282,6 +291,16 @@ public:
     //! Minimum momentum value in log scale
     double merge_min_momentum_log_scale_;
 
+    //! Merge at each timestep the cells that exceed merge_min_particles_per_cell_,
+    //! instead of following merging_time_selection_
+    bool merge_adaptive_;
+
+    //! Maximum number of particles merged in each patch at each merging step (0: no limit)
+    unsigned int merge_max_particles_per_step_;
+
+    //! Number of particles of each cell after its last merging (adaptive merging)
+    std::vector<int> merge_count_after_;
+
     //! Local minimum of MPI domain
     double min_loc;
 
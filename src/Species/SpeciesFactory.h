@@ -399,6 +399,10 @@ public:
                        << "must be above or equal to 4");
             }
             
+            // Adaptive triggering, and limit on the merging work
+            PyTools::extract( "merge_adaptive", this_species->merge_adaptive_ , "Species", ispec );
+            PyTools::extract( "merge_max_particles_per_step", this_species->merge_max_particles_per_step_ , "Species", ispec );
+
             // Read flag to activate the accumulation correction
             PyTools::extract( "merge_accumulation_correction", this_species->merge_accumulation_correction_ , "Species", ispec );
 
@@ -452,8 +456,17 @@ public:
         if( this_species->merging_method_ != "none" ) {
             MESSAGE( 2, "> Particle merging with the method: "
                      << this_species->merging_method_ );
-            MESSAGE( 3, "| Merging time selection: "
-                     << this_species->merging_time_selection_->info() );
+            if( this_species->merge_adaptive_ ) {
+                MESSAGE( 3, "| Adaptive merging: cells above "
+                         << this_species->merge_min_particles_per_cell_ << " particles at each timestep" );
+            } else {
+                MESSAGE( 3, "| Merging time selection: "
+                         << this_species->merging_time_selection_->info() );
+            }
+            if( this_species->merge_max_particles_per_step_ > 0 ) {
+                MESSAGE( 3, "| Maximum particles merged per patch and per step: "
+                         << this_species->merge_max_particles_per_step_ );
+            }
             if (this_species->merge_log_scale_) {
                 MESSAGE( 3, "| Discretization scale: log");
                 MESSAGE( 3, "| Minimum momentum: " << std::scientific << std::setprecision(5)
@@ -789,17 +802,52 @@ public:
                     this_species->ionization_rate_ = PyTools::extract_py( "ionization_rate", "Species", ispec );
                     if( this_species->ionization_rate_ == Py_None ) {
                         ERROR( "For species '" << species_name << " ionization 'from_rate' requires 'ionization_rate' " );
-                    } else {
+                    }
+                    // Optional grid on which the rate is sampled once, then interpolated without python
+                    std::vector<PyObject *> py_axes = PyTools::extract_pyVec( "ionization_rate_table", "Species", ispec );
+                    for( unsigned int iaxis=0; iaxis<py_axes.size(); iaxis++ ) {
+                        std::ostringstream axis_prefix( "" );
+                        axis_prefix << "For species '" << species_name << "': ionization_rate_table axis #" << iaxis;
+                        std::vector<PyObject *> py_axis;
+                        std::string attribute;
+                        double min, max;
+                        int npoints;
+                        if( ! PyTools::py2pyvector( py_axes[iaxis], py_axis ) || py_axis.size() != 4 ) {
+                            ERROR( axis_prefix.str() << " must be a list [attribute, min, max, number_of_points]" );
+                        }
+                        if( ! PyTools::py2scalar( py_axis[0], attribute )
+                         || ( attribute!="x" && attribute!="y" && attribute!="z" && attribute!="px" && attribute!="py" && attribute!="pz" && attribute!="E" ) ) {
+                            ERROR( axis_prefix.str() << ": attribute must be x, y, z, px, py, pz or E" );
+                        }
+                        if( ( attribute=="y" && params.nDim_particle<2 ) || ( attribute=="z" && params.nDim_particle<3 ) ) {
+                            ERROR( axis_prefix.str() << ": axis " << attribute << " cannot exist in " << params.nDim_particle << "D" );
+                        }
+                        if( ! PyTools::py2scalar( py_axis[1], min ) || ! PyTools::py2scalar( py_axis[2], max ) || max <= min ) {
+                            ERROR( axis_prefix.str() << ": min and max must be floats with min < max" );
+                        }
+                        if( ! PyTools::py2scalar( py_axis[3], npoints ) || npoints < 2 ) {
+                            ERROR( axis_prefix.str() << ": number_of_points must be an integer >= 2" );
+                        }
+                        this_species->ionization_rate_axes_.push_back( attribute );
+                        this_species->ionization_rate_ranges_.push_back( { min, max, ( double ) npoints } );
+                        for( unsigned int i=0; i<py_axis.size(); i++ ) {
+                            Py_DECREF( py_axis[i] );
+                        }
+                        Py_DECREF( py_axes[iaxis] );
+                    }
 #ifdef SMILEI_USE_NUMPY
+                    if( this_species->ionization_rate_axes_.size() > 0 ) {
+                        this_species->ionization_rate_table_ = IonizationFromRate::sampleRate( this_species, params.nDim_particle );
+                    } else {
                         // Test the ionization_rate function with temporary, "fake" particles
                         std::ostringstream name( "" );
                         name << " ionization_rate:";
                         double *dummy = NULL;
                         ParticleData test( params.nDim_particle, this_species->ionization_rate_, name.str(), dummy );
+                    }
 #else
-                        ERROR( "For species '" << species_name << " ionization 'from_rate' requires Numpy" );
+                    ERROR( "For species '" << species_name << " ionization 'from_rate' requires Numpy" );
 #endif
-                    }
 
                 } else if( model != "none" ) {
                     ERROR( "For species " << species_name << ": unknown ionization model `" << model );
@@ -998,6 +1046,12 @@ public:
         if( new_species->ionization_rate_!=Py_None ) {
             Py_INCREF( new_species->ionization_rate_ );
         }
+        new_species->ionization_rate_table_                    = species->ionization_rate_table_;
+        if( new_species->ionization_rate_table_!=Py_None ) {
+            Py_INCREF( new_species->ionization_rate_table_ );
+        }
+        new_species->ionization_rate_axes_                     = species->ionization_rate_axes_;
+        new_species->ionization_rate_ranges_                   = species->ionization_rate_ranges_;
         new_species->ionization_model                         = species->ionization_model;
         new_species->density_profile_type_                       = species->density_profile_type_;
         new_species->vectorized_operators                     = species->vectorized_operators;
@@ -1007,6 +1061,8 @@ public:
         new_species->merge_log_scale_                         = species->merge_log_scale_;
         new_species->merge_min_momentum_log_scale_            = species->merge_min_momentum_log_scale_;
         new_species->merge_min_particles_per_cell_            = species->merge_min_particles_per_cell_;
+        new_species->merge_adaptive_                          = species->merge_adaptive_;
+        new_species->merge_max_particles_per_step_            = species->merge_max_particles_per_step_;
         new_species->merge_min_packet_size_                   = species->merge_min_packet_size_;
         new_species->merge_max_packet_size_                   = species->merge_max_packet_size_;
         new_species->merge_accumulation_correction_           = species->merge_accumulation_correction_;
@@ -5,6 +5,7 @@
 #include <cstdlib>
 
 #include <iostream>
+#include <algorithm>
 
 #include <omp.h>
 
@@ -253,10 +254,6 @@ void SpeciesV::dynamics( double time_dual, unsigned int ispec,
                             particles->first_index[scell],
                             particles->last_index[scell],
                             ithread );
-
-                    // Suppression of the decayed photons into pairs
-                    Multiphoton_Breit_Wheeler_process->decayed_photon_cleaning(
-                        *particles, smpi, scell, particles->first_index.size(), &particles->first_index[0], &particles->last_index[0], ithread );
                         
                 }
 #ifdef  __DETAILED_TIMERS
@@ -817,10 +814,50 @@ void SpeciesV::mergeParticles( double time_dual, unsigned int ispec,
     if( time_dual>time_frozen_ ) {
 
         unsigned int scell ;
+        unsigned int ncells = particles->first_index.size();
         // double weight_before = 0;
         // double weight_after = 0;
         // double energy_before = 0;
         // double energy_after = 0;
+
+        // Cells to merge: those above the threshold and, for the adaptive merging,
+        // those that have grown since their last merging
+        if( merge_count_after_.size() != ncells ) {
+            merge_count_after_.assign( ncells, 0 );
+        }
+        std::vector <unsigned int> cells;
+        unsigned int cell_particles = 0;
+        for( scell = 0 ; scell < ncells ; scell++ ) {
+            int npart = particles->last_index[scell] - particles->first_index[scell];
+            merge_count_after_[scell] = std::min( merge_count_after_[scell], npart );
+            if( npart > ( int )merge_min_particles_per_cell_
+             && ( !merge_adaptive_ || npart > merge_count_after_[scell] ) ) {
+                cells.push_back( scell );
+                cell_particles += npart;
+            }
+        }
+        if( cells.empty() ) {
+            return;
+        }
+
+        // Limit on the merging work: the most populated cells first
+        if( merge_max_particles_per_step_ > 0 && cell_particles > merge_max_particles_per_step_ ) {
+            std::vector <int> &first_index = particles->first_index;
+            std::vector <int> &last_index = particles->last_index;
+            std::sort( cells.begin(), cells.end(), [&]( unsigned int c1, unsigned int c2 ) {
+                return last_index[c1]-first_index[c1] > last_index[c2]-first_index[c2];
+            } );
+            unsigned int nselected = 1;
+            cell_particles = last_index[cells[0]]-first_index[cells[0]];
+            while( nselected < cells.size()
+                && cell_particles + last_index[cells[nselected]]-first_index[cells[nselected]] <= merge_max_particles_per_step_ ) {
+                cell_particles += last_index[cells[nselected]]-first_index[cells[nselected]];
+                nselected++;
+            }
+            cells.resize( nselected );
+            std::sort( cells.begin(), cells.end() );
+        }
+
         std::vector <int> mask(particles->last_index.back(), 1);
 
         // Resize the cell_keys
@@ -835,16 +872,18 @@ void SpeciesV::mergeParticles( double time_dual, unsigned int ispec,
         //         energy_before += sqrt(1 + pow(particles->momentum(0,ip),2) + pow(particles->momentum(1,ip),2) + pow(particles->momentum(2,ip),2));
         // }
 
-        // For each cell, we apply independently the merging process
-        for( scell = 0 ; scell < particles->first_index.size() ; scell++ ) {
+        // For each selected cell, we apply independently the merging process
+        for( unsigned int icell = 0 ; icell < cells.size() ; icell++ ) {
             
+            scell = cells[icell];
             ( *Merge )( mass_, *particles, mask, smpi, particles->first_index[scell],
                         particles->last_index[scell], count[scell]);
+            merge_count_after_[scell] = count[scell];
                         
         }
 
-        // We remove empty space in an optimized manner
-        particles->eraseParticlesWithMask(0, particles->last_index.back(), mask);
+        // We remove empty space in an optimized manner, from the first merged cell
+        particles->eraseParticlesWithMask(particles->first_index[cells[0]], particles->last_index.back(), mask);
 
         // Update of first and last cell indexes
         particles->first_index[0] = 0;
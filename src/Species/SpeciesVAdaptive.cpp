@@ -177,10 +177,6 @@ void SpeciesVAdaptive::scalarDynamics( double time_dual, unsigned int ispec,
                         particles->first_index[scell],
                         particles->last_index[scell],
                         ithread );
-
-                // Suppression of the decayed photons into pairs
-                Multiphoton_Breit_Wheeler_process->decayed_photon_cleaning(
-                    *particles, smpi, scell, particles->first_index.size(), &particles->first_index[0], &particles->last_index[0], ithread );
 #ifdef  __DETAILED_TIMERS
                 patch->patch_timers[6] += MPI_Wtime() - timer;
 #endif
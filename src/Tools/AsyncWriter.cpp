@@ -0,0 +1,94 @@
+#include "AsyncWriter.h"
+
+#ifdef SMILEI_ASYNC_OUTPUT
+
+AsyncWriter::AsyncWriter() :
+    npushed_( 0 ),
+    ndone_( 0 ),
+    stop_( false )
+{
+}
+
+AsyncWriter::~AsyncWriter()
+{
+    if( thread_.joinable() ) {
+        {
+            std::lock_guard<std::mutex> lock( mutex_ );
+            stop_ = true;
+        }
+        task_pushed_.notify_one();
+        thread_.join();
+    }
+}
+
+uint64_t AsyncWriter::push( std::function<void()> task )
+{
+    uint64_t ticket;
+    {
+        std::lock_guard<std::mutex> lock( mutex_ );
+        tasks_.push_back( task );
+        ticket = ++npushed_;
+    }
+    if( ! thread_.joinable() ) {
+        thread_ = std::thread( &AsyncWriter::loop, this );
+    }
+    task_pushed_.notify_one();
+    return ticket;
+}
+
+void AsyncWriter::wait()
+{
+    std::unique_lock<std::mutex> lock( mutex_ );
+    task_done_.wait( lock, [this] { return ndone_ == npushed_; } );
+}
+
+void AsyncWriter::wait( uint64_t ticket )
+{
+    std::unique_lock<std::mutex> lock( mutex_ );
+    task_done_.wait( lock, [this, ticket] { return ndone_ >= ticket; } );
+}
+
+void AsyncWriter::loop()
+{
+    std::unique_lock<std::mutex> lock( mutex_ );
+    while( true ) {
+        task_pushed_.wait( lock, [this] { return stop_ || ! tasks_.empty(); } );
+        // Remaining tasks are executed before stopping
+        if( tasks_.empty() ) {
+            return;
+        }
+        std::function<void()> task = tasks_.front();
+        tasks_.pop_front();
+        lock.unlock();
+        task();
+        lock.lock();
+        ndone_++;
+        task_done_.notify_all();
+    }
+}
+
+#else
+
+AsyncWriter::AsyncWriter()
+{
+}
+
+AsyncWriter::~AsyncWriter()
+{
+}
+
+uint64_t AsyncWriter::push( std::function<void()> task )
+{
+    task();
+    return 0;
+}
+
+void AsyncWriter::wait()
+{
+}
+
+void AsyncWriter::wait( uint64_t ticket )
+{
+}
+
+#endif
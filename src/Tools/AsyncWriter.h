@@ -0,0 +1,71 @@
+#ifndef ASYNCWRITER_H
+#define ASYNCWRITER_H
+
+#include <functional>
+#include <deque>
+#include <cstdint>
+
+#if defined( _OPENMP ) && !defined( _NO_MPI_TM )
+#define SMILEI_ASYNC_OUTPUT
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#endif
+
+//  --------------------------------------------------------------------------------------------------------------------
+//! Class AsyncWriter: background thread executing the HDF5 writes of the asynchronous diagnostics
+//
+//! The diagnostics copy their data in staging buffers, then push a task which writes these buffers.
+//! The tasks are executed in order by a single thread, so that all MPI ranks issue the collective
+//! HDF5 operations in the same order. HDF5 is never called concurrently: the main thread must call
+//! wait() before any HDF5 operation of its own.
+//! The thread requires MPI_THREAD_MULTIPLE. Otherwise, the tasks are executed immediately in push().
+//  --------------------------------------------------------------------------------------------------------------------
+class AsyncWriter
+{
+public:
+    AsyncWriter();
+    //! Executes the remaining tasks and stops the thread
+    ~AsyncWriter();
+
+    //! Queues a task (the thread is started at the first call)
+    //! \return ticket of the task, to be given to wait()
+    uint64_t push( std::function<void()> task );
+
+    //! Waits until all queued tasks are executed
+    void wait();
+
+    //! Waits until the task of the given ticket and all previous ones are executed
+    void wait( uint64_t ticket );
+
+    //! Tells whether tasks can be executed in the background
+    static bool available()
+    {
+#ifdef SMILEI_ASYNC_OUTPUT
+        return true;
+#else
+        return false;
+#endif
+    }
+
+private:
+
+#ifdef SMILEI_ASYNC_OUTPUT
+    //! Loop of the thread
+    void loop();
+
+    std::thread thread_;
+    std::mutex mutex_;
+    //! Notified when a task is pushed, and when the thread must stop
+    std::condition_variable task_pushed_;
+    //! Notified when a task is done
+    std::condition_variable task_done_;
+    //! Tasks not yet executed
+    std::deque<std::function<void()> > tasks_;
+    //! Number of tasks pushed and executed since the beginning
+    uint64_t npushed_, ndone_;
+    bool stop_;
+#endif
+};
+
+#endif
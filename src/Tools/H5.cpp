@@ -150,3 +150,18 @@ H5Space::H5Space( std::vector<hsize_t> size, std::vector<hsize_t> offset, std::v
     }
     chunk_ = chunk;
 }
+
+
+//! Adds the filters to the creation property list of a chunked dataset
+void H5Filter::apply( hid_t dcr ) const
+{
+    if( plugin_ >= 0 ) {
+        H5Pset_filter( dcr, plugin_, H5Z_FLAG_OPTIONAL, plugin_params_.size(), plugin_params_.empty() ? NULL : &plugin_params_[0] );
+    }
+    if( shuffle_ ) {
+        H5Pset_shuffle( dcr );
+    }
+    if( deflate_ > 0 ) {
+        H5Pset_deflate( dcr, deflate_ );
+    }
+}
@@ -63,6 +63,42 @@ public:
     
 };
 
+//! Filters applied to the data of a dataset: compression, and conversion to single precision
+class H5Filter
+{
+public:
+    H5Filter() : deflate_( 0 ), shuffle_( false ), plugin_( -1 ), single_precision_( false ) {};
+    
+    //! Tells whether the filters require a chunked dataset
+    bool compresses() const
+    {
+        return deflate_ > 0 || shuffle_ || plugin_ >= 0;
+    }
+    
+    //! Type of the data in the file, given its type in memory
+    hid_t fileType( hid_t type ) const
+    {
+        if( single_precision_ && H5Tequal( type, H5T_NATIVE_DOUBLE ) > 0 ) {
+            return H5T_NATIVE_FLOAT;
+        }
+        return type;
+    }
+    
+    //! Adds the filters to the creation property list of a chunked dataset
+    void apply( hid_t dcr ) const;
+    
+    //! Level of the deflate compression (0 = no deflate)
+    unsigned int deflate_;
+    //! Whether the shuffle filter is applied before deflate
+    bool shuffle_;
+    //! Filter provided by an HDF5 plugin, applied first (-1 = none)
+    H5Z_filter_t plugin_;
+    //! Parameters of the plugin filter
+    std::vector<unsigned int> plugin_params_;
+    //! Whether doubles are written as floats
+    bool single_precision_;
+};
+
 class H5
 {
 public:
@@ -132,20 +168,37 @@ public:
      : H5( loc->newGroupId( group_name ), loc->dcr_, loc->dxpl_ ) {};
     
     //! Create or open (not write) a dataset given H5Write location
-    H5Write( H5Write *loc, std::string name, hid_t type, H5Space *filespace )
+    //! The optional filter sets the compression and the type of the data in the file
+    H5Write( H5Write *loc, std::string name, hid_t type, H5Space *filespace, const H5Filter *filter = NULL )
      : H5( -1, loc->dcr_, loc->dxpl_ )
     {
+        bool compress = filter && filter->compresses() && filespace->global_ > 0;
         H5D_layout_t layout = H5Pget_layout( dcr_ );
         if( ! filespace->chunk_.empty() ) {
             H5Pset_chunk( dcr_, filespace->chunk_.size(), &filespace->chunk_[0] );
+        } else if( compress ) {
+            // Compression requires chunks: default to the whole array, within the 4GB limit
+            std::vector<hsize_t> chunk = filespace->dims_;
+            const hsize_t max_size = 4294967295/2/sizeof( double );
+            while( chunk[0] > 1 && filespace->global_ / filespace->dims_[0] * chunk[0] > max_size ) {
+                chunk[0] = ( chunk[0] + 1 ) / 2;
+            }
+            H5Pset_chunk( dcr_, chunk.size(), &chunk[0] );
+        }
+        if( compress ) {
+            filter->apply( dcr_ );
         }
         if( H5Lexists( loc->id_, name.c_str(), H5P_DEFAULT ) == 0 ) {
-            id_  = H5Dcreate( loc->id_, name.c_str(), type, filespace->sid, H5P_DEFAULT, dcr_, H5P_DEFAULT );
+            hid_t file_type = filter ? filter->fileType( type ) : type;
+            id_  = H5Dcreate( loc->id_, name.c_str(), file_type, filespace->sid, H5P_DEFAULT, dcr_, H5P_DEFAULT );
         } else {
             hid_t pid = H5Pcreate( H5P_DATASET_ACCESS );
             id_ = H5Dopen( loc->id_, name.c_str(), pid );
             H5Pclose( pid );
         }
+        if( compress ) {
+            H5Premove_filter( dcr_, H5Z_FILTER_ALL );
+        }
         H5Pset_layout( dcr_, layout );
     }
     
@@ -309,12 +362,6 @@ public:
     {
         // create dataspace for 1D array with good number of elements
         hsize_t dim = size;
-//        if( deflate>0 ) {
-//            H5Pset_chunk( dcr_, 1, &dim );
-//            H5Pset_deflate( dcr_, std::min( 9, deflate ) );
-//        } else {
-//            H5Premove_filter( dcr_, H5Z_FILTER_DEFLATE );
-//        }
         // Select portion
         if( npoints == 0 ) {
             npoints = dim - offset;
@@ -338,9 +385,9 @@ public:
     }
     
     //! Create or open (not write) a dataset
-    H5Write dataset( std::string name, hid_t type, H5Space *filespace )
+    H5Write dataset( std::string name, hid_t type, H5Space *filespace, const H5Filter *filter = NULL )
     {
-        return H5Write( this, name, type, filespace );
+        return H5Write( this, name, type, filespace, filter );
     }
     
     // Write to an open dataset
@@ -393,9 +440,9 @@ public:
     
     //! Write a multi-dimensional array
     template<class T>
-    H5Write array( std::string name, T &v, hid_t type, H5Space *filespace, H5Space *memspace, bool independent = false )
+    H5Write array( std::string name, T &v, hid_t type, H5Space *filespace, H5Space *memspace, bool independent = false, const H5Filter *filter = NULL )
     {
-        H5Write d = dataset( name, type, filespace );
+        H5Write d = dataset( name, type, filespace, filter );
         d.write( v, type, filespace, memspace, independent );
         return d;
     }
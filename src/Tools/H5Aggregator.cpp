@@ -0,0 +1,236 @@
+#include "H5Aggregator.h"
+
+#include <algorithm>
+#include <climits>
+
+using namespace std;
+
+H5Aggregator::H5Aggregator( MPI_Comm comm, int aggregators_per_node )
+{
+    int rank;
+    MPI_Comm_rank( comm, &rank );
+
+    // Ranks sharing the same node
+    MPI_Comm node_comm;
+    MPI_Comm_split_type( comm, MPI_COMM_TYPE_SHARED, rank, MPI_INFO_NULL, &node_comm );
+    int node_rank, node_size;
+    MPI_Comm_rank( node_comm, &node_rank );
+    MPI_Comm_size( node_comm, &node_size );
+
+    // Consecutive ranks of the node are gathered by the same aggregator
+    int naggregators = max( 1, min( aggregators_per_node, node_size ) );
+    int group = ( node_rank * naggregators ) / node_size;
+    MPI_Comm_split( node_comm, group, node_rank, &comm_ );
+    MPI_Comm_free( &node_comm );
+    MPI_Comm_rank( comm_, &rank_ );
+    MPI_Comm_size( comm_, &size_ );
+
+    local_npoints_ = 0;
+    contiguous_ = false;
+}
+
+H5Aggregator::~H5Aggregator()
+{
+    int finalized;
+    MPI_Finalized( &finalized );
+    if( ! finalized ) {
+        MPI_Comm_free( &comm_ );
+    }
+}
+
+
+bool H5Aggregator::gatherBlocks( H5Space *filespace )
+{
+    // Nothing to gather when the group has one rank
+    if( size_ == 1 ) {
+        return false;
+    }
+
+    // Block selected by this rank
+    unsigned int ndim = filespace->dims_.size();
+    vector<unsigned long long> local( 2*ndim, 0 ), all( 2*ndim*size_ );
+    hssize_t npoints = H5Sget_select_npoints( filespace->sid );
+    local_npoints_ = npoints > 0 ? npoints : 0;
+    if( local_npoints_ > 0 ) {
+        vector<hsize_t> start( ndim ), end( ndim );
+        H5Sget_select_bounds( filespace->sid, &start[0], &end[0] );
+        for( unsigned int i=0; i<ndim; i++ ) {
+            local[i] = start[i];
+            local[ndim+i] = end[i] - start[i] + 1;
+        }
+    }
+    MPI_Gather( &local[0], 2*ndim, MPI_UNSIGNED_LONG_LONG, &all[0], 2*ndim, MPI_UNSIGNED_LONG_LONG, 0, comm_ );
+
+    int aggregate = 0;
+    if( rank_ == 0 ) {
+        offsets_.resize( size_ );
+        blocks_.resize( size_ );
+        npoints_.resize( size_ );
+        displacements_.resize( size_ );
+        box_offset_.assign( ndim, ULLONG_MAX );
+        vector<hsize_t> box_end( ndim, 0 );
+        hsize_t total = 0, last_end = 0;
+        contiguous_ = ( ndim == 1 );
+        for( int r=0; r<size_; r++ ) {
+            offsets_[r].assign( &all[2*ndim*r], &all[2*ndim*r+ndim] );
+            blocks_[r].assign( &all[2*ndim*r+ndim], &all[2*ndim*( r+1 )] );
+            hsize_t n = 1;
+            for( unsigned int i=0; i<ndim; i++ ) {
+                n *= blocks_[r][i];
+            }
+            if( n > 0 ) {
+                for( unsigned int i=0; i<ndim; i++ ) {
+                    box_offset_[i] = min( box_offset_[i], offsets_[r][i] );
+                    box_end[i] = max( box_end[i], offsets_[r][i] + blocks_[r][i] );
+                }
+                // In 1D, the blocks follow each other in the order of the ranks
+                contiguous_ = contiguous_ && ( total == 0 || offsets_[r][0] == last_end );
+                last_end = offsets_[r][0] + blocks_[r][0];
+            }
+            npoints_[r] = min( n, ( hsize_t )INT_MAX );
+            displacements_[r] = min( total, ( hsize_t )INT_MAX );
+            total += n;
+        }
+        hsize_t box_npoints = 1;
+        box_size_.resize( ndim );
+        for( unsigned int i=0; i<ndim; i++ ) {
+            box_size_[i] = total > 0 ? box_end[i] - box_offset_[i] : 0;
+            box_npoints *= box_size_[i];
+        }
+        // The bounding box of the blocks must not be much larger than the blocks themselves
+        aggregate = total > 0 && total <= INT_MAX && box_npoints <= 2*total;
+        if( aggregate ) {
+            if( contiguous_ ) {
+                buffer_.resize( total );
+            } else {
+                gathered_.resize( total );
+                buffer_.resize( box_npoints );
+            }
+        }
+    }
+    MPI_Bcast( &aggregate, 1, MPI_INT, 0, comm_ );
+    return aggregate;
+}
+
+
+void H5Aggregator::selectBlocks( H5Space *filespace, H5Space *memspace )
+{
+    unsigned int ndim = box_size_.size();
+    vector<hsize_t> count( ndim, 1 );
+    if( contiguous_ ) {
+        H5Sselect_hyperslab( filespace->sid, H5S_SELECT_SET, &box_offset_[0], NULL, &count[0], &box_size_[0] );
+        return;
+    }
+    H5S_seloper_t op = H5S_SELECT_SET;
+    vector<hsize_t> offset_in_box( ndim );
+    for( int r=0; r<size_; r++ ) {
+        if( npoints_[r] == 0 ) {
+            continue;
+        }
+        for( unsigned int i=0; i<ndim; i++ ) {
+            offset_in_box[i] = offsets_[r][i] - box_offset_[i];
+        }
+        H5Sselect_hyperslab( filespace->sid, op, &offsets_[r][0], NULL, &count[0], &blocks_[r][0] );
+        H5Sselect_hyperslab( memspace->sid, op, &offset_in_box[0], NULL, &count[0], &blocks_[r][0] );
+        op = H5S_SELECT_OR;
+    }
+}
+
+
+void H5Aggregator::copyBlock( unsigned int iblock, double *data, bool to_buffer )
+{
+    unsigned int ndim = box_size_.size();
+    vector<hsize_t> &offset = offsets_[iblock];
+    vector<hsize_t> &block = blocks_[iblock];
+    hsize_t row = block[ndim-1];
+    hsize_t nrows = npoints_[iblock] / row;
+    // Index of the current row in the block
+    vector<hsize_t> index( ndim, 0 );
+    for( hsize_t irow=0; irow<nrows; irow++ ) {
+        hsize_t position = 0;
+        for( unsigned int i=0; i<ndim; i++ ) {
+            position = position * box_size_[i] + offset[i] - box_offset_[i] + index[i];
+        }
+        double *b = &buffer_[position], *d = &data[irow*row];
+        if( to_buffer ) {
+            copy( d, d+row, b );
+        } else {
+            copy( b, b+row, d );
+        }
+        for( int i=ndim-2; i>=0; i-- ) {
+            if( ++index[i] < block[i] ) {
+                break;
+            }
+            index[i] = 0;
+        }
+    }
+}
+
+
+void H5Aggregator::write( H5Write &dataset, double *data, H5Space *filespace )
+{
+    if( ! gatherBlocks( filespace ) ) {
+        H5Space memspace( ( hsize_t )H5Sget_select_npoints( filespace->sid ) );
+        dataset.write( *data, H5T_NATIVE_DOUBLE, filespace, &memspace );
+        return;
+    }
+
+    // Gather the data of the group, and arrange it in the aggregation buffer
+    H5Space file( filespace->dims_ );
+    if( rank_ == 0 ) {
+        H5Space mem( contiguous_ ? vector<hsize_t>( 1, buffer_.size() ) : box_size_ );
+        double *gathered = contiguous_ ? &buffer_[0] : &gathered_[0];
+        MPI_Gatherv( data, local_npoints_, MPI_DOUBLE, gathered, &npoints_[0], &displacements_[0], MPI_DOUBLE, 0, comm_ );
+        if( ! contiguous_ ) {
+            for( int r=0; r<size_; r++ ) {
+                if( npoints_[r] > 0 ) {
+                    copyBlock( r, &gathered_[displacements_[r]], true );
+                }
+            }
+        }
+        selectBlocks( &file, &mem );
+        dataset.write( buffer_[0], H5T_NATIVE_DOUBLE, &file, &mem );
+    } else {
+        MPI_Gatherv( data, local_npoints_, MPI_DOUBLE, NULL, NULL, NULL, MPI_DOUBLE, 0, comm_ );
+        // Participate to the collective write without data
+        H5Space mem( ( hsize_t )1 );
+        H5Sselect_none( file.sid );
+        H5Sselect_none( mem.sid );
+        double dummy;
+        dataset.write( dummy, H5T_NATIVE_DOUBLE, &file, &mem );
+    }
+}
+
+
+void H5Aggregator::read( H5Write &dataset, double *data, H5Space *filespace )
+{
+    if( ! gatherBlocks( filespace ) ) {
+        H5Space memspace( ( hsize_t )H5Sget_select_npoints( filespace->sid ) );
+        dataset.read( *data, H5T_NATIVE_DOUBLE, filespace, &memspace );
+        return;
+    }
+
+    // Read the data of the group in the aggregation buffer, and scatter it
+    H5Space file( filespace->dims_ );
+    if( rank_ == 0 ) {
+        H5Space mem( contiguous_ ? vector<hsize_t>( 1, buffer_.size() ) : box_size_ );
+        selectBlocks( &file, &mem );
+        dataset.read( buffer_[0], H5T_NATIVE_DOUBLE, &file, &mem );
+        double *gathered = contiguous_ ? &buffer_[0] : &gathered_[0];
+        if( ! contiguous_ ) {
+            for( int r=0; r<size_; r++ ) {
+                if( npoints_[r] > 0 ) {
+                    copyBlock( r, &gathered_[displacements_[r]], false );
+                }
+            }
+        }
+        MPI_Scatterv( gathered, &npoints_[0], &displacements_[0], MPI_DOUBLE, data, local_npoints_, MPI_DOUBLE, 0, comm_ );
+    } else {
+        H5Space mem( ( hsize_t )1 );
+        H5Sselect_none( file.sid );
+        H5Sselect_none( mem.sid );
+        double dummy;
+        dataset.read( dummy, H5T_NATIVE_DOUBLE, &file, &mem );
+        MPI_Scatterv( NULL, NULL, NULL, MPI_DOUBLE, data, local_npoints_, MPI_DOUBLE, 0, comm_ );
+    }
+}
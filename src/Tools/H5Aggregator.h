@@ -0,0 +1,59 @@
+#ifndef H5AGGREGATOR_H
+#define H5AGGREGATOR_H
+
+#include <vector>
+
+#include "H5.h"
+
+//  --------------------------------------------------------------------------------------------------------------------
+//! Class H5Aggregator: two-phase collective writes of distributed arrays
+//
+//! The ranks of each node are divided in groups of consecutive ranks. In each group, one aggregator rank
+//! gathers the blocks of the group and writes them in one large selection, while the other ranks
+//! participate to the collective write with an empty selection. Reads are done the other way round.
+//! Each rank must select a single block (or nothing) in the file space. When the blocks of a group are
+//! too sparse or too large to be gathered, each rank accesses its own block as usual.
+//  --------------------------------------------------------------------------------------------------------------------
+class H5Aggregator
+{
+public:
+    //! Creates the groups of ranks (collective over comm)
+    H5Aggregator( MPI_Comm comm, int aggregators_per_node );
+    ~H5Aggregator();
+
+    //! Writes the block selected in filespace, from a contiguous buffer (collective)
+    void write( H5Write &dataset, double *data, H5Space *filespace );
+
+    //! Reads the block selected in filespace, to a contiguous buffer (collective)
+    void read( H5Write &dataset, double *data, H5Space *filespace );
+
+private:
+    //! Gathers the blocks of the group on the aggregator
+    //! \return true if the data of the group is to be gathered
+    bool gatherBlocks( H5Space *filespace );
+
+    //! Creates the selections of all the blocks of the group, in the file and in the aggregation buffer
+    void selectBlocks( H5Space *filespace, H5Space *memspace );
+
+    //! Copies between the contiguous data of a block and the aggregation buffer
+    void copyBlock( unsigned int iblock, double *data, bool to_buffer );
+
+    //! Communicator of the group, whose rank 0 is the aggregator
+    MPI_Comm comm_;
+    int rank_, size_;
+
+    //! Number of points of the block of this rank
+    int local_npoints_;
+    //! Whether the blocks of the group form one contiguous 1D block, in the order of the ranks
+    bool contiguous_;
+    //! Offsets and sizes of the blocks of the group (on the aggregator)
+    std::vector<std::vector<hsize_t> > offsets_, blocks_;
+    //! Number of points of the blocks of the group, and their displacements in the gathered data
+    std::vector<int> npoints_, displacements_;
+    //! Bounding box of the blocks of the group
+    std::vector<hsize_t> box_offset_, box_size_;
+    //! Aggregation buffer (bounding box) and gathered data
+    std::vector<double> buffer_, gathered_;
+};
+
+#endif
@@ -0,0 +1,41 @@
+#include "LookupTable.h"
+
+// -----------------------------------------------------------------------------
+//! Compile the table from its values at the points
+//! log-uniformly distributed from min to max (both included)
+// -----------------------------------------------------------------------------
+void LogTable::set( const std::vector<double> &values, double min, double max )
+{
+    size_ = values.size();
+    log10_min_ = std::log10( min );
+    inv_delta_ = ( size_-1 ) / ( std::log10( max ) - log10_min_ );
+
+    data_.resize( 2*size_ );
+    for( int i=0; i<size_; i++ ) {
+        data_[2*i  ] = values[i];
+        data_[2*i+1] = i < size_-1 ? values[i+1] - values[i] : 0.;
+    }
+}
+
+// -----------------------------------------------------------------------------
+//! Compile nrows CDFs of ncols values, stored row after row in cdf
+// -----------------------------------------------------------------------------
+void CDFTable::set( const std::vector<double> &cdf, int nrows, int ncols )
+{
+    nrows_ = nrows;
+    ncols_ = ncols;
+    cdf_ = cdf;
+
+    index_.resize( nrows_*ncols_ );
+    for( int row=0; row<nrows_; row++ ) {
+        const double *c = &cdf_[row*ncols_];
+        int j = 0;
+        for( int k=0; k<ncols_; k++ ) {
+            double xi = ( double ) k / ncols_;
+            while( j < ncols_-2 && c[j+1] <= xi ) {
+                j++;
+            }
+            index_[row*ncols_ + k] = j;
+        }
+    }
+}
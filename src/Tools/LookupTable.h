@@ -0,0 +1,155 @@
+// ----------------------------------------------------------------------------
+//! \file LookupTable.h
+//
+//! \brief Compiled lookup tables shared by the QED operators
+//
+//! \details The tables read from the files (or stored in the code) are
+//! compiled at initialization into layouts made for the particle loops:
+//! - LogTable: a function tabulated on a log-uniform axis, stored as
+//!   interleaved (value, slope) pairs so that an interpolation reads a single
+//!   pair of neighbouring numbers,
+//! - CDFTable: rows of cumulative distribution functions completed by
+//!   an index on a uniform grid of probabilities, so that the inverse
+//!   of a CDF is found without a binary search.
+//! With the make option `config=qed_float_tables`, the values of the LogTable
+//! are stored in single precision to halve the memory traffic.
+// ----------------------------------------------------------------------------
+
+#ifndef LOOKUPTABLE_H
+#define LOOKUPTABLE_H
+
+#include <vector>
+#include <cmath>
+
+#ifdef _QED_FLOAT_TABLES
+typedef float qed_table_t;
+#else
+typedef double qed_table_t;
+#endif
+
+//------------------------------------------------------------------------------
+//! Function tabulated on a log-uniform axis, interpolated linearly in log10(x)
+//------------------------------------------------------------------------------
+class LogTable
+{
+public:
+    LogTable() : size_( 0 ), log10_min_( 0. ), inv_delta_( 0. ) {};
+    ~LogTable() {};
+
+    //! Compile the table from its values at the points
+    //! log-uniformly distributed from min to max (both included)
+    void set( const std::vector<double> &values, double min, double max );
+
+    //! True if log10_x is inside the table range
+    inline bool contains( double log10_x ) const
+    {
+        double t = ( log10_x - log10_min_ ) * inv_delta_;
+        return t >= 0. && t < size_-1;
+    }
+
+    //! Interpolated value at log10_x.
+    //! Below the table, the first value is returned. Above the table, the
+    //! value of the last interval start is returned (historical convention).
+    #pragma omp declare simd
+    inline double operator()( double log10_x ) const
+    {
+        double t = ( log10_x - log10_min_ ) * inv_delta_;
+        int i = int( std::floor( t ) );
+        double d = t - i;
+        if( i < 0 ) {
+            i = 0;
+            d = 0.;
+        } else if( i > size_-2 ) {
+            i = size_-2;
+            d = 0.;
+        }
+        const qed_table_t *cell = &data_[2*i];
+        return cell[0] + d * cell[1];
+    }
+
+    //! Interpolated values at the n points log10_x, stored in y
+    inline void operator()( const double *log10_x, double *y, int n ) const
+    {
+        const qed_table_t *data = data_.data();
+        const double log10_min = log10_min_, inv_delta = inv_delta_;
+        const int imax = size_-2;
+        #pragma omp simd
+        for( int k=0; k<n; k++ ) {
+            double t = ( log10_x[k] - log10_min ) * inv_delta;
+            int i = int( std::floor( t ) );
+            double d = t - i;
+            if( i < 0 ) {
+                i = 0;
+                d = 0.;
+            } else if( i > imax ) {
+                i = imax;
+                d = 0.;
+            }
+            y[k] = data[2*i] + d * data[2*i+1];
+        }
+    }
+
+private:
+    //! Pairs (value, slope) for each interval of the table
+    std::vector<qed_table_t> data_;
+    //! Number of points of the table
+    int size_;
+    //! log10 of the first point
+    double log10_min_;
+    //! Inverse of the log10 step
+    double inv_delta_;
+};
+
+//------------------------------------------------------------------------------
+//! Rows of monotonic cumulative distribution functions, with an index to
+//! invert them in constant time
+//------------------------------------------------------------------------------
+class CDFTable
+{
+public:
+    CDFTable() : nrows_( 0 ), ncols_( 0 ) {};
+    ~CDFTable() {};
+
+    //! Compile nrows CDFs of ncols values, stored row after row in cdf
+    void set( const std::vector<double> &cdf, int nrows, int ncols );
+
+    //! Value j of the row
+    inline double operator()( int row, int j ) const
+    {
+        return cdf_[row*ncols_ + j];
+    }
+
+    //! Index j of the interval [cdf(j), cdf(j+1)[ of the row that contains xi,
+    //! with the same conventions as userFunctions::searchValuesInMonotonicArray
+    //! (0 below the row, ncols-2 above the row)
+    inline int find( int row, double xi ) const
+    {
+        const double *c = &cdf_[row*ncols_];
+        if( xi == c[0] ) {
+            return 0;
+        }
+        int k = int( xi * ncols_ );
+        k = k < 0 ? 0 : ( k >= ncols_ ? ncols_-1 : k );
+        int j = index_[row*ncols_ + k];
+        // Rounding in xi*ncols may put xi just below the start of the index cell
+        while( j > 0 && c[j] > xi ) {
+            j--;
+        }
+        while( j < ncols_-2 && c[j+1] <= xi ) {
+            j++;
+        }
+        return j;
+    }
+
+private:
+    //! Values of the CDFs
+    std::vector<double> cdf_;
+    //! For each row and each k, last interval starting below k/ncols
+    std::vector<int> index_;
+    //! Number of rows
+    int nrows_;
+    //! Number of values per row, which is also the size of the index
+    int ncols_;
+};
+
+#endif
@@ -0,0 +1,343 @@
+// ----------------------------------------------------------------------------
+//! \file QEDTablesGenerator.cpp
+//
+//! \brief Generation of the tables of the nonlinear inverse Compton scattering
+//! and of the multiphoton Breit-Wheeler pair creation
+//
+//! \details The physical formulae are those of the tool smilei_tables,
+//! see the documentation on the tables.
+// ----------------------------------------------------------------------------
+
+#include "QEDTablesGenerator.h"
+
+#include <cstdio>
+
+
+constexpr double QEDTablesGenerator::eps_;
+
+// -----------------------------------------------------------------------------
+// NUMERICAL TOOLS
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+//! Modified Bessel function of the second kind
+//! K_nu(x) = int_0^inf exp(-x cosh t) cosh(nu t) dt
+//! The integrand is analytic in the strip |Im t| < pi/2 so that the
+//! trapezoidal rule converges as exp(-pi^2/h).
+// -----------------------------------------------------------------------------
+double QEDTablesGenerator::besselK( double nu, double x )
+{
+    double h = std::min( 0.25, 0.5/std::sqrt( x ) );
+    double tmax = std::acosh( std::max( 1., 750./x ) );
+    int n = int( tmax/h ) + 1;
+    double sum = 0.5*std::exp( -x );
+    for( int k=1; k<=n; k++ ) {
+        double t = k*h;
+        sum += std::exp( -x*std::cosh( t ) )*std::cosh( nu*t );
+    }
+    return h*sum;
+}
+
+// -----------------------------------------------------------------------------
+//! K_{2/3}(z) and int_z^inf K_{1/3}(s) ds = int_0^inf exp(-z cosh t) cosh(t/3)/cosh(t) dt
+// -----------------------------------------------------------------------------
+void QEDTablesGenerator::computeBesselK23AndIntegralK13( double z, double &k23, double &ik13 )
+{
+    double h = std::min( 0.25, 0.5/std::sqrt( z ) );
+    double tmax = std::acosh( std::max( 1., 750./z ) );
+    int n = int( tmax/h ) + 1;
+    double e = 0.5*std::exp( -z );
+    k23 = e;
+    ik13 = e;
+    for( int k=1; k<=n; k++ ) {
+        double t = k*h;
+        double c = std::cosh( t );
+        e = std::exp( -z*c );
+        k23 += e*std::cosh( 2.*t/3. );
+        ik13 += e*std::cosh( t/3. )/c;
+    }
+    k23 *= h;
+    ik13 *= h;
+}
+
+// -----------------------------------------------------------------------------
+//! Rows [first, first+length) of a table of size rows of the current rank
+// -----------------------------------------------------------------------------
+void QEDTablesGenerator::distribute( int size, MPI_Comm comm, int &first, int &length,
+                                     std::vector<int> &firsts, std::vector<int> &lengths )
+{
+    int rank, number_of_ranks;
+    MPI_Comm_rank( comm, &rank );
+    MPI_Comm_size( comm, &number_of_ranks );
+    firsts.resize( number_of_ranks );
+    lengths.resize( number_of_ranks );
+    int f = 0;
+    for( int r=0; r<number_of_ranks; r++ ) {
+        firsts[r] = f;
+        lengths[r] = size/number_of_ranks + ( r < size%number_of_ranks ? 1 : 0 );
+        f += lengths[r];
+    }
+    first = firsts[rank];
+    length = lengths[rank];
+}
+
+// -----------------------------------------------------------------------------
+//! Path of the cache file of a set of tables (64-bit FNV-1a hash of the parameters)
+// -----------------------------------------------------------------------------
+std::string QEDTablesGenerator::cacheFile( std::string cache_path, std::string name,
+        std::string parameters )
+{
+    unsigned long long hash = 14695981039346656037ULL;
+    for( unsigned int i=0; i<parameters.size(); i++ ) {
+        hash ^= ( unsigned char ) parameters[i];
+        hash *= 1099511628211ULL;
+    }
+    char key[17];
+    snprintf( key, sizeof( key ), "%016llx", hash );
+    return cache_path + "/" + name + "_" + key + ".h5";
+}
+
+// -----------------------------------------------------------------------------
+// NONLINEAR INVERSE COMPTON SCATTERING
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+//! Synchrotron emissivity from Ritus
+// -----------------------------------------------------------------------------
+double QEDTablesGenerator::synchrotronEmissivity( double particle_chi, double photon_chi )
+{
+    if( photon_chi >= particle_chi ) {
+        return 0.;
+    }
+    double y = photon_chi/( 3.*particle_chi*( particle_chi-photon_chi ) );
+    double k23, ik13;
+    computeBesselK23AndIntegralK13( 2.*y, k23, ik13 );
+    return ( ( 2. + 3.*photon_chi*y )*k23 - ik13 )*2.*photon_chi/( 3.*particle_chi*particle_chi );
+}
+
+// -----------------------------------------------------------------------------
+//! Integration of S/chi between min_photon_chi and max_photon_chi,
+//! in the variable log(photon_chi)
+// -----------------------------------------------------------------------------
+double QEDTablesGenerator::integrateSynchrotronEmissivity( double particle_chi,
+        double min_photon_chi, double max_photon_chi )
+{
+    return integrate( [particle_chi]( double u ) {
+        return synchrotronEmissivity( particle_chi, std::exp( u ) );
+    }, std::log( min_photon_chi ), std::log( max_photon_chi ), eps_ );
+}
+
+// -----------------------------------------------------------------------------
+//! Function h(particle_chi) of Niel et al., integrated in the variable log(nu)
+//! between 1e-20 and 50
+// -----------------------------------------------------------------------------
+double QEDTablesGenerator::computeHNiel( double particle_chi )
+{
+    double h = integrate( [particle_chi]( double u ) {
+        double nu = std::exp( u );
+        double d = 2. + 3.*nu*particle_chi;
+        return nu*( 2.*std::pow( particle_chi*nu, 3 )/std::pow( d, 3 )*besselK( 5./3., nu )
+                    + 54.*std::pow( particle_chi, 5 )*std::pow( nu, 4 )/std::pow( d, 5 )*besselK( 2./3., nu ) );
+    }, std::log( 1e-20 ), std::log( 50. ), eps_ );
+    return 9.*std::sqrt( 3. )/( 4.*M_PI )*h;
+}
+
+// -----------------------------------------------------------------------------
+//! log10 of the minimum photon chi of the xi table
+// -----------------------------------------------------------------------------
+double QEDTablesGenerator::computeMinPhotonChi( double particle_chi, double xi_power, double xi_threshold )
+{
+    double log10_photon_chi = std::log10( particle_chi );
+    double denominator = integrateSynchrotronEmissivity( particle_chi, 0.99e-40*particle_chi, particle_chi );
+    int k = 0;
+    while( k < xi_power ) {
+        log10_photon_chi -= std::pow( 0.1, k );
+        double photon_chi = std::pow( 10., log10_photon_chi );
+        double numerator = integrateSynchrotronEmissivity( particle_chi, 0.99e-40*photon_chi, photon_chi );
+        double xi = ( numerator == 0. ) ? 0. : numerator/denominator;
+        if( xi < xi_threshold ) {
+            log10_photon_chi += std::pow( 0.1, k );
+            k++;
+        }
+    }
+    return log10_photon_chi;
+}
+
+// -----------------------------------------------------------------------------
+//! Tables of the nonlinear inverse Compton scattering
+// -----------------------------------------------------------------------------
+void QEDTablesGenerator::computeRadiationTables( int size_particle_chi, int size_photon_chi,
+        double min_particle_chi, double max_particle_chi,
+        double xi_power, double xi_threshold, MPI_Comm comm,
+        std::vector<double> &integfochi, std::vector<double> &h,
+        std::vector<double> &min_photon_chi, std::vector<double> &xi )
+{
+    int first, length;
+    std::vector<int> firsts, lengths;
+    distribute( size_particle_chi, comm, first, length, firsts, lengths );
+
+    double log10_min_particle_chi = std::log10( min_particle_chi );
+    double delta_particle_chi = ( std::log10( max_particle_chi ) - log10_min_particle_chi )
+                                / ( size_particle_chi - 1 );
+
+    std::vector<double> local_integfochi( length ), local_h( length ), local_min( length );
+    std::vector<double> local_xi( length*size_photon_chi );
+
+    #pragma omp parallel for schedule(dynamic)
+    for( int i=0; i<length; i++ ) {
+        double log10_particle_chi = ( first+i )*delta_particle_chi + log10_min_particle_chi;
+        double particle_chi = std::pow( 10., log10_particle_chi );
+
+        local_integfochi[i] = integrateSynchrotronEmissivity( particle_chi, 1e-40*particle_chi, particle_chi );
+        local_h[i] = computeHNiel( particle_chi );
+        local_min[i] = computeMinPhotonChi( particle_chi, xi_power, xi_threshold );
+
+        // Cumulative distribution, integrated interval by interval
+        double *row = &local_xi[i*size_photon_chi];
+        double delta_photon_chi = ( log10_particle_chi - local_min[i] )/( size_photon_chi - 1 );
+        double previous = std::pow( 10., local_min[i] );
+        row[0] = integrateSynchrotronEmissivity( particle_chi, 1e-40*previous, previous );
+        for( int j=1; j<size_photon_chi; j++ ) {
+            double photon_chi = std::pow( 10., local_min[i] + j*delta_photon_chi );
+            row[j] = row[j-1] + integrateSynchrotronEmissivity( particle_chi, previous, photon_chi );
+            previous = photon_chi;
+        }
+        double denominator = row[size_photon_chi-1];
+        for( int j=0; j<size_photon_chi; j++ ) {
+            row[j] = std::min( 1., row[j]/denominator );
+        }
+    }
+
+    integfochi.resize( size_particle_chi );
+    h.resize( size_particle_chi );
+    min_photon_chi.resize( size_particle_chi );
+    xi.resize( size_particle_chi*size_photon_chi );
+    MPI_Allgatherv( local_integfochi.data(), length, MPI_DOUBLE,
+                    integfochi.data(), lengths.data(), firsts.data(), MPI_DOUBLE, comm );
+    MPI_Allgatherv( local_h.data(), length, MPI_DOUBLE,
+                    h.data(), lengths.data(), firsts.data(), MPI_DOUBLE, comm );
+    MPI_Allgatherv( local_min.data(), length, MPI_DOUBLE,
+                    min_photon_chi.data(), lengths.data(), firsts.data(), MPI_DOUBLE, comm );
+    for( unsigned int r=0; r<firsts.size(); r++ ) {
+        firsts[r] *= size_photon_chi;
+        lengths[r] *= size_photon_chi;
+    }
+    MPI_Allgatherv( local_xi.data(), length*size_photon_chi, MPI_DOUBLE,
+                    xi.data(), lengths.data(), firsts.data(), MPI_DOUBLE, comm );
+}
+
+// -----------------------------------------------------------------------------
+// MULTIPHOTON BREIT-WHEELER
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+//! Value of dT/dchi(photon_chi, particle_chi) from the formula of Ritus
+// -----------------------------------------------------------------------------
+double QEDTablesGenerator::computeRitusDerivative( double photon_chi, double particle_chi )
+{
+    if( particle_chi >= photon_chi ) {
+        return 0.;
+    }
+    double y = photon_chi/( 3.*particle_chi*( photon_chi-particle_chi ) );
+    double k23, ik13;
+    computeBesselK23AndIntegralK13( 2.*y, k23, ik13 );
+    return ik13 - ( 2. - 3.*photon_chi*y )*k23;
+}
+
+// -----------------------------------------------------------------------------
+//! Integration of dT/dchi between min_particle_chi and max_particle_chi,
+//! in the variable log(particle_chi)
+// -----------------------------------------------------------------------------
+double QEDTablesGenerator::integrateRitusDerivative( double photon_chi,
+        double min_particle_chi, double max_particle_chi )
+{
+    return integrate( [photon_chi]( double u ) {
+        double particle_chi = std::exp( u );
+        return computeRitusDerivative( photon_chi, particle_chi )*particle_chi;
+    }, std::log( min_particle_chi ), std::log( max_particle_chi ), eps_ );
+}
+
+// -----------------------------------------------------------------------------
+//! Integration of dT/dchi between 0 and particle_chi
+// -----------------------------------------------------------------------------
+double QEDTablesGenerator::integrateRitusDerivative( double photon_chi, double particle_chi )
+{
+    return integrateRitusDerivative( photon_chi, 1e-50*particle_chi, particle_chi );
+}
+
+// -----------------------------------------------------------------------------
+//! log10 of the minimum particle chi of the xi table
+// -----------------------------------------------------------------------------
+double QEDTablesGenerator::computeMinParticleChi( double photon_chi, double xi_power, double xi_threshold )
+{
+    double log10_particle_chi = std::log10( 0.5*photon_chi );
+    double denominator = integrateRitusDerivative( photon_chi, 0.5*photon_chi );
+    int k = 0;
+    while( k < xi_power ) {
+        log10_particle_chi -= std::pow( 0.1, k );
+        double numerator = integrateRitusDerivative( photon_chi, std::pow( 10., log10_particle_chi ) );
+        double xi = ( numerator == 0. || denominator == 0. ) ? 0. : numerator/( 2.*denominator );
+        if( xi < xi_threshold ) {
+            log10_particle_chi += std::pow( 0.1, k );
+            k++;
+        }
+    }
+    return log10_particle_chi;
+}
+
+// -----------------------------------------------------------------------------
+//! Tables of the multiphoton Breit-Wheeler pair creation
+// -----------------------------------------------------------------------------
+void QEDTablesGenerator::computeBreitWheelerTables( int size_photon_chi, int size_particle_chi,
+        double min_photon_chi, double max_photon_chi,
+        double xi_power, double xi_threshold, MPI_Comm comm,
+        std::vector<double> &T, std::vector<double> &min_particle_chi,
+        std::vector<double> &xi )
+{
+    int first, length;
+    std::vector<int> firsts, lengths;
+    distribute( size_photon_chi, comm, first, length, firsts, lengths );
+
+    double log10_min_photon_chi = std::log10( min_photon_chi );
+    double delta_photon_chi = ( std::log10( max_photon_chi ) - log10_min_photon_chi )
+                              / ( size_photon_chi - 1 );
+
+    std::vector<double> local_T( length ), local_min( length );
+    std::vector<double> local_xi( length*size_particle_chi );
+
+    #pragma omp parallel for schedule(dynamic)
+    for( int i=0; i<length; i++ ) {
+        double photon_chi = std::pow( 10., ( first+i )*delta_photon_chi + log10_min_photon_chi );
+
+        local_T[i] = 2.*integrateRitusDerivative( photon_chi, 0.5*photon_chi );
+        local_min[i] = computeMinParticleChi( photon_chi, xi_power, xi_threshold );
+
+        // Cumulative distribution, integrated interval by interval
+        double *row = &local_xi[i*size_particle_chi];
+        double delta_particle_chi = ( std::log10( 0.5*photon_chi ) - local_min[i] )/( size_particle_chi - 1 );
+        double previous = std::pow( 10., local_min[i] );
+        row[0] = integrateRitusDerivative( photon_chi, previous );
+        for( int j=1; j<size_particle_chi; j++ ) {
+            double particle_chi = std::pow( 10., local_min[i] + j*delta_particle_chi );
+            row[j] = row[j-1] + integrateRitusDerivative( photon_chi, previous, particle_chi );
+            previous = particle_chi;
+        }
+        for( int j=0; j<size_particle_chi; j++ ) {
+            row[j] = local_T[i] > 0. ? row[j]/local_T[i] : 0.;
+        }
+    }
+
+    T.resize( size_photon_chi );
+    min_particle_chi.resize( size_photon_chi );
+    xi.resize( size_photon_chi*size_particle_chi );
+    MPI_Allgatherv( local_T.data(), length, MPI_DOUBLE,
+                    T.data(), lengths.data(), firsts.data(), MPI_DOUBLE, comm );
+    MPI_Allgatherv( local_min.data(), length, MPI_DOUBLE,
+                    min_particle_chi.data(), lengths.data(), firsts.data(), MPI_DOUBLE, comm );
+    for( unsigned int r=0; r<firsts.size(); r++ ) {
+        firsts[r] *= size_particle_chi;
+        lengths[r] *= size_particle_chi;
+    }
+    MPI_Allgatherv( local_xi.data(), length*size_particle_chi, MPI_DOUBLE,
+                    xi.data(), lengths.data(), firsts.data(), MPI_DOUBLE, comm );
+}
@@ -0,0 +1,211 @@
+// ----------------------------------------------------------------------------
+//! \file QEDTablesGenerator.h
+//
+//! \brief Generation of the tables of the nonlinear inverse Compton scattering
+//! and of the multiphoton Breit-Wheeler pair creation
+//
+//! \details This library is used both by Smilei at initialization
+//! (RadiationTables and MultiphotonBreitWheelerTables) and by the tool
+//! smilei_tables. It only depends on MPI.
+//! The rows of the tables are distributed over the MPI ranks, and over the
+//! OpenMP threads inside each rank.
+//! The modified Bessel functions and their integrals are computed from their
+//! integral representations with the trapezoidal rule, which converges
+//! exponentially for these integrands. The integrals over the quantum
+//! parameters use a globally adaptive Gauss-Kronrod quadrature, and the cumulative
+//! distributions are computed interval by interval.
+// ----------------------------------------------------------------------------
+
+#ifndef QEDTABLESGENERATOR_H
+#define QEDTABLESGENERATOR_H
+
+#include <vector>
+#include <string>
+#include <cmath>
+#include <algorithm>
+#include <mpi.h>
+
+class QEDTablesGenerator
+{
+public:
+
+    // ---------------------------------------------------------------------
+    // NUMERICAL TOOLS
+    // ---------------------------------------------------------------------
+
+    //! Modified Bessel function of the second kind K_nu(x)
+    static double besselK( double nu, double x );
+
+    //! Integral of f between a and b, with a relative precision eps,
+    //! using a globally adaptive Gauss-Kronrod (7-15) quadrature
+    template<typename F>
+    static double integrate( F f, double a, double b, double eps );
+
+    //! Path of the cache file `<cache_path>/<name>_<key>.h5` of a set of tables,
+    //! where key is a hash of the string describing their parameters
+    static std::string cacheFile( std::string cache_path, std::string name,
+                                  std::string parameters );
+
+    // ---------------------------------------------------------------------
+    // NONLINEAR INVERSE COMPTON SCATTERING
+    // ---------------------------------------------------------------------
+
+    //! Synchrotron emissivity from Ritus
+    //! \param particle_chi particle quantum parameter
+    //! \param photon_chi photon quantum parameter
+    static double synchrotronEmissivity( double particle_chi, double photon_chi );
+
+    //! Integration of the synchrotron emissivity S/chi
+    //! between min_photon_chi and max_photon_chi
+    static double integrateSynchrotronEmissivity( double particle_chi,
+            double min_photon_chi, double max_photon_chi );
+
+    //! Function h(particle_chi) of Niel et al.
+    static double computeHNiel( double particle_chi );
+
+    //! log10 of the minimum photon chi of the xi table:
+    //! smallest value, with xi_power digits, so that xi is above xi_threshold
+    static double computeMinPhotonChi( double particle_chi, double xi_power, double xi_threshold );
+
+    //! Tables of the nonlinear inverse Compton scattering, on all ranks of comm
+    //! \param integfochi integration of S/chi, size size_particle_chi
+    //! \param h function h of Niel et al., size size_particle_chi
+    //! \param min_photon_chi log10 of the minimum photon chi, size size_particle_chi
+    //! \param xi cumulative distributions, size size_particle_chi*size_photon_chi
+    static void computeRadiationTables( int size_particle_chi, int size_photon_chi,
+            double min_particle_chi, double max_particle_chi,
+            double xi_power, double xi_threshold, MPI_Comm comm,
+            std::vector<double> &integfochi, std::vector<double> &h,
+            std::vector<double> &min_photon_chi, std::vector<double> &xi );
+
+    // ---------------------------------------------------------------------
+    // MULTIPHOTON BREIT-WHEELER
+    // ---------------------------------------------------------------------
+
+    //! Value of dT/dchi(photon_chi, particle_chi) from the formula of Ritus
+    static double computeRitusDerivative( double photon_chi, double particle_chi );
+
+    //! Integration of dT/dchi between 0 and particle_chi
+    //! (= T/2 for particle_chi = photon_chi/2)
+    static double integrateRitusDerivative( double photon_chi, double particle_chi );
+
+    //! log10 of the minimum particle chi of the xi table:
+    //! smallest value, with xi_power digits, so that xi is above xi_threshold
+    static double computeMinParticleChi( double photon_chi, double xi_power, double xi_threshold );
+
+    //! Tables of the multiphoton Breit-Wheeler pair creation, on all ranks of comm
+    //! \param T function T, size size_photon_chi
+    //! \param min_particle_chi log10 of the minimum particle chi, size size_photon_chi
+    //! \param xi cumulative distributions, size size_photon_chi*size_particle_chi
+    static void computeBreitWheelerTables( int size_photon_chi, int size_particle_chi,
+            double min_photon_chi, double max_photon_chi,
+            double xi_power, double xi_threshold, MPI_Comm comm,
+            std::vector<double> &T, std::vector<double> &min_particle_chi,
+            std::vector<double> &xi );
+
+private:
+
+    //! K_{2/3}(z) and the integral of K_{1/3} from z to infinity,
+    //! which share the same integral representation
+    static void computeBesselK23AndIntegralK13( double z, double &k23, double &ik13 );
+
+    //! Integration of dT/dchi between min_particle_chi and max_particle_chi
+    static double integrateRitusDerivative( double photon_chi,
+            double min_particle_chi, double max_particle_chi );
+
+    //! Gauss-Kronrod (7-15) rule on [a, b], with the error estimate err
+    template<typename F>
+    static double kronrod( F f, double a, double b, double &err );
+
+    //! Rows [first, first+length) of a table of size rows of the current rank
+    static void distribute( int size, MPI_Comm comm, int &first, int &length,
+                            std::vector<int> &firsts, std::vector<int> &lengths );
+
+    //! Relative precision of the integrations
+    static constexpr double eps_ = 1e-10;
+};
+
+// -----------------------------------------------------------------------------
+// Templates
+// -----------------------------------------------------------------------------
+
+template<typename F>
+double QEDTablesGenerator::kronrod( F f, double a, double b, double &err )
+{
+    static const double xk[8] = {
+        0.991455371120812639206854697526329, 0.949107912342758524526189684047851,
+        0.864864423359769072789712788640926, 0.741531185599394439863864773280788,
+        0.586087235467691130294144845693013, 0.405845151377397166906606412076961,
+        0.207784955007898467600689403773245, 0.
+    };
+    static const double wk[8] = {
+        0.022935322010529224963732008058970, 0.063092092629978553290700663189204,
+        0.104790010322250183839876322541518, 0.140653259715525918745189590510238,
+        0.169004726639267902826583426598550, 0.190350578064785409913256402421014,
+        0.204432940075298892414161999234649, 0.209482141084727828012999174891714
+    };
+    static const double wg[4] = {
+        0.129484966168869693270611432679082, 0.279705391489276667901467771423780,
+        0.381830050505118944950369775488975, 0.417959183673469387755102040816327
+    };
+    double c = 0.5*( a+b ), r = 0.5*( b-a );
+    double fc = f( c );
+    double k = wk[7]*fc, g = wg[3]*fc;
+    for( int i=0; i<7; i++ ) {
+        double s = f( c - r*xk[i] ) + f( c + r*xk[i] );
+        k += wk[i]*s;
+        if( i%2 == 1 ) {
+            g += wg[i/2]*s;
+        }
+    }
+    err = std::abs( ( k-g )*r );
+    return k*r;
+}
+
+template<typename F>
+double QEDTablesGenerator::integrate( F f, double a, double b, double eps )
+{
+    // Global adaptive scheme: the interval with the largest error estimate
+    // is bisected until the total error is below eps times the integral
+    struct Segment {
+        double a, b, value, err;
+    };
+    auto smaller_error = []( const Segment &s1, const Segment &s2 ) {
+        return s1.err < s2.err;
+    };
+    // The integrals are computed in log variables: one initial panel per unit
+    // (at most 8), so that narrow intervals cost a single rule and the peaks
+    // of wide ones are not missed
+    const int npanels = std::max( 1, std::min( 8, int( std::abs( b-a ) ) ) );
+    const int max_segments = 2000;
+    std::vector<Segment> segments( npanels );
+    double h = ( b-a )/npanels;
+    double total = 0., total_err = 0.;
+    for( int i=0; i<npanels; i++ ) {
+        Segment &s = segments[i];
+        s.a = a+i*h;
+        s.b = a+( i+1 )*h;
+        s.value = kronrod( f, s.a, s.b, s.err );
+        total += s.value;
+        total_err += s.err;
+    }
+    std::make_heap( segments.begin(), segments.end(), smaller_error );
+    while( total_err > eps*std::abs( total ) && ( int ) segments.size() < max_segments ) {
+        std::pop_heap( segments.begin(), segments.end(), smaller_error );
+        Segment s = segments.back();
+        segments.pop_back();
+        double m = 0.5*( s.a+s.b );
+        Segment left = { s.a, m, 0., 0. }, right = { m, s.b, 0., 0. };
+        left.value  = kronrod( f, left.a, left.b, left.err );
+        right.value = kronrod( f, right.a, right.b, right.err );
+        total += left.value + right.value - s.value;
+        total_err += left.err + right.err - s.err;
+        segments.push_back( left );
+        std::push_heap( segments.begin(), segments.end(), smaller_error );
+        segments.push_back( right );
+        std::push_heap( segments.begin(), segments.end(), smaller_error );
+    }
+    return total;
+}
+
+#endif
@@ -5,49 +5,58 @@
 #include <inttypes.h>
 #include <cmath>
 
+//! Counter-based random number generator (Philox4x32-10, Salmon et al., SC11).
+//! Each number is a function of (seed, stream, step, position): each patch has its own stream
+//! (its hindex) and the position restarts at each timestep, so that the numbers drawn by a patch
+//! do not depend on the number of threads or MPI processes, nor on the history of the patch.
 class Random
 {
 public:
-    Random( unsigned int seed ) {
-        // Initialize the state of the random number generator
-        xorshift32_state = seed;
-        // Ensure that the random seed is different for each patch
-        xorshift32_state += std::rand();
-        // zero is not acceptable for xorshift
-        if( xorshift32_state==0 ) {
-            xorshift32_state = 1073741824;
-        }
+    Random( unsigned int seed, unsigned int stream = 0 ) {
+        key_[0] = seed;
+        reset( stream, 0 );
     };
-    
+
     ~Random() {};
-    
+
+    //! Start the numbers of a given stream at a given step
+    inline void reset( uint32_t stream, uint32_t step ) {
+        key_[1] = stream;
+        step_ = step;
+        block_ = 0;
+        index_ = 4;
+        has_spare_ = false;
+    }
+
     //! random integer
     inline uint32_t integer() {
-        return xorshift32();
+        if( index_ == 4 ) {
+            philox( block_++, step_, key_[0], key_[1], buffer_ );
+            index_ = 0;
+        }
+        return buffer_[index_++];
     }
-    //! Uniform rand from xorshift32 generator, between 0 (excluded) and 1 (included)
+    //! Uniform rand, between 0 (excluded) and 1 (included)
     inline double uniform() {
-        return xorshift32() * xorshift32_invmax;
+        return ( integer() + 1. ) * invmax;
     }
-    //! Uniform rand from xorshift32 generator, between 0 (excluded) and 1-10^-11
+    //! Uniform rand, between 0 (excluded) and 1-10^-11
     inline double uniform1() {
-        return xorshift32() * xorshift32_invmax1;
+        return ( integer() + 1. ) * invmax1;
     }
-    //! Uniform rand from xorshift32 generator, between -1. (excluded) and 1. (included)
+    //! Uniform rand, between -1. (excluded) and 1. (included)
     inline double uniform2() {
-        return xorshift32() * xorshift32_invmax2 - 1.;
+        return ( integer() + 1. ) * invmax2 - 1.;
     }
-    //! Uniform rand from xorshift32 generator, between 0. (excluded) and 2 pi (included)
+    //! Uniform rand, between 0. (excluded) and 2 pi (included)
     inline double uniform_2pi() {
-        return xorshift32() * xorshift32_invmax_2pi;
+        return ( integer() + 1. ) * invmax_2pi;
     }
-    //! Normal rand from xorshift32 generator (std deviation = 1.)
+    //! Normal rand (std deviation = 1.)
     inline double normal() {
-        static double spare;
-        static bool has_spare = false;
-        if( has_spare ) {
-            has_spare = false;
-            return spare;
+        if( has_spare_ ) {
+            has_spare_ = false;
+            return spare_;
         } else {
             double u, v, s;
             do {
@@ -56,35 +65,98 @@ public:
                 s = u*u + v*v;
             } while( s >= 1. );
             s = std::sqrt( -2. * std::log(s) / s );
-            spare = v * s;
-            has_spare = true;
+            spare_ = v * s;
+            has_spare_ = true;
             return u * s;
         }
     }
 
-    //! State of the random number generator
-    uint32_t xorshift32_state;
+    //! Fill u with n uniform rands between 0 (excluded) and 1 (included).
+    //! Blocks of 4 numbers are independent, so that this loop vectorizes.
+    inline void uniform( double *u, unsigned int n ) {
+        unsigned int i = 0;
+        while( index_ < 4 && i < n ) {
+            u[i++] = uniform();
+        }
+        unsigned int nblock = ( n - i ) / 4;
+        uint64_t block0 = block_;
+        uint32_t step = step_, k0 = key_[0], k1 = key_[1];
+        double *v = &u[i];
+        #pragma omp simd
+        for( unsigned int b=0; b<nblock; b++ ) {
+            uint32_t x[4];
+            philox( block0 + b, step, k0, k1, x );
+            for( unsigned int j=0; j<4; j++ ) {
+                v[4*b+j] = ( x[j] + 1. ) * invmax;
+            }
+        }
+        block_ += nblock;
+        for( i += 4*nblock; i<n; i++ ) {
+            u[i] = uniform();
+        }
+    }
+    //! Fill g with n normal rands (std deviation = 1.), using the Box-Muller transform
+    inline void normal( double *g, unsigned int n ) {
+        uniform( g, n );
+        unsigned int npair = n / 2;
+        #pragma omp simd
+        for( unsigned int i=0; i<npair; i++ ) {
+            double r = std::sqrt( -2. * std::log( g[2*i] ) );
+            double a = 2.*M_PI * g[2*i+1];
+            g[2*i  ] = r * std::cos( a );
+            g[2*i+1] = r * std::sin( a );
+        }
+        if( n % 2 ) {
+            g[n-1] = normal();
+        }
+    }
 
 private:
-    
-    //! Random number generator
-    inline uint32_t xorshift32()
+
+    //! Philox4x32-10: 4 random integers from the block number, the step and the key
+    #pragma omp declare simd
+    static inline void philox( uint64_t block, uint32_t step, uint32_t k0, uint32_t k1, uint32_t *x )
     {
-        /* Algorithm "xor" from p. 4 of Marsaglia, "Xorshift RNGs" */
-        xorshift32_state ^= xorshift32_state << 13;
-        xorshift32_state ^= xorshift32_state >> 17;
-        xorshift32_state ^= xorshift32_state << 5;
-        return xorshift32_state;
+        uint32_t c0 = ( uint32_t ) block, c1 = ( uint32_t )( block >> 32 ), c2 = step, c3 = 0;
+        for( unsigned int r=0; r<10; r++ ) {
+            uint64_t p0 = ( uint64_t ) 0xD2511F53 * c0;
+            uint64_t p1 = ( uint64_t ) 0xCD9E8D57 * c2;
+            uint32_t n0 = ( uint32_t )( p1 >> 32 ) ^ c1 ^ k0;
+            uint32_t n2 = ( uint32_t )( p0 >> 32 ) ^ c3 ^ k1;
+            c1 = ( uint32_t ) p1;
+            c3 = ( uint32_t ) p0;
+            c0 = n0;
+            c2 = n2;
+            k0 += 0x9E3779B9;
+            k1 += 0xBB67AE85;
+        }
+        x[0] = c0;
+        x[1] = c1;
+        x[2] = c2;
+        x[3] = c3;
     }
-    //! Inverse of the maximum value of the random number generator
-    static constexpr double xorshift32_invmax = 1./4294967296.;
-    //! Almost inverse of the maximum value of the random number generator
-    static constexpr double xorshift32_invmax1 = (1.-1e-11)/4294967296.;
-    //! Twice inverse of the maximum value of the random number generator
-    static constexpr double xorshift32_invmax2 = 2./4294967296.;
-     //! two pi * inverse of the maximum value of the random number generator
-    static constexpr double xorshift32_invmax_2pi = 2.*M_PI/4294967296.;
-    
+
+    //! Key of the generator: seed and stream
+    uint32_t key_[2];
+    //! Current step, and next block of 4 numbers in this step
+    uint32_t step_;
+    uint64_t block_;
+    //! Last block of numbers, and position of the next number to be used in this block
+    uint32_t buffer_[4];
+    unsigned int index_;
+    //! Second number of the last pair of normal rands
+    double spare_;
+    bool has_spare_;
+
+    //! Inverse of the maximum value of the random integers
+    static constexpr double invmax = 1./4294967296.;
+    //! Almost inverse of the maximum value of the random integers
+    static constexpr double invmax1 = (1.-1e-11)/4294967296.;
+    //! Twice inverse of the maximum value of the random integers
+    static constexpr double invmax2 = 2./4294967296.;
+     //! two pi * inverse of the maximum value of the random integers
+    static constexpr double invmax_2pi = 2.*M_PI/4294967296.;
+
 };
 
 
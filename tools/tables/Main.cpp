@@ -81,9 +81,6 @@ int main( int argc, char *argv[] )
         MultiphotonBreitWheeler::createTables(argc, arguments);
     }
 
-    // std::cout << std::setprecision(10) << Tools::asymptoticBesselK(2.0/3.0, 2.) << std::endl;
-    // std::cout << std::cyl_bessel_k( 2.0/3.0, 2.) << std::endl;
-
     if (rank==0) {
         std::cout << "\n All tables generated." << std::endl;
     }
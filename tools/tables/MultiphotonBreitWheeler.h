@@ -8,6 +8,8 @@
 //! The implementation is adapted from the following results:
 //! - Niel et al.
 //! - M. Lobet (http://www.theses.fr/2015BORD0361)
+//! The tables are computed by QEDTablesGenerator (src/Tools),
+//! which is also used by Smilei to generate the tables at initialization.
 // ----------------------------------------------------------------------------
 
 #ifndef MULTIPHOTON_BREIT_WHEELER_H
@@ -19,9 +21,12 @@
 #include <string>
 #include <cmath>
 #include <random>
+#include <iomanip>
+#include <limits>
 #include "Tools.h"
 #include <mpi.h>
 #include "H5.h"
+#include "QEDTablesGenerator.h"
 
 class MultiphotonBreitWheeler
 {
@@ -31,29 +36,6 @@ class MultiphotonBreitWheeler
     //! Creation of the tables
     static void createTables(int argc, std::string * arguments);
         
-    // -----------------------------------------------------------------------------
-    //! Computation of the value of the integration of  dT(photon_chi)/dhicpa
-    //! using the formula of Ritus.
-    //! \param photon_chi photon quantum parameter
-    //! \param particle_chi particle quantum parameter for integration (=0.5*photon_chi for full integration)
-    //! \param nb_iterations number of iteration for the Gauss-Legendre integration
-    //! \param eps epsilon for the Bessel evaluation
-    // -----------------------------------------------------------------------------
-    static double computeIntegrationRitusDerivative( double photon_chi,
-            double particle_chi,
-            int nb_iterations,
-            double eps );
-        
-    // -----------------------------------------------------------------------------
-    //! Computation of the value dT/dchipa(photon_chi) using the formula of Ritus
-    //! \param photon_chi photon quantum parameter
-    //! \param particle_chi particle quantum parameter
-    //! \param nb_iterations number of iteration for the Gauss-Legendre integration
-    //! \param eps epsilon for the Bessel evaluation
-    // -----------------------------------------------------------------------------
-    static double computeRitusDerivative( double photon_chi,
-            double particle_chi, int nb_iterations, double eps );
-    
     // -----------------------------------------------------------------------------
     //! Computation of the value T(photon_chi) using the approximated
     //! formula of Erber